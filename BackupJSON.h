@@ -0,0 +1,148 @@
+#pragma once
+
+/**
+ * PersonalNotes - JSON text helpers for the backup export/import
+ *
+ * The export is written by hand (one note object per array entry, fixed key
+ * order) and read back with a field scan rather than a full JSON parser. These
+ * helpers are the pieces both sides share.
+ *
+ * Depends only on the standard library, so it can be built and exercised
+ * outside the game.
+ */
+
+#include <cctype>
+#include <cstddef>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+namespace BackupJSON {
+    /**
+     * @brief Escape string for JSON format.
+     * @param input Raw string
+     * @return JSON-escaped string
+     */
+    inline std::string EscapeJSON(std::string_view input) {
+        std::ostringstream oss;
+        for (char c : input) {
+            switch (c) {
+            case '"':  oss << "\\\""; break;
+            case '\\': oss << "\\\\"; break;
+            case '\b': oss << "\\b"; break;
+            case '\f': oss << "\\f"; break;
+            case '\n': oss << "\\n"; break;
+            case '\r': oss << "\\r"; break;
+            case '\t': oss << "\\t"; break;
+            default:
+                if (c < 32) {
+                    oss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c);
+                } else {
+                    oss << c;
+                }
+            }
+        }
+        return oss.str();
+    }
+
+    /**
+     * @brief Unescape JSON string.
+     * @param input JSON-escaped string
+     * @return Unescaped string
+     */
+    inline std::string UnescapeJSON(const std::string& input) {
+        std::string result;
+        result.reserve(input.size());
+        for (size_t i = 0; i < input.size(); ++i) {
+            if (input[i] == '\\' && i + 1 < input.size()) {
+                switch (input[i + 1]) {
+                case '"':  result += '"'; i++; break;
+                case '\\': result += '\\'; i++; break;
+                case 'b':  result += '\b'; i++; break;
+                case 'f':  result += '\f'; i++; break;
+                case 'n':  result += '\n'; i++; break;
+                case 'r':  result += '\r'; i++; break;
+                case 't':  result += '\t'; i++; break;
+                default: result += input[i]; break;
+                }
+            } else {
+                result += input[i];
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Simple JSON value extractor (finds "key": value pattern).
+     * @param json JSON string
+     * @param key Key to search for
+     * @return Value string (without quotes for strings)
+     */
+    inline std::string ExtractJSONValue(const std::string& json, const std::string& key) {
+        std::string pattern = "\"" + key + "\":";
+        size_t pos = json.find(pattern);
+        if (pos == std::string::npos) {
+            return "";
+        }
+
+        pos += pattern.size();
+        // Skip whitespace
+        while (pos < json.size() && std::isspace(static_cast<unsigned char>(json[pos]))) {
+            ++pos;
+        }
+
+        if (pos >= json.size()) {
+            return "";
+        }
+
+        // String value (quoted)
+        if (json[pos] == '"') {
+            ++pos;
+            size_t end = pos;
+            while (end < json.size() && json[end] != '"') {
+                if (json[end] == '\\') {
+                    ++end;  // Skip escaped character
+                }
+                ++end;
+            }
+            return json.substr(pos, end - pos);
+        }
+
+        // Number value (unquoted)
+        size_t end = pos;
+        while (end < json.size() && (std::isdigit(static_cast<unsigned char>(json[end])) || json[end] == '-' || json[end] == '.')) {
+            ++end;
+        }
+        return json.substr(pos, end - pos);
+    }
+
+    /**
+     * @brief Find the '}' that closes the object opening at objStart.
+     *
+     * Braces inside string values (note text, quest names) don't count, and
+     * escaped quotes don't end a string.
+     * @return Position of the closing brace, or npos if the object is not closed
+     */
+    inline size_t FindObjectEnd(std::string_view json, size_t objStart) {
+        int depth = 0;
+        bool inString = false;
+        for (size_t i = objStart; i < json.size(); ++i) {
+            char c = json[i];
+            if (inString) {
+                if (c == '\\') {
+                    ++i;  // Skip escaped character
+                } else if (c == '"') {
+                    inString = false;
+                }
+            } else if (c == '"') {
+                inString = true;
+            } else if (c == '{') {
+                ++depth;
+            } else if (c == '}' && --depth == 0) {
+                return i;
+            }
+        }
+        return std::string_view::npos;
+    }
+}
@@ -0,0 +1,264 @@
+#pragma once
+
+/**
+ * PersonalNotes - Crash-safe file replacement
+ *
+ * Writes go to "<path>.tmp". Commit() flushes the user-space buffer, syncs the
+ * file to disk once and renames it over <path>, so readers only ever see the old
+ * file or the complete new one. A DurableFile destroyed without Commit() removes
+ * its temp file and leaves <path> untouched.
+ *
+ * Depends only on the standard library and the OS file API (Win32 or POSIX), so
+ * it can be built and exercised outside the game.
+ */
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/**
+ * @class DurableFile
+ * @brief Buffered writer that atomically replaces a file on Commit().
+ */
+class DurableFile {
+public:
+    static constexpr size_t kBufferSize = 64 * 1024;
+
+    DurableFile() = default;
+    DurableFile(const DurableFile&) = delete;
+    DurableFile& operator=(const DurableFile&) = delete;
+
+    ~DurableFile() {
+        Abort();
+    }
+
+    /**
+     * @brief Create (or truncate) the temp file for path.
+     * @param path UTF-8 path of the file to replace on Commit()
+     */
+    bool Open(std::string_view path) {
+        Abort();
+        path_ = path;
+        tempPath_ = path_ + ".tmp";
+        error_.clear();
+        buffer_.reserve(kBufferSize);
+
+        if (!OpenTemp()) {
+            SetError("open");
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Append data. Small writes are buffered; the OS sees kBufferSize blocks.
+     */
+    bool Write(std::string_view data) {
+        if (!IsOpen()) {
+            return false;
+        }
+        if (buffer_.size() + data.size() > kBufferSize) {
+            if (!FlushBuffer()) {
+                return false;
+            }
+            if (data.size() >= kBufferSize) {
+                return WriteRaw(data.data(), data.size());
+            }
+        }
+        buffer_.insert(buffer_.end(), data.begin(), data.end());
+        return true;
+    }
+
+    /**
+     * @brief Flush, sync once and rename over the target path.
+     * @return false if any step failed; the target is then unchanged
+     */
+    bool Commit() {
+        if (!IsOpen()) {
+            return false;
+        }
+        if (!FlushBuffer()) {
+            Abort();
+            return false;
+        }
+        if (!SyncAndClose()) {
+            SetError("sync");
+            RemoveTemp();
+            return false;
+        }
+        if (!ReplaceTarget()) {
+            SetError("rename");
+            RemoveTemp();
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Discard everything written since Open(). Safe to call repeatedly.
+     */
+    void Abort() {
+        if (IsOpen()) {
+            CloseFile();
+            RemoveTemp();
+        }
+        buffer_.clear();
+    }
+
+    [[nodiscard]] bool IsOpen() const {
+#ifdef _WIN32
+        return handle_ != INVALID_HANDLE_VALUE;
+#else
+        return fd_ >= 0;
+#endif
+    }
+
+    /** @brief Description of the last failure ("" if none). */
+    [[nodiscard]] const std::string& LastError() const {
+        return error_;
+    }
+
+private:
+    bool FlushBuffer() {
+        if (buffer_.empty()) {
+            return true;
+        }
+        bool ok = WriteRaw(buffer_.data(), buffer_.size());
+        buffer_.clear();
+        return ok;
+    }
+
+    void SetError(const char* step) {
+        error_ = std::string(step) + " failed for " + tempPath_ + ": " + SystemError();
+    }
+
+#ifdef _WIN32
+    static std::wstring Widen(const std::string& utf8) {
+        int length = MultiByteToWideChar(CP_UTF8, 0, utf8.data(), static_cast<int>(utf8.size()), nullptr, 0);
+        std::wstring wide(static_cast<size_t>(length), L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, utf8.data(), static_cast<int>(utf8.size()), wide.data(), length);
+        return wide;
+    }
+
+    static std::string SystemError() {
+        return "error " + std::to_string(GetLastError());
+    }
+
+    bool OpenTemp() {
+        handle_ = CreateFileW(Widen(tempPath_).c_str(), GENERIC_WRITE, 0, nullptr,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        return IsOpen();
+    }
+
+    bool WriteRaw(const char* data, size_t size) {
+        while (size > 0) {
+            DWORD chunk = static_cast<DWORD>(size > 0x40000000 ? 0x40000000 : size);
+            DWORD written = 0;
+            if (!WriteFile(handle_, data, chunk, &written, nullptr)) {
+                SetError("write");
+                return false;
+            }
+            data += written;
+            size -= written;
+        }
+        return true;
+    }
+
+    bool SyncAndClose() {
+        bool ok = FlushFileBuffers(handle_) != 0;
+        ok = (::CloseHandle(handle_) != 0) && ok;
+        handle_ = INVALID_HANDLE_VALUE;
+        return ok;
+    }
+
+    void CloseFile() {
+        ::CloseHandle(handle_);
+        handle_ = INVALID_HANDLE_VALUE;
+    }
+
+    bool ReplaceTarget() {
+        return MoveFileExW(Widen(tempPath_).c_str(), Widen(path_).c_str(),
+                           MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+    }
+
+    void RemoveTemp() {
+        DeleteFileW(Widen(tempPath_).c_str());
+    }
+
+    HANDLE handle_ = INVALID_HANDLE_VALUE;
+#else
+    static std::string SystemError() {
+        return std::strerror(errno);
+    }
+
+    bool OpenTemp() {
+        fd_ = ::open(tempPath_.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        return IsOpen();
+    }
+
+    bool WriteRaw(const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t written = ::write(fd_, data, size);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                SetError("write");
+                return false;
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    bool SyncAndClose() {
+        bool ok = ::fsync(fd_) == 0;
+        ok = (::close(fd_) == 0) && ok;
+        fd_ = -1;
+        return ok;
+    }
+
+    void CloseFile() {
+        ::close(fd_);
+        fd_ = -1;
+    }
+
+    bool ReplaceTarget() {
+        if (std::rename(tempPath_.c_str(), path_.c_str()) != 0) {
+            return false;
+        }
+        // Persist the rename itself: sync the directory entry
+        size_t slash = path_.find_last_of('/');
+        std::string dir = slash == std::string::npos ? "." : path_.substr(0, slash == 0 ? 1 : slash);
+        int dirFd = ::open(dir.c_str(), O_RDONLY | O_CLOEXEC);
+        if (dirFd >= 0) {
+            ::fsync(dirFd);
+            ::close(dirFd);
+        }
+        return true;
+    }
+
+    void RemoveTemp() {
+        ::unlink(tempPath_.c_str());
+    }
+
+    int fd_ = -1;
+#endif
+
+    std::string path_;
+    std::string tempPath_;
+    std::string error_;
+    std::vector<char> buffer_;
+};
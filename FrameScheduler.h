@@ -0,0 +1,222 @@
+#pragma once
+
+/**
+ * PersonalNotes - Frame-budgeted cooperative scheduler
+ *
+ * Spreads maintenance work over frames: each IncrementalTask gets one Step() per
+ * Tick(), bounded by its own time budget. The clock is replaceable, so tests and
+ * replays can drive the scheduler with simulated frame times; logging goes
+ * through a report callback.
+ *
+ * Depends only on the standard library, so it can be built and exercised
+ * outside the game.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+/**
+ * Deadline handed to IncrementalTask::Step(). Uses the scheduler's clock so a
+ * simulated clock drives both the scheduler and the tasks.
+ */
+struct FrameDeadline {
+    std::chrono::steady_clock::time_point end;
+    std::chrono::steady_clock::time_point (*now)();
+
+    [[nodiscard]] bool Expired() const {
+        return now() >= end;
+    }
+};
+
+/**
+ * @class IncrementalTask
+ * @brief Resumable unit of maintenance work, written as an explicit state machine.
+ *
+ * The scheduler calls Step() once per frame until it returns true. Each call should
+ * process items until the deadline expires (checking between items), keep its
+ * position in member state, and return.
+ */
+class IncrementalTask {
+public:
+    virtual ~IncrementalTask() = default;
+
+    [[nodiscard]] virtual const char* GetName() const = 0;
+
+    /**
+     * @brief Per-frame time budget for this task.
+     */
+    [[nodiscard]] virtual std::chrono::microseconds GetBudget() const = 0;
+
+    /**
+     * @brief Do one frame's worth of work.
+     * @param deadline Point at which the task should stop and return
+     * @return true when the task has finished
+     */
+    virtual bool Step(const FrameDeadline& deadline) = 0;
+};
+
+/**
+ * @class FrameScheduler
+ * @brief Cooperative scheduler that time-slices incremental tasks across frames.
+ *
+ * Tick() is called once per frame (in the game, from FrameUpdateHook on the main
+ * thread). Every active task gets one Step() per frame bounded by its own budget.
+ * Steps that run past their budget are counted as overruns; the first one is
+ * reported immediately and a summary is reported when the task finishes.
+ *
+ * @thread_safety Add() is thread-safe; Tick(), SetClock() and SetReporter() must
+ * stay on the ticking thread.
+ */
+class FrameScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+    using NowFn = Clock::time_point (*)();
+
+    // Slack before a step counts as an overrun (timer resolution, last item finishing)
+    static constexpr auto kOverrunTolerance = std::chrono::microseconds(50);
+
+    /**
+     * Per-task counters, as of the report.
+     */
+    struct TaskStats {
+        std::uint32_t frames = 0;
+        std::uint32_t overruns = 0;
+        Clock::duration total{};
+        Clock::duration worstOverrun{};
+    };
+
+    enum class Report : std::uint8_t {
+        kFirstOverrun,  // stats.worstOverrun is this step's overrun
+        kFinished,
+        kFailed         // Step() threw; error holds the message and the task is dropped
+    };
+
+    using ReportFn = void (*)(Report report, const IncrementalTask& task, const TaskStats& stats,
+                              std::string_view error);
+
+    /**
+     * @brief Get the singleton instance (the game's per-frame scheduler).
+     * @return Pointer to singleton instance (never null)
+     */
+    static FrameScheduler* GetSingleton() {
+        static FrameScheduler instance;
+        return &instance;
+    }
+
+    FrameScheduler() = default;
+    FrameScheduler(const FrameScheduler&) = delete;
+    FrameScheduler& operator=(const FrameScheduler&) = delete;
+
+    /**
+     * @brief Queue a task; it starts on the next Tick().
+     * @param task Task to run (ownership transferred)
+     */
+    void Add(std::unique_ptr<IncrementalTask> task) {
+        std::lock_guard lock(incomingLock_);
+        incoming_.push_back(std::move(task));
+        hasIncoming_.store(true, std::memory_order_release);
+    }
+
+    /**
+     * @brief Replace the clock (for simulated frame clocks in tests and replays).
+     * @param now Function returning the current time
+     */
+    void SetClock(NowFn now) {
+        now_ = now;
+    }
+
+    /**
+     * @brief Receive overrun, finish and failure reports (nullptr = none).
+     */
+    void SetReporter(ReportFn reporter) {
+        reporter_ = reporter;
+    }
+
+    /**
+     * @brief Tasks started and not yet finished (ticking thread).
+     */
+    [[nodiscard]] size_t ActiveCount() const {
+        return active_.size();
+    }
+
+    /**
+     * @brief Run one frame of scheduled work.
+     */
+    void Tick() {
+        if (hasIncoming_.load(std::memory_order_acquire)) {
+            std::lock_guard lock(incomingLock_);
+            for (auto& task : incoming_) {
+                active_.emplace_back().task = std::move(task);
+            }
+            incoming_.clear();
+            hasIncoming_.store(false, std::memory_order_release);
+        }
+
+        if (active_.empty()) {
+            return;
+        }
+
+        for (auto& entry : active_) {
+            auto budget = std::chrono::duration_cast<Clock::duration>(entry.task->GetBudget());
+            auto start = now_();
+
+            try {
+                entry.done = entry.task->Step({ start + budget, now_ });
+            } catch (const std::exception& e) {
+                Notify(Report::kFailed, *entry.task, entry.stats, e.what());
+                entry.failed = entry.done = true;
+            }
+
+            auto elapsed = now_() - start;
+            entry.stats.frames++;
+            entry.stats.total += elapsed;
+
+            if (elapsed > budget + kOverrunTolerance) {
+                auto over = elapsed - budget;
+                entry.stats.worstOverrun = std::max(entry.stats.worstOverrun, over);
+                if (entry.stats.overruns++ == 0) {
+                    TaskStats first = entry.stats;
+                    first.worstOverrun = over;
+                    Notify(Report::kFirstOverrun, *entry.task, first);
+                }
+            }
+        }
+
+        std::erase_if(active_, [this](const Entry& entry) {
+            if (entry.done && !entry.failed) {
+                Notify(Report::kFinished, *entry.task, entry.stats);
+            }
+            return entry.done;
+        });
+    }
+
+private:
+    struct Entry {
+        std::unique_ptr<IncrementalTask> task;
+        TaskStats stats;
+        bool done = false;
+        bool failed = false;
+    };
+
+    void Notify(Report report, const IncrementalTask& task, const TaskStats& stats,
+                std::string_view error = {}) const {
+        if (reporter_) {
+            reporter_(report, task, stats, error);
+        }
+    }
+
+    std::vector<Entry> active_;  // Ticking thread only
+    NowFn now_ = &Clock::now;
+    ReportFn reporter_ = nullptr;
+
+    std::mutex incomingLock_;
+    std::vector<std::unique_ptr<IncrementalTask>> incoming_;
+    std::atomic<bool> hasIncoming_{ false };
+};
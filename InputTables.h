@@ -0,0 +1,147 @@
+#pragma once
+
+/**
+ * PersonalNotes - Lookup tables for the input dispatch hook
+ *
+ * The hook sees every input batch the game dispatches, so the per-event work is
+ * kept to table lookups built ahead of time. The tables live here, apart from the
+ * engine types that fill them, so the replay benchmark can run them outside the game.
+ *
+ * Depends only on the standard library, so it can be built and exercised
+ * outside the game.
+ */
+
+#include <array>
+#include <bit>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+
+namespace InputTables {
+    /**
+     * Device indices, in RE::INPUT_DEVICE order (plugin.cpp checks they match).
+     */
+    enum class Device : std::uint32_t {
+        kKeyboard,
+        kMouse,
+        kGamepad
+    };
+
+    /**
+     * Actions a key binding can trigger.
+     */
+    enum class HotkeyAction : std::uint8_t {
+        kNone,
+        kNoteInput,           // Press: quest note in Journal, general note elsewhere
+        kQuickAccess,         // Press: notes list (outside Journal)
+        kJournalKeyNavigate,  // Release in Journal: keyboard selection may have changed
+        kJournalMouseSelect,  // Release in Journal: mouse selection may have changed
+        kJournalScroll,       // Mouse wheel in Journal: visible quests may have changed
+    };
+
+    namespace KeyModifiers {
+        constexpr std::uint8_t SHIFT = 1 << 0;
+        constexpr std::uint8_t CTRL = 1 << 1;
+        constexpr std::uint8_t ALT = 1 << 2;
+        constexpr std::size_t COMBINATIONS = 8;
+    }
+
+    /**
+     * @class HotkeyTable
+     * @brief Compiled (key, modifiers) → HotkeyAction table.
+     *
+     * Keys use the SKSE/Papyrus key code space shared by all devices: keyboard scan
+     * codes 0-255, mouse buttons 256-265, gamepad buttons 266-281. A lookup is one
+     * array index; bindings without modifiers also match while unrelated modifiers
+     * are held (e.g. Shift to run), unless a chord claims that combination.
+     */
+    struct HotkeyTable {
+        static constexpr std::uint32_t MOUSE_OFFSET = 256;
+        static constexpr std::uint32_t GAMEPAD_OFFSET = 266;
+        static constexpr std::uint32_t KEY_CODE_COUNT = 282;
+
+        std::array<HotkeyAction, KEY_CODE_COUNT * KeyModifiers::COMBINATIONS> actions{};
+        std::uint32_t settingsGeneration = 0;
+
+        /**
+         * @brief Map a device-specific button code to the shared key code space.
+         * @return Key code, or KEY_CODE_COUNT if the button has no key code
+         */
+        [[nodiscard]] static std::uint32_t ToKeyCode(Device device, std::uint32_t idCode) {
+            switch (device) {
+            case Device::kKeyboard:
+                return idCode < MOUSE_OFFSET ? idCode : KEY_CODE_COUNT;
+            case Device::kMouse:
+                return idCode < GAMEPAD_OFFSET - MOUSE_OFFSET ? MOUSE_OFFSET + idCode : KEY_CODE_COUNT;
+            case Device::kGamepad:
+                // XInput button masks; triggers use the pseudo-codes 0x9 (LT) and 0xA (RT)
+                if (idCode == 0x9) return GAMEPAD_OFFSET + 14;
+                if (idCode == 0xA) return GAMEPAD_OFFSET + 15;
+                if (std::has_single_bit(idCode)) {
+                    auto bit = static_cast<std::uint32_t>(std::countr_zero(idCode));
+                    if (bit < 10) return GAMEPAD_OFFSET + bit;                   // DPad, Start, Back, thumbs, shoulders
+                    if (bit >= 12 && bit < 16) return GAMEPAD_OFFSET + bit - 2;  // A, B, X, Y
+                }
+                return KEY_CODE_COUNT;
+            default:
+                return KEY_CODE_COUNT;
+            }
+        }
+
+        /**
+         * @brief Bind a key and modifier combination (out-of-range key codes are ignored).
+         * @return false if the combination was already bound to a different action (replaced)
+         */
+        bool Bind(std::uint32_t keyCode, std::uint8_t modifiers, HotkeyAction action) {
+            if (keyCode >= KEY_CODE_COUNT) {
+                return true;
+            }
+            auto& slot = actions[keyCode * KeyModifiers::COMBINATIONS + (modifiers & (KeyModifiers::COMBINATIONS - 1))];
+            bool replaced = slot != HotkeyAction::kNone && slot != action;
+            slot = action;
+            return !replaced;
+        }
+
+        [[nodiscard]] HotkeyAction Lookup(std::uint32_t keyCode, std::uint8_t modifiers) const {
+            if (keyCode >= KEY_CODE_COUNT) {
+                return HotkeyAction::kNone;
+            }
+            HotkeyAction action = actions[keyCode * KeyModifiers::COMBINATIONS + modifiers];
+            return action != HotkeyAction::kNone ? action : actions[keyCode * KeyModifiers::COMBINATIONS];
+        }
+    };
+
+    /**
+     * @class ControlBitmap
+     * @brief Per-device set of button codes, answered with one bit test.
+     *
+     * Codes are 16-bit like UserEventMapping::inputKey; anything out of range is
+     * reported as not set.
+     *
+     * @tparam DeviceCount Number of input devices (RE::INPUT_DEVICE::kTotal in the game)
+     */
+    template <std::size_t DeviceCount>
+    class ControlBitmap {
+    public:
+        static constexpr std::size_t kCodeCount = std::size_t{ 1 } << 16;
+
+        void Clear() {
+            for (auto& codes : codes_) {
+                codes.reset();
+            }
+        }
+
+        void Set(std::size_t device, std::uint32_t code) {
+            if (device < DeviceCount && code < kCodeCount) {
+                codes_[device].set(code);
+            }
+        }
+
+        [[nodiscard]] bool Test(std::size_t device, std::uint32_t code) const {
+            return device < DeviceCount && code < kCodeCount && codes_[device].test(code);
+        }
+
+    private:
+        std::array<std::bitset<kCodeCount>, DeviceCount> codes_;
+    };
+}
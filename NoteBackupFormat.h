@@ -0,0 +1,353 @@
+#pragma once
+
+/**
+ * PersonalNotes - Binary backup format (.pnb)
+ *
+ * Compact alternative to the JSON export, laid out so a reader can map the file
+ * and look a note up without parsing it:
+ *
+ *   Header      64 bytes, fixed
+ *   Index       noteCount x IndexEntry (40 bytes), ascending questID
+ *   String heap UTF-8 strings, each followed by a NUL (lengths exclude it)
+ *
+ * Offsets in IndexEntry and Header string fields are relative to the heap. All
+ * integers are little-endian. Readers bounds-check every entry they hand out, so
+ * a truncated or corrupt file yields errors, never reads outside the mapping.
+ *
+ * Depends only on the standard library and the OS file API (Win32 or POSIX), so
+ * it can be built and exercised outside the game.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace NoteBackupFormat {
+    static_assert(std::endian::native == std::endian::little, "NoteBackupFormat assumes a little-endian host");
+
+    inline constexpr char kMagic[4] = { 'P', 'N', 'B', 'K' };
+    inline constexpr std::uint32_t kVersion = 1;
+    inline constexpr const char* kExtension = ".pnb";
+
+    struct Header {
+        char magic[4];
+        std::uint32_t version;
+        std::uint32_t noteCount;
+        std::uint32_t flags;  // Reserved, 0
+        std::uint64_t indexOffset;
+        std::uint64_t heapOffset;
+        std::uint64_t heapSize;
+        std::uint32_t playerNameOffset;
+        std::uint32_t playerNameLength;
+        std::uint32_t exportDateOffset;
+        std::uint32_t exportDateLength;
+        std::uint64_t reserved;
+    };
+    static_assert(sizeof(Header) == 64);
+
+    struct IndexEntry {
+        std::uint32_t questID;
+        std::uint32_t textOffset;
+        std::uint32_t textLength;
+        std::uint32_t questNameOffset;
+        std::uint32_t questNameLength;
+        std::uint32_t reserved;
+        std::int64_t created;
+        std::int64_t modified;
+    };
+    static_assert(sizeof(IndexEntry) == 40);
+
+    /**
+     * One note, as written or as read. Views read from a MappedBackup point into
+     * the mapping and are valid until it is closed.
+     */
+    struct NoteRecord {
+        std::uint32_t questID = 0;
+        std::string_view text;
+        std::string_view questName;
+        std::int64_t created = 0;
+        std::int64_t modified = 0;
+    };
+
+    /**
+     * @brief Serialize a backup.
+     * @param records Notes in any order, at most one per questID
+     * @return File contents; empty if the strings exceed the format's 4 GiB heap
+     */
+    inline std::string Write(std::string_view playerName, std::string_view exportDate,
+                             std::span<const NoteRecord> records) {
+        std::vector<std::uint32_t> order(records.size());
+        std::iota(order.begin(), order.end(), 0u);
+        std::sort(order.begin(), order.end(), [&](std::uint32_t a, std::uint32_t b) {
+            return records[a].questID < records[b].questID;
+        });
+
+        std::uint64_t heapSize = playerName.size() + exportDate.size() + 2;
+        for (const NoteRecord& record : records) {
+            heapSize += record.text.size() + record.questName.size() + 2;
+        }
+        if (heapSize > UINT32_MAX) {
+            return {};
+        }
+
+        Header header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.noteCount = static_cast<std::uint32_t>(records.size());
+        header.indexOffset = sizeof(Header);
+        header.heapOffset = header.indexOffset + records.size() * sizeof(IndexEntry);
+        header.heapSize = heapSize;
+
+        std::string out(static_cast<size_t>(header.heapOffset + heapSize), '\0');
+        char* heap = out.data() + header.heapOffset;
+        std::uint32_t heapUsed = 0;
+        auto append = [&](std::string_view text, std::uint32_t& offset, std::uint32_t& length) {
+            offset = heapUsed;
+            length = static_cast<std::uint32_t>(text.size());
+            std::memcpy(heap + heapUsed, text.data(), text.size());
+            heapUsed += length + 1;  // NUL already in place
+        };
+
+        append(playerName, header.playerNameOffset, header.playerNameLength);
+        append(exportDate, header.exportDateOffset, header.exportDateLength);
+
+        char* index = out.data() + header.indexOffset;
+        for (size_t i = 0; i < order.size(); ++i) {
+            const NoteRecord& record = records[order[i]];
+            IndexEntry entry{};
+            entry.questID = record.questID;
+            entry.created = record.created;
+            entry.modified = record.modified;
+            append(record.text, entry.textOffset, entry.textLength);
+            append(record.questName, entry.questNameOffset, entry.questNameLength);
+            std::memcpy(index + i * sizeof(IndexEntry), &entry, sizeof(entry));
+        }
+
+        std::memcpy(out.data(), &header, sizeof(header));
+        return out;
+    }
+
+    /**
+     * @class MappedBackup
+     * @brief Read-only memory mapping of a .pnb file.
+     */
+    class MappedBackup {
+    public:
+        MappedBackup() = default;
+        MappedBackup(const MappedBackup&) = delete;
+        MappedBackup& operator=(const MappedBackup&) = delete;
+
+        ~MappedBackup() {
+            Close();
+        }
+
+        /**
+         * @brief Map a file and validate its header (entries are checked on access).
+         * @param path UTF-8 path
+         */
+        bool Open(const std::string& path) {
+            Close();
+            error_.clear();
+            if (!Map(path)) {
+                Close();  // Release whatever Map() opened before failing
+                error_ = "cannot map " + path;
+                return false;
+            }
+            return ValidateHeader();
+        }
+
+        void Close() {
+            Unmap();
+            data_ = nullptr;
+            size_ = 0;
+            header_ = Header{};
+        }
+
+        [[nodiscard]] std::uint32_t Size() const {
+            return header_.noteCount;
+        }
+
+        [[nodiscard]] std::string_view PlayerName() const {
+            return HeapString(header_.playerNameOffset, header_.playerNameLength);
+        }
+
+        [[nodiscard]] std::string_view ExportDate() const {
+            return HeapString(header_.exportDateOffset, header_.exportDateLength);
+        }
+
+        /**
+         * @brief Read the note at index i (ascending questID order).
+         * @return false if i is out of range or the entry points outside the heap
+         */
+        bool At(std::uint32_t i, NoteRecord& out) const {
+            if (i >= header_.noteCount) {
+                return false;
+            }
+            IndexEntry entry = Entry(i);
+            if (!InHeap(entry.textOffset, entry.textLength) || !InHeap(entry.questNameOffset, entry.questNameLength)) {
+                return false;
+            }
+            out.questID = entry.questID;
+            out.text = HeapString(entry.textOffset, entry.textLength);
+            out.questName = HeapString(entry.questNameOffset, entry.questNameLength);
+            out.created = entry.created;
+            out.modified = entry.modified;
+            return true;
+        }
+
+        /**
+         * @brief Binary-search the index for a quest's note.
+         */
+        bool Find(std::uint32_t questID, NoteRecord& out) const {
+            std::uint32_t low = 0;
+            std::uint32_t high = header_.noteCount;
+            while (low < high) {
+                std::uint32_t mid = low + (high - low) / 2;
+                std::uint32_t midID = Entry(mid).questID;
+                if (midID < questID) {
+                    low = mid + 1;
+                } else if (midID > questID) {
+                    high = mid;
+                } else {
+                    return At(mid, out);
+                }
+            }
+            return false;
+        }
+
+        [[nodiscard]] const std::string& LastError() const {
+            return error_;
+        }
+
+    private:
+        bool ValidateHeader() {
+            if (size_ < sizeof(Header)) {
+                error_ = "file too small";
+                Close();
+                return false;
+            }
+            std::memcpy(&header_, data_, sizeof(Header));
+            // Ordered so no comparison can overflow: each bound is established before it is subtracted from
+            if (std::memcmp(header_.magic, kMagic, sizeof(kMagic)) != 0) {
+                error_ = "not a PersonalNotes binary backup";
+            } else if (header_.version != kVersion) {
+                error_ = "unsupported version " + std::to_string(header_.version);
+            } else if (header_.indexOffset < sizeof(Header) || header_.indexOffset > size_ ||
+                       header_.heapOffset < header_.indexOffset || header_.heapOffset > size_ ||
+                       header_.noteCount > (header_.heapOffset - header_.indexOffset) / sizeof(IndexEntry) ||
+                       header_.heapSize > size_ - header_.heapOffset) {
+                error_ = "truncated or corrupt file";
+            } else if (!InHeap(header_.playerNameOffset, header_.playerNameLength) ||
+                       !InHeap(header_.exportDateOffset, header_.exportDateLength)) {
+                error_ = "corrupt header strings";
+            } else {
+                return true;
+            }
+            Close();
+            return false;
+        }
+
+        [[nodiscard]] IndexEntry Entry(std::uint32_t i) const {
+            IndexEntry entry;
+            std::memcpy(&entry, data_ + header_.indexOffset + std::uint64_t{ i } * sizeof(IndexEntry), sizeof(entry));
+            return entry;
+        }
+
+        [[nodiscard]] bool InHeap(std::uint32_t offset, std::uint32_t length) const {
+            return std::uint64_t{ offset } + length < header_.heapSize;  // Room for the NUL as well
+        }
+
+        [[nodiscard]] std::string_view HeapString(std::uint32_t offset, std::uint32_t length) const {
+            if (!data_) {
+                return {};
+            }
+            return std::string_view(reinterpret_cast<const char*>(data_) + header_.heapOffset + offset, length);
+        }
+
+#ifdef _WIN32
+        bool Map(const std::string& path) {
+            int length = MultiByteToWideChar(CP_UTF8, 0, path.data(), static_cast<int>(path.size()), nullptr, 0);
+            std::wstring wide(static_cast<size_t>(length), L'\0');
+            MultiByteToWideChar(CP_UTF8, 0, path.data(), static_cast<int>(path.size()), wide.data(), length);
+
+            file_ = CreateFileW(wide.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL, nullptr);
+            LARGE_INTEGER fileSize{};
+            if (file_ == INVALID_HANDLE_VALUE || !GetFileSizeEx(file_, &fileSize) || fileSize.QuadPart == 0) {
+                return false;
+            }
+            mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mapping_) {
+                return false;
+            }
+            data_ = static_cast<const std::uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+            size_ = static_cast<size_t>(fileSize.QuadPart);
+            return data_ != nullptr;
+        }
+
+        void Unmap() {
+            if (data_) {
+                UnmapViewOfFile(data_);
+            }
+            if (mapping_) {
+                CloseHandle(mapping_);
+                mapping_ = nullptr;
+            }
+            if (file_ != INVALID_HANDLE_VALUE) {
+                CloseHandle(file_);
+                file_ = INVALID_HANDLE_VALUE;
+            }
+        }
+
+        HANDLE file_ = INVALID_HANDLE_VALUE;
+        HANDLE mapping_ = nullptr;
+#else
+        bool Map(const std::string& path) {
+            int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+            if (fd < 0) {
+                return false;
+            }
+            struct stat info {};
+            if (::fstat(fd, &info) != 0 || info.st_size == 0) {
+                ::close(fd);
+                return false;
+            }
+            void* mapped = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);  // The mapping keeps the file alive
+            if (mapped == MAP_FAILED) {
+                return false;
+            }
+            data_ = static_cast<const std::uint8_t*>(mapped);
+            size_ = static_cast<size_t>(info.st_size);
+            return true;
+        }
+
+        void Unmap() {
+            if (data_) {
+                ::munmap(const_cast<std::uint8_t*>(data_), size_);
+            }
+        }
+#endif
+
+        const std::uint8_t* data_ = nullptr;
+        size_t size_ = 0;
+        Header header_{};
+        std::string error_;
+    };
+}
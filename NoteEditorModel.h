@@ -0,0 +1,486 @@
+#pragma once
+
+/**
+ * PersonalNotes - Text editing model for the native note editor
+ *
+ * Portable core of the editor menu: depends only on the standard library, so it
+ * can be built and exercised outside the game.
+ *
+ * TEXT:      UTF-8 in a gap buffer. Positions are byte offsets that always sit on a
+ *            code point boundary; cursor movement steps whole code points.
+ * SELECTION: anchor + cursor. Equal means no selection. Typing replaces the selection.
+ * UNDO:      each edit records what it removed and inserted. Consecutive typing (or
+ *            consecutive deletes) at the cursor coalesce into one undo step until the
+ *            cursor moves, the edit kind changes or a word boundary is typed.
+ */
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @class GapBuffer
+ * @brief Byte buffer with a movable gap: O(1) amortized insert/erase at the gap.
+ */
+class GapBuffer {
+public:
+    [[nodiscard]] size_t Size() const {
+        return data_.size() - GapSize();
+    }
+
+    [[nodiscard]] char At(size_t pos) const {
+        return pos < gapStart_ ? data_[pos] : data_[pos + GapSize()];
+    }
+
+    void Insert(size_t pos, std::string_view text) {
+        MoveGap(pos);
+        if (GapSize() < text.size()) {
+            Grow(text.size());
+        }
+        std::copy(text.begin(), text.end(), data_.begin() + static_cast<std::ptrdiff_t>(gapStart_));
+        gapStart_ += text.size();
+    }
+
+    void Erase(size_t pos, size_t count) {
+        MoveGap(pos);
+        gapEnd_ += std::min(count, data_.size() - gapEnd_);
+    }
+
+    [[nodiscard]] std::string Substr(size_t pos, size_t count) const {
+        std::string result;
+        size_t end = std::min(pos + count, Size());
+        result.reserve(end > pos ? end - pos : 0);
+        for (size_t i = pos; i < end; ++i) {
+            result.push_back(At(i));
+        }
+        return result;
+    }
+
+    [[nodiscard]] std::string ToString() const {
+        std::string result;
+        result.reserve(Size());
+        result.append(data_.data(), gapStart_);
+        result.append(data_.data() + gapEnd_, data_.size() - gapEnd_);
+        return result;
+    }
+
+    void Assign(std::string_view text) {
+        data_.assign(text.begin(), text.end());
+        data_.resize(text.size() + kMinGap);
+        gapStart_ = text.size();
+        gapEnd_ = data_.size();
+    }
+
+private:
+    static constexpr size_t kMinGap = 64;
+
+    [[nodiscard]] size_t GapSize() const {
+        return gapEnd_ - gapStart_;
+    }
+
+    void MoveGap(size_t pos) {
+        pos = std::min(pos, Size());
+        if (pos < gapStart_) {
+            size_t count = gapStart_ - pos;
+            std::copy_backward(data_.begin() + static_cast<std::ptrdiff_t>(pos),
+                               data_.begin() + static_cast<std::ptrdiff_t>(gapStart_),
+                               data_.begin() + static_cast<std::ptrdiff_t>(gapEnd_));
+            gapStart_ -= count;
+            gapEnd_ -= count;
+        } else if (pos > gapStart_) {
+            size_t count = pos - gapStart_;
+            std::copy(data_.begin() + static_cast<std::ptrdiff_t>(gapEnd_),
+                      data_.begin() + static_cast<std::ptrdiff_t>(gapEnd_ + count),
+                      data_.begin() + static_cast<std::ptrdiff_t>(gapStart_));
+            gapStart_ += count;
+            gapEnd_ += count;
+        }
+    }
+
+    void Grow(size_t needed) {
+        size_t tail = data_.size() - gapEnd_;
+        size_t newSize = std::max(data_.size() * 2, data_.size() + needed + kMinGap);
+        data_.resize(newSize);
+        std::copy_backward(data_.begin() + static_cast<std::ptrdiff_t>(gapEnd_),
+                           data_.begin() + static_cast<std::ptrdiff_t>(gapEnd_ + tail),
+                           data_.end());
+        gapEnd_ = newSize - tail;
+    }
+
+    std::vector<char> data_ = std::vector<char>(kMinGap);
+    size_t gapStart_ = 0;
+    size_t gapEnd_ = kMinGap;
+};
+
+/**
+ * @class NoteEditorModel
+ * @brief Editable note text with cursor, selection and undo/redo.
+ */
+class NoteEditorModel {
+public:
+    explicit NoteEditorModel(size_t maxLength = 4096)
+        : maxLength_(maxLength) {}
+
+    /**
+     * @brief Replace the whole text; cursor goes to the end and history is cleared.
+     */
+    void SetText(std::string_view text) {
+        text = text.substr(0, FloorBoundary(text, std::min(text.size(), maxLength_)));
+        buffer_.Assign(text);
+        cursor_ = anchor_ = buffer_.Size();
+        undo_.clear();
+        redo_.clear();
+        savedUndoDepth_ = 0;
+        coalesce_ = Coalesce::kNone;
+    }
+
+    [[nodiscard]] std::string GetText() const { return buffer_.ToString(); }
+    [[nodiscard]] size_t Size() const { return buffer_.Size(); }
+    [[nodiscard]] size_t GetCursor() const { return cursor_; }
+    [[nodiscard]] size_t GetAnchor() const { return anchor_; }
+    [[nodiscard]] bool HasSelection() const { return cursor_ != anchor_; }
+
+    /**
+     * @return [begin, end) byte range of the selection (empty if none)
+     */
+    [[nodiscard]] std::pair<size_t, size_t> GetSelection() const {
+        return { std::min(cursor_, anchor_), std::max(cursor_, anchor_) };
+    }
+
+    [[nodiscard]] std::string GetSelectedText() const {
+        auto [begin, end] = GetSelection();
+        return buffer_.Substr(begin, end - begin);
+    }
+
+    /**
+     * @brief True if the text differs from the last SetText()/MarkSaved() state.
+     */
+    [[nodiscard]] bool IsModified() const {
+        return undo_.size() != savedUndoDepth_;
+    }
+
+    void MarkSaved() {
+        savedUndoDepth_ = undo_.size();
+        coalesce_ = Coalesce::kNone;  // Next keystroke must start a new undo step past the save point
+    }
+
+    //-------------------------------------------------------------------------
+    // Editing
+    //-------------------------------------------------------------------------
+
+    /**
+     * @brief Type or paste text at the cursor, replacing the selection.
+     * @return false if nothing fit (text at maximum length)
+     */
+    bool Insert(std::string_view text) {
+        auto [begin, end] = GetSelection();
+        size_t room = maxLength_ - (buffer_.Size() - (end - begin));
+        text = text.substr(0, FloorBoundary(text, std::min(text.size(), room)));
+        if (text.empty() && begin == end) {
+            return false;
+        }
+
+        bool typing = begin == end && text.size() <= 4 && !IsWordBreak(text);
+        Apply(begin, end - begin, text, typing ? Coalesce::kTyping : Coalesce::kNone);
+        return true;
+    }
+
+    /**
+     * @brief Delete the selection, or the code point (or word) before the cursor.
+     */
+    void Backspace(bool word = false) {
+        if (HasSelection()) {
+            DeleteSelection();
+            return;
+        }
+        size_t begin = word ? PrevWord(cursor_) : PrevBoundary(cursor_);
+        if (begin < cursor_) {
+            Apply(begin, cursor_ - begin, {}, word ? Coalesce::kNone : Coalesce::kBackspace);
+        }
+    }
+
+    /**
+     * @brief Delete the selection, or the code point (or word) after the cursor.
+     */
+    void Delete(bool word = false) {
+        if (HasSelection()) {
+            DeleteSelection();
+            return;
+        }
+        size_t end = word ? NextWord(cursor_) : NextBoundary(cursor_);
+        if (end > cursor_) {
+            Apply(cursor_, end - cursor_, {}, word ? Coalesce::kNone : Coalesce::kDelete);
+        }
+    }
+
+    void DeleteSelection() {
+        auto [begin, end] = GetSelection();
+        if (begin != end) {
+            Apply(begin, end - begin, {}, Coalesce::kNone);
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    // Cursor movement (select = extend the selection instead of collapsing it)
+    //-------------------------------------------------------------------------
+
+    void MoveLeft(bool select, bool word = false) {
+        if (!select && HasSelection()) {
+            MoveTo(GetSelection().first, false);
+            return;
+        }
+        MoveTo(word ? PrevWord(cursor_) : PrevBoundary(cursor_), select);
+    }
+
+    void MoveRight(bool select, bool word = false) {
+        if (!select && HasSelection()) {
+            MoveTo(GetSelection().second, false);
+            return;
+        }
+        MoveTo(word ? NextWord(cursor_) : NextBoundary(cursor_), select);
+    }
+
+    void MoveLineStart(bool select) {
+        MoveTo(LineStart(cursor_), select);
+    }
+
+    void MoveLineEnd(bool select) {
+        MoveTo(LineEnd(cursor_), select);
+    }
+
+    /**
+     * @brief Move to the previous/next line, keeping the byte column where possible.
+     */
+    void MoveUp(bool select) {
+        size_t start = LineStart(cursor_);
+        if (start == 0) {
+            MoveTo(0, select);
+            return;
+        }
+        size_t prevStart = LineStart(start - 1);
+        MoveTo(ColumnInLine(prevStart, cursor_ - start), select);
+    }
+
+    void MoveDown(bool select) {
+        size_t end = LineEnd(cursor_);
+        if (end == buffer_.Size()) {
+            MoveTo(end, select);
+            return;
+        }
+        MoveTo(ColumnInLine(end + 1, cursor_ - LineStart(cursor_)), select);
+    }
+
+    void MoveDocumentStart(bool select) { MoveTo(0, select); }
+    void MoveDocumentEnd(bool select) { MoveTo(buffer_.Size(), select); }
+
+    void SelectAll() {
+        anchor_ = 0;
+        cursor_ = buffer_.Size();
+        coalesce_ = Coalesce::kNone;
+    }
+
+    //-------------------------------------------------------------------------
+    // History
+    //-------------------------------------------------------------------------
+
+    bool Undo() {
+        if (undo_.empty()) {
+            return false;
+        }
+        Edit edit = std::move(undo_.back());
+        undo_.pop_back();
+        buffer_.Erase(edit.pos, edit.inserted.size());
+        buffer_.Insert(edit.pos, edit.removed);
+        cursor_ = edit.cursorBefore;
+        anchor_ = edit.anchorBefore;
+        redo_.push_back(std::move(edit));
+        coalesce_ = Coalesce::kNone;
+        return true;
+    }
+
+    bool Redo() {
+        if (redo_.empty()) {
+            return false;
+        }
+        Edit edit = std::move(redo_.back());
+        redo_.pop_back();
+        buffer_.Erase(edit.pos, edit.removed.size());
+        buffer_.Insert(edit.pos, edit.inserted);
+        cursor_ = anchor_ = edit.pos + edit.inserted.size();
+        undo_.push_back(std::move(edit));
+        coalesce_ = Coalesce::kNone;
+        return true;
+    }
+
+    [[nodiscard]] bool CanUndo() const { return !undo_.empty(); }
+    [[nodiscard]] bool CanRedo() const { return !redo_.empty(); }
+
+private:
+    enum class Coalesce : std::uint8_t { kNone, kTyping, kBackspace, kDelete };
+
+    struct Edit {
+        size_t pos;
+        std::string removed;
+        std::string inserted;
+        size_t cursorBefore;
+        size_t anchorBefore;
+    };
+
+    static constexpr size_t kMaxUndo = 256;
+
+    static bool IsContinuation(char c) {
+        return (static_cast<unsigned char>(c) & 0xC0) == 0x80;
+    }
+
+    /**
+     * Largest code point boundary <= limit within text.
+     */
+    static size_t FloorBoundary(std::string_view text, size_t limit) {
+        while (limit > 0 && limit < text.size() && IsContinuation(text[limit])) {
+            --limit;
+        }
+        return limit;
+    }
+
+    static bool IsWordBreak(std::string_view text) {
+        return text.size() == 1 && (text[0] == ' ' || text[0] == '\n' || text[0] == '\t');
+    }
+
+    [[nodiscard]] bool IsSpaceAt(size_t pos) const {
+        char c = buffer_.At(pos);
+        return c == ' ' || c == '\n' || c == '\t';
+    }
+
+    [[nodiscard]] size_t PrevBoundary(size_t pos) const {
+        if (pos == 0) {
+            return 0;
+        }
+        do {
+            --pos;
+        } while (pos > 0 && IsContinuation(buffer_.At(pos)));
+        return pos;
+    }
+
+    [[nodiscard]] size_t NextBoundary(size_t pos) const {
+        size_t size = buffer_.Size();
+        if (pos >= size) {
+            return size;
+        }
+        do {
+            ++pos;
+        } while (pos < size && IsContinuation(buffer_.At(pos)));
+        return pos;
+    }
+
+    [[nodiscard]] size_t PrevWord(size_t pos) const {
+        while (pos > 0 && IsSpaceAt(pos - 1)) {
+            --pos;
+        }
+        while (pos > 0 && !IsSpaceAt(pos - 1)) {
+            --pos;
+        }
+        return pos;
+    }
+
+    [[nodiscard]] size_t NextWord(size_t pos) const {
+        size_t size = buffer_.Size();
+        while (pos < size && !IsSpaceAt(pos)) {
+            ++pos;
+        }
+        while (pos < size && IsSpaceAt(pos)) {
+            ++pos;
+        }
+        return pos;
+    }
+
+    [[nodiscard]] size_t LineStart(size_t pos) const {
+        while (pos > 0 && buffer_.At(pos - 1) != '\n') {
+            --pos;
+        }
+        return pos;
+    }
+
+    [[nodiscard]] size_t LineEnd(size_t pos) const {
+        size_t size = buffer_.Size();
+        while (pos < size && buffer_.At(pos) != '\n') {
+            ++pos;
+        }
+        return pos;
+    }
+
+    /**
+     * Position `column` bytes into the line starting at lineStart, clamped to the line
+     * and moved back onto a code point boundary.
+     */
+    [[nodiscard]] size_t ColumnInLine(size_t lineStart, size_t column) const {
+        size_t pos = std::min(lineStart + column, LineEnd(lineStart));
+        while (pos > lineStart && pos < buffer_.Size() && IsContinuation(buffer_.At(pos))) {
+            --pos;
+        }
+        return pos;
+    }
+
+    void MoveTo(size_t pos, bool select) {
+        cursor_ = pos;
+        if (!select) {
+            anchor_ = pos;
+        }
+        coalesce_ = Coalesce::kNone;
+    }
+
+    /**
+     * Replace [pos, pos + count) with text, record undo, leave the cursor after the insert.
+     */
+    void Apply(size_t pos, size_t count, std::string_view text, Coalesce kind) {
+        std::string removed = buffer_.Substr(pos, count);
+        buffer_.Erase(pos, count);
+        buffer_.Insert(pos, text);
+
+        bool merged = false;
+        if (kind != Coalesce::kNone && kind == coalesce_ && !undo_.empty()) {
+            Edit& last = undo_.back();
+            if (kind == Coalesce::kTyping && last.pos + last.inserted.size() == pos) {
+                last.inserted.append(text);
+                merged = true;
+            } else if (kind == Coalesce::kBackspace && last.pos == pos + count && last.inserted.empty()) {
+                last.removed.insert(0, removed);
+                last.pos = pos;
+                merged = true;
+            } else if (kind == Coalesce::kDelete && last.pos == pos && last.inserted.empty()) {
+                last.removed.append(removed);
+                merged = true;
+            }
+        }
+
+        if (!merged) {
+            if (savedUndoDepth_ > undo_.size()) {
+                savedUndoDepth_ = SIZE_MAX;  // Saved state was undone past; it can't be reached again
+            }
+            undo_.push_back({ pos, std::move(removed), std::string(text), cursor_, anchor_ });
+            if (undo_.size() > kMaxUndo) {
+                undo_.erase(undo_.begin());
+                if (savedUndoDepth_ != SIZE_MAX) {
+                    savedUndoDepth_ = savedUndoDepth_ > 0 ? savedUndoDepth_ - 1 : SIZE_MAX;
+                }
+            }
+        }
+        redo_.clear();
+
+        cursor_ = anchor_ = pos + text.size();
+        coalesce_ = kind;
+    }
+
+    GapBuffer buffer_;
+    size_t cursor_ = 0;
+    size_t anchor_ = 0;
+    size_t maxLength_;
+
+    std::vector<Edit> undo_;
+    std::vector<Edit> redo_;
+    size_t savedUndoDepth_ = 0;  // undo_.size() at the last save; SIZE_MAX if unreachable
+    Coalesce coalesce_ = Coalesce::kNone;
+};
@@ -0,0 +1,117 @@
+#pragma once
+
+/**
+ * PersonalNotes - Plugin API for other SKSE plugins
+ *
+ * Versioned C ABI exposed through the SKSE messaging interface. Everything in the
+ * interface is a plain function pointer taking plain types, so consumers do not need
+ * to share a compiler, runtime or CommonLibSSE version with PersonalNotes.
+ *
+ * USAGE (from kPostLoad onwards):
+ *
+ *   PersonalNotesAPI::InterfaceRequest request{ PersonalNotesAPI::kInterfaceVersion1, nullptr };
+ *   SKSE::GetMessagingInterface()->Dispatch(
+ *       PersonalNotesAPI::kMessage_RequestInterface, &request, sizeof(request), PersonalNotesAPI::kPluginName);
+ *   auto api = static_cast<const PersonalNotesAPI::InterfaceV1*>(request.api);
+ *
+ * Dispatch is synchronous, so request.api is filled in (or left null if the
+ * plugin is missing or the version is unsupported) by the time Dispatch returns.
+ *
+ * LIFETIMES:
+ * - Views passed to a NoteVisitor are valid only for the duration of the call.
+ *   The store is read-locked meanwhile, so do not write notes from a visitor.
+ * - Views obtained from a Snapshot are valid until ReleaseSnapshot() on that snapshot.
+ * - Snapshots are immutable; acquiring one when nothing changed since the last
+ *   acquisition is a reference-count increment, not a copy.
+ *
+ * THREADING:
+ * - All functions are thread-safe.
+ * - Change callbacks run on the thread that wrote the note. Keep them cheap and do
+ *   not call WriteNotes from inside a callback.
+ */
+
+#include <cstdint>
+
+namespace PersonalNotesAPI {
+    inline constexpr const char* kPluginName = "PersonalNotes";
+
+    inline constexpr std::uint32_t kMessage_RequestInterface = 'PNAP';
+    inline constexpr std::uint32_t kInterfaceVersion1 = 1;
+
+    inline constexpr std::uint32_t kGeneralNoteID = 0xFFFFFFFF;  // FormID used for the general note
+
+    /**
+     * Borrowed, read-only view of a note.
+     * text is UTF-8 and NUL-terminated; length excludes the terminator.
+     */
+    struct NoteView {
+        std::uint32_t formID;
+        std::uint32_t length;
+        const char* text;
+        std::int64_t timestamp;  // Unix seconds of last write
+    };
+
+    /**
+     * One entry of a batched write. length == 0 deletes the note.
+     * text does not need to be NUL-terminated.
+     */
+    struct NoteWrite {
+        std::uint32_t formID;
+        std::uint32_t length;
+        const char* text;
+    };
+
+    enum class ChangeKind : std::uint32_t {
+        kSaved = 0,    // Note created or updated
+        kDeleted = 1,  // Note removed
+        kReset = 2     // Whole store replaced (game loaded, new game); formID is 0, re-read everything
+    };
+
+    struct ChangeEvent {
+        std::uint32_t formID;
+        ChangeKind kind;
+        std::uint64_t generation;  // Store generation after the change (monotonic)
+    };
+
+    struct Snapshot;  // Opaque
+
+    using SubscriptionHandle = std::uint32_t;  // 0 = invalid
+
+    using NoteVisitor = void (*)(const NoteView* view, void* user);
+    using ChangeCallback = void (*)(const ChangeEvent* event, void* user);
+
+    struct InterfaceV1 {
+        std::uint32_t version;  // kInterfaceVersion1
+        std::uint32_t size;     // sizeof(InterfaceV1)
+
+        // Lookup: calls visitor with a borrowed view if the note exists. Returns false if it doesn't.
+        bool (*VisitNote)(std::uint32_t formID, NoteVisitor visitor, void* user);
+        bool (*HasNote)(std::uint32_t formID);
+        std::uint32_t (*GetNoteCount)();
+        std::uint64_t (*GetGeneration)();
+
+        // Iteration: snapshot notes are sorted by ascending FormID.
+        Snapshot* (*AcquireSnapshot)();
+        void (*ReleaseSnapshot)(Snapshot* snapshot);
+        std::uint64_t (*GetSnapshotGeneration)(const Snapshot* snapshot);
+        std::uint32_t (*GetSnapshotSize)(const Snapshot* snapshot);
+        bool (*GetSnapshotNote)(const Snapshot* snapshot, std::uint32_t index, NoteView* out);
+        bool (*FindSnapshotNote)(const Snapshot* snapshot, std::uint32_t formID, NoteView* out);
+
+        // Change notifications
+        SubscriptionHandle (*Subscribe)(ChangeCallback callback, void* user);
+        void (*Unsubscribe)(SubscriptionHandle handle);
+
+        // Batched writes: applied under a single lock. Returns the number of entries applied.
+        std::uint32_t (*WriteNotes)(const NoteWrite* writes, std::uint32_t count);
+    };
+
+    /**
+     * Message payload for kMessage_RequestInterface.
+     * Set version before dispatching; PersonalNotes fills in api.
+     */
+    struct InterfaceRequest {
+        std::uint32_t version;
+        const void* api;  // Points to InterfaceV1 for kInterfaceVersion1
+    };
+}
@@ -0,0 +1,190 @@
+/**
+ * PersonalNotes - JSON vs binary (.pnb) backup benchmark
+ *
+ * Usage: BackupFormatBench [noteCount=10000]
+ *
+ * Generates noteCount random notes of 50-450 characters and times:
+ *   JSON   write in the exporter's layout, parse with the importer's field scan
+ *   .pnb   NoteBackupFormat::Write, MappedBackup::Open, iterate all, Find each
+ *
+ * plugin.cpp needs the game headers, so the JSON side reproduces its export
+ * layout and its import loop (BackupJSON.h helpers per note object) here. Keep
+ * them in step when either changes.
+ */
+
+#include "BackupJSON.h"
+#include "NoteBackupFormat.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double MillisecondsSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    //-------------------------------------------------------------------------
+    // JSON baseline (mirrors BackupManager in plugin.cpp)
+    //-------------------------------------------------------------------------
+
+    using namespace BackupJSON;
+
+    struct ParsedNote {
+        std::uint32_t questID;
+        std::string text;
+        std::int64_t created;
+        std::int64_t modified;
+    };
+
+    std::string WriteJSON(const std::vector<NoteBackupFormat::NoteRecord>& records) {
+        std::ostringstream json;
+        json << "{\n";
+        json << "  \"exportDate\": \"2026-01-01T00:00:00\",\n";
+        json << "  \"version\": \"1.0\",\n";
+        json << "  \"playerName\": \"Dragonborn\",\n";
+        json << "  \"kind\": \"full\",\n";
+        json << "  \"noteCount\": " << records.size() << ",\n";
+        json << "  \"notes\": [\n";
+        for (size_t i = 0; i < records.size(); ++i) {
+            const auto& record = records[i];
+            if (i > 0) json << ",\n";
+            json << "    {\n";
+            json << "      \"questID\": " << record.questID << ",\n";
+            json << "      \"questName\": \"" << EscapeJSON(record.questName) << "\",\n";
+            json << "      \"text\": \"" << EscapeJSON(record.text) << "\",\n";
+            json << "      \"created\": " << record.created << ",\n";
+            json << "      \"modified\": " << record.modified << "\n";
+            json << "    }";
+        }
+        json << "\n  ]\n";
+        json << "}\n";
+        return json.str();
+    }
+
+    std::vector<ParsedNote> ParseJSON(const std::string& json) {
+        std::vector<ParsedNote> notes;
+        size_t pos = json.find('[', json.find("\"notes\":")) + 1;
+        while (pos < json.size()) {
+            size_t objStart = json.find('{', pos);
+            if (objStart == std::string::npos) {
+                break;
+            }
+            size_t objEnd = FindObjectEnd(json, objStart);
+            if (objEnd == std::string::npos) {
+                break;
+            }
+            std::string noteObj = json.substr(objStart, objEnd - objStart + 1);
+            std::string questIDStr = ExtractJSONValue(noteObj, "questID");
+            std::string textEscaped = ExtractJSONValue(noteObj, "text");
+            if (!questIDStr.empty() && !textEscaped.empty()) {
+                notes.push_back({ static_cast<std::uint32_t>(std::stoul(questIDStr)), UnescapeJSON(textEscaped),
+                                  std::stoll(ExtractJSONValue(noteObj, "created")),
+                                  std::stoll(ExtractJSONValue(noteObj, "modified")) });
+            }
+            pos = objEnd + 1;
+        }
+        return notes;
+    }
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? std::atoi(argv[1]) : 10000;
+    if (count <= 0) {
+        std::fprintf(stderr, "usage: %s [noteCount]\n", argv[0]);
+        return 2;
+    }
+
+    // Note text: letters, spaces, newlines, quotes and dots, so escaping is exercised
+    std::mt19937 rng(1);
+    std::vector<std::string> texts;
+    std::vector<std::string> names;
+    std::vector<NoteBackupFormat::NoteRecord> records;
+    texts.reserve(count);
+    names.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        std::string text;
+        int length = 50 + static_cast<int>(rng() % 400);
+        for (int k = 0; k < length; ++k) {
+            int r = static_cast<int>(rng() % 40);
+            text += r < 30 ? static_cast<char>('a' + r % 26) : r < 36 ? ' ' : r == 36 ? '\n' : r == 37 ? '"' : '.';
+        }
+        texts.push_back(std::move(text));
+        names.push_back("Quest number " + std::to_string(i));
+    }
+    for (int i = 0; i < count; ++i) {
+        records.push_back({ static_cast<std::uint32_t>(0x01000000 + i * 7), texts[i], names[i],
+                            1700000000 + i, 1700000500 + i });
+    }
+
+    auto start = Clock::now();
+    std::string json = WriteJSON(records);
+    double jsonWrite = MillisecondsSince(start);
+
+    start = Clock::now();
+    std::vector<ParsedNote> parsed = ParseJSON(json);
+    double jsonParse = MillisecondsSince(start);
+
+    start = Clock::now();
+    std::string binary = NoteBackupFormat::Write("Dragonborn", "2026-01-01T00:00:00", records);
+    double binaryWrite = MillisecondsSince(start);
+
+    fs::path path = fs::temp_directory_path() / "PersonalNotesBench.pnb";
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << binary;
+    }
+
+    start = Clock::now();
+    NoteBackupFormat::MappedBackup backup;
+    bool opened = backup.Open(path.string());
+    double binaryOpen = MillisecondsSince(start);
+
+    start = Clock::now();
+    size_t totalText = 0;
+    NoteBackupFormat::NoteRecord record;
+    for (std::uint32_t i = 0; opened && i < backup.Size(); ++i) {
+        if (backup.At(i, record)) {
+            totalText += record.text.size();
+        }
+    }
+    double binaryIterate = MillisecondsSince(start);
+
+    start = Clock::now();
+    int found = 0;
+    for (int i = 0; opened && i < count; ++i) {
+        found += backup.Find(records[i].questID, record) && record.text == texts[i];
+    }
+    double binaryLookup = MillisecondsSince(start);
+
+    backup.Close();
+    std::error_code ec;
+    fs::remove(path, ec);
+
+    // Results feed nothing else; check them so the timed work can't be optimized out
+    bool ok = opened && found == count && parsed.size() == static_cast<size_t>(count);
+    for (int i = 0; ok && i < count; ++i) {
+        ok = parsed[i].text == texts[i] && parsed[i].modified == records[i].modified;
+    }
+    if (!ok) {
+        std::fprintf(stderr, "verification failed: %s\n", backup.LastError().c_str());
+        return 1;
+    }
+
+    std::printf("notes           %d (%zu text bytes)\n", count, totalText);
+    std::printf("JSON            %zu bytes, write %.1f ms, parse %.1f ms\n", json.size(), jsonWrite, jsonParse);
+    std::printf(".pnb            %zu bytes, write %.1f ms, open %.3f ms, iterate %.2f ms, %d lookups %.2f ms\n",
+                binary.size(), binaryWrite, binaryOpen, binaryIterate, count, binaryLookup);
+    return 0;
+}
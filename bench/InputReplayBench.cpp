@@ -0,0 +1,492 @@
+/**
+ * PersonalNotes - Input dispatch hook replay benchmark
+ *
+ * Usage: InputReplayBench [batchCount=20000]
+ *
+ * Replays a synthetic input session (gameplay, Journal browsing, typing into a
+ * note dialog, clicking through a message box) and measures:
+ *
+ * Modal filter, per button event in a modal batch:
+ *   mapping search   ControlMap::GetUserEventName(code, device) != "" (before)
+ *   bitmap           BlockedKeyMap's ControlBitmap::Test (after)
+ *
+ * Whole batch, per input batch:
+ *   baseline sink    InputHandler::ProcessEvent as the only pass, UI queries per event
+ *   single pass      InputDispatchHook: UIState once per batch, HotkeyTable lookups,
+ *                    the filter only in our text input dialog, Apply() once
+ *
+ * The game's ControlMap cannot run here, so its lookup is reproduced as a linear
+ * search over the gameplay context's mappings (one per user event and device, as
+ * in the vanilla controlmap.txt). It returns a reference instead of copying a
+ * BSFixedString, so it understates the real cost if anything. UI queries and
+ * Journal quest reads are engine calls too: they are counted, not timed, and the
+ * batch timings cover only the plugin's own work around them.
+ */
+
+#include "InputTables.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double NanosecondsSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    }
+
+    //-------------------------------------------------------------------------
+    // Replayed session
+    //-------------------------------------------------------------------------
+
+    // RE::INPUT_DEVICE order
+    constexpr std::size_t kKeyboard = 0;
+    constexpr std::size_t kMouse = 1;
+    constexpr std::size_t kGamepad = 2;
+    constexpr std::size_t kDeviceCount = 3;
+
+    // SettingsManager defaults
+    constexpr std::uint32_t kNoteHotkey = 51;
+    constexpr std::uint32_t kQuickAccessHotkey = 52;
+
+    enum class EventType : std::uint8_t { kButton, kMouseMove, kChar, kThumbstick };
+
+    struct Event {
+        EventType type;
+        std::size_t device;
+        std::uint32_t code;  // Button idCode
+        bool down;
+    };
+
+    enum class Scene : std::uint8_t {
+        kGameplay,
+        kJournal,
+        kTextInput,   // Note dialog (modal)
+        kMessageBox,  // Third-party modal menu
+    };
+
+    struct Batch {
+        Scene scene;
+        std::vector<Event> events;
+
+        [[nodiscard]] bool Modal() const {
+            return scene == Scene::kTextInput || scene == Scene::kMessageBox;
+        }
+    };
+
+    /**
+     * One batch per frame: scenes of 100-400 frames each, cycling through all four.
+     */
+    std::vector<Batch> GenerateSession(int batchCount) {
+        std::mt19937 rng(1);
+        auto chance = [&rng](int percent) { return static_cast<int>(rng() % 100) < percent; };
+        auto button = [](std::size_t device, std::uint32_t code, bool down) {
+            return Event{ EventType::kButton, device, code, down };
+        };
+        const std::uint32_t movement[] = { 0x11, 0x1E, 0x1F, 0x20 };  // WASD
+        const std::uint32_t letters[] = { 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19,
+                                          0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26,
+                                          0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x39, 0x39, 0x39 };
+
+        std::vector<Batch> session;
+        session.reserve(batchCount);
+        int sceneIndex = 0;
+        while (static_cast<int>(session.size()) < batchCount) {
+            auto scene = static_cast<Scene>(sceneIndex++ % 4);
+            int frames = 100 + static_cast<int>(rng() % 300);
+            for (int frame = 0; frame < frames && static_cast<int>(session.size()) < batchCount; ++frame) {
+                Batch batch{ scene, {} };
+                auto& events = batch.events;
+                switch (scene) {
+                case Scene::kGameplay:
+                    // Held movement keys repeat every frame; the mouse turns the camera
+                    events.push_back(button(kKeyboard, movement[rng() % 4], true));
+                    for (int i = static_cast<int>(rng() % 3); i > 0; --i) {
+                        events.push_back({ EventType::kMouseMove, kMouse, 0, false });
+                    }
+                    if (chance(10)) events.push_back({ EventType::kThumbstick, kGamepad, 0x0B, false });
+                    if (chance(3)) events.push_back(button(kMouse, 0, true));  // Attack
+                    if (chance(1)) events.push_back(button(kKeyboard, kNoteHotkey, chance(50)));
+                    break;
+                case Scene::kJournal:
+                    if (chance(60)) events.push_back({ EventType::kMouseMove, kMouse, 0, false });
+                    if (chance(5)) events.push_back(button(kMouse, 0x08 + rng() % 2, true));  // Wheel
+                    if (chance(3)) events.push_back(button(kKeyboard, rng() % 2 ? 0xC8 : 0xD0, chance(50)));
+                    if (chance(2)) events.push_back(button(kMouse, 0, chance(50)));
+                    break;
+                case Scene::kTextInput:
+                    // About 8 keystrokes per second at 60 fps: button down + character, then up
+                    if (chance(14)) {
+                        std::uint32_t key = letters[rng() % std::size(letters)];
+                        events.push_back(button(kKeyboard, key, true));
+                        events.push_back({ EventType::kChar, kKeyboard, key, false });
+                        events.push_back(button(kKeyboard, key, false));
+                    }
+                    if (chance(5)) events.push_back({ EventType::kMouseMove, kMouse, 0, false });
+                    break;
+                case Scene::kMessageBox:
+                    if (chance(40)) events.push_back({ EventType::kMouseMove, kMouse, 0, false });
+                    if (chance(3)) events.push_back(button(kMouse, 0, chance(50)));
+                    if (chance(1)) events.push_back(button(kKeyboard, 0x1C, true));  // Enter
+                    break;
+                }
+                session.push_back(std::move(batch));
+            }
+        }
+        return session;
+    }
+
+    //-------------------------------------------------------------------------
+    // Control map (mirrors the gameplay context of the vanilla controlmap.txt)
+    //-------------------------------------------------------------------------
+
+    constexpr std::uint16_t kUnbound = 0xFF;
+
+    struct UserEvent {
+        const char* name;
+        std::uint16_t keyboard;
+        std::uint16_t mouse;
+        std::uint16_t gamepad;
+    };
+
+    constexpr UserEvent kGameplayEvents[] = {
+        { "Forward", 0x11, kUnbound, kUnbound },
+        { "Back", 0x1F, kUnbound, kUnbound },
+        { "Strafe Left", 0x1E, kUnbound, kUnbound },
+        { "Strafe Right", 0x20, kUnbound, kUnbound },
+        { "Move", kUnbound, kUnbound, 0x0B },
+        { "Look", kUnbound, 0x0A, 0x0C },
+        { "Left Attack/Block", kUnbound, 0x01, 0x09 },
+        { "Right Attack/Block", kUnbound, 0x00, 0x0A },
+        { "Activate", 0x12, kUnbound, 0x1000 },
+        { "Ready Weapon", 0x13, kUnbound, 0x4000 },
+        { "Tween Menu", 0x0F, kUnbound, 0x2000 },
+        { "Toggle POV", 0x21, 0x02, 0x0080 },
+        { "Zoom Out", kUnbound, 0x09, kUnbound },
+        { "Zoom In", kUnbound, 0x08, kUnbound },
+        { "Jump", 0x39, kUnbound, 0x8000 },
+        { "Sprint", 0x38, kUnbound, 0x0100 },
+        { "Shout", 0x2C, kUnbound, 0x0200 },
+        { "Sneak", 0x1D, kUnbound, 0x0040 },
+        { "Run", 0x2A, kUnbound, kUnbound },
+        { "Toggle Always Run", 0x3A, kUnbound, kUnbound },
+        { "Auto-Move", 0x2E, kUnbound, kUnbound },
+        { "Favorites", 0x10, kUnbound, 0x0001 },
+        { "Hotkey1", 0x02, kUnbound, 0x0004 },
+        { "Hotkey2", 0x03, kUnbound, 0x0008 },
+        { "Hotkey3", 0x04, kUnbound, kUnbound },
+        { "Hotkey4", 0x05, kUnbound, kUnbound },
+        { "Hotkey5", 0x06, kUnbound, kUnbound },
+        { "Hotkey6", 0x07, kUnbound, kUnbound },
+        { "Hotkey7", 0x08, kUnbound, kUnbound },
+        { "Hotkey8", 0x09, kUnbound, kUnbound },
+        { "Quicksave", 0x3F, kUnbound, kUnbound },
+        { "Quickload", 0x43, kUnbound, kUnbound },
+        { "Wait", 0x14, kUnbound, 0x0020 },
+        { "Journal", 0x24, kUnbound, 0x0010 },
+        { "Pause", 0x01, kUnbound, kUnbound },
+        { "Screenshot", 0xB7, kUnbound, kUnbound },
+        { "Multi-Screenshot", 0x57, kUnbound, kUnbound },
+        { "Console", 0x29, kUnbound, kUnbound },
+        { "CameraPath", 0x58, kUnbound, kUnbound },
+        { "Quick Inventory", 0x17, kUnbound, kUnbound },
+        { "Quick Magic", 0x19, kUnbound, kUnbound },
+        { "Quick Stats", 0x35, kUnbound, kUnbound },
+        { "Quick Map", 0x32, kUnbound, kUnbound },
+    };
+
+    struct Mapping {
+        std::string eventID;
+        std::uint16_t inputKey;
+    };
+
+    /**
+     * ControlMap::GetUserEventName: first mapping of the device with this input key.
+     */
+    class ControlMapModel {
+    public:
+        ControlMapModel() {
+            for (const auto& event : kGameplayEvents) {
+                const std::uint16_t keys[kDeviceCount] = { event.keyboard, event.mouse, event.gamepad };
+                for (std::size_t device = 0; device < kDeviceCount; ++device) {
+                    deviceMappings_[device].push_back({ event.name, keys[device] });
+                }
+            }
+        }
+
+        [[nodiscard]] const std::string& GetUserEventName(std::uint32_t code, std::size_t device) const {
+            for (const auto& mapping : deviceMappings_[device]) {
+                if (mapping.inputKey == code) {
+                    return mapping.eventID;
+                }
+            }
+            return empty_;
+        }
+
+        // BlockedKeyMap::Rebuild
+        void Fill(InputTables::ControlBitmap<kDeviceCount>& bitmap) const {
+            bitmap.Clear();
+            for (std::size_t device = 0; device < kDeviceCount; ++device) {
+                for (const auto& mapping : deviceMappings_[device]) {
+                    if (!mapping.eventID.empty()) {
+                        bitmap.Set(device, mapping.inputKey);
+                    }
+                }
+            }
+        }
+
+    private:
+        std::vector<Mapping> deviceMappings_[kDeviceCount];
+        std::string empty_;
+    };
+
+    //-------------------------------------------------------------------------
+    // Modal filter: per-event lookup
+    //-------------------------------------------------------------------------
+
+    struct FilterResult {
+        std::size_t events = 0;
+        std::size_t dropped = 0;
+        double nanoseconds = 0;
+    };
+
+    /**
+     * The button events of modal batches, in session order: what the filter is asked about.
+     */
+    std::vector<Event> ModalButtons(const std::vector<Batch>& session) {
+        std::vector<Event> buttons;
+        for (const auto& batch : session) {
+            for (const auto& event : batch.events) {
+                if (batch.Modal() && event.type == EventType::kButton) {
+                    buttons.push_back(event);
+                }
+            }
+        }
+        return buttons;
+    }
+
+    template <typename IsBound>
+    FilterResult ReplayFilter(const std::vector<Event>& buttons, int rounds, IsBound isBound) {
+        FilterResult result;
+        auto start = Clock::now();
+        for (int round = 0; round < rounds; ++round) {
+            for (const auto& event : buttons) {
+                result.dropped += isBound(event.device, event.code);
+            }
+        }
+        result.nanoseconds = NanosecondsSince(start);
+        result.events = buttons.size() * rounds;
+        return result;
+    }
+
+    //-------------------------------------------------------------------------
+    // Whole batch: baseline sink vs single pass in the dispatch hook
+    //-------------------------------------------------------------------------
+
+    /**
+     * What the UI queries would answer for a scene (InputHandler::UIState).
+     */
+    struct SceneState {
+        bool journalOpen;
+        bool modalOpen;
+        bool hotkeysBlocked;
+        bool textInput;  // DialogTracker::IsTextInputOpen()
+    };
+
+    SceneState StateFor(Scene scene) {
+        switch (scene) {
+        case Scene::kJournal:
+            return { true, false, false, false };
+        case Scene::kTextInput:
+            return { false, true, true, true };
+        case Scene::kMessageBox:
+            return { false, true, true, false };
+        default:
+            return { false, false, false, false };
+        }
+    }
+
+    struct PassResult {
+        std::size_t uiQueries = 0;    // UI::IsMenuOpen / IsModalMenuOpen
+        std::size_t questReads = 0;   // GetCurrentQuestInJournal (Scaleform reads)
+        std::size_t worstBatch = 0;   // Most UI queries + quest reads in one batch
+        std::size_t noteHotkeys = 0;  // Note hotkey presses acted on
+        double nanoseconds = 0;
+
+        void Count(std::size_t queries, std::size_t reads) {
+            uiQueries += queries;
+            questReads += reads;
+            worstBatch = std::max(worstBatch, queries + reads);
+        }
+    };
+
+    /**
+     * InputHandler::ProcessEvent before the hook was installed (the only pass):
+     * every button asks whether the Journal is open and whether hotkeys are blocked,
+     * every Journal release and mouse move reads the selected quest.
+     */
+    void BaselineSink(const Batch& batch, PassResult& result) {
+        SceneState state = StateFor(batch.scene);
+        std::size_t queries = 1;  // Journal open/close tracking
+        std::size_t reads = 0;
+        for (const auto& event : batch.events) {
+            if (event.type == EventType::kButton) {
+                queries += 1;                         // IsJournalCurrentlyOpen()
+                queries += state.modalOpen ? 3 : 2;   // ShouldBlockHotkeys(): console, modal, Journal
+                if (state.hotkeysBlocked) {
+                    break;  // kStop
+                }
+                if (state.journalOpen && !event.down) {
+                    ++reads;  // Read before checking which key it was
+                }
+                if (event.down && event.code == kNoteHotkey) {
+                    ++result.noteHotkeys;
+                }
+                if (event.down && event.code == kQuickAccessHotkey && !state.journalOpen) {
+                    ++result.noteHotkeys;
+                }
+            } else if (event.type == EventType::kMouseMove) {
+                queries += 1;
+                reads += state.journalOpen;
+            }
+        }
+        result.Count(queries, reads);
+    }
+
+    /**
+     * InputDispatchHook::DispatchInputEvent + InputHandler::Scan/Apply.
+     */
+    void SinglePass(const Batch& batch, const InputTables::HotkeyTable& hotkeys,
+                    const InputTables::ControlBitmap<kDeviceCount>& bound, PassResult& result) {
+        SceneState state = StateFor(batch.scene);
+        std::size_t queries = 3;  // UIState::Capture(): Journal, modal, console
+        bool readQuest = false;
+        bool filterControls = state.modalOpen && state.textInput;
+        for (const auto& event : batch.events) {
+            if (event.type == EventType::kButton) {
+                if (filterControls && event.device != kMouse && bound.Test(event.device, event.code)) {
+                    continue;  // Dropped
+                }
+                if (state.hotkeysBlocked) {
+                    continue;
+                }
+                auto keyCode = InputTables::HotkeyTable::ToKeyCode(static_cast<InputTables::Device>(event.device), event.code);
+                switch (hotkeys.Lookup(keyCode, 0)) {
+                case InputTables::HotkeyAction::kNoteInput:
+                    result.noteHotkeys += event.down;
+                    break;
+                case InputTables::HotkeyAction::kQuickAccess:
+                    result.noteHotkeys += event.down && !state.journalOpen;
+                    break;
+                case InputTables::HotkeyAction::kJournalKeyNavigate:
+                case InputTables::HotkeyAction::kJournalMouseSelect:
+                    readQuest = readQuest || (state.journalOpen && !event.down);
+                    break;
+                default:
+                    break;
+                }
+            } else if (event.type == EventType::kMouseMove) {
+                readQuest = readQuest || state.journalOpen;
+            }
+        }
+        result.Count(queries, readQuest ? 1 : 0);  // Apply() reads the quest once
+    }
+
+    InputTables::HotkeyTable BuildHotkeys() {
+        using InputTables::HotkeyAction;
+        InputTables::HotkeyTable table;
+        table.Bind(200, 0, HotkeyAction::kJournalKeyNavigate);  // Arrows, page up/down
+        table.Bind(208, 0, HotkeyAction::kJournalKeyNavigate);
+        table.Bind(201, 0, HotkeyAction::kJournalKeyNavigate);
+        table.Bind(209, 0, HotkeyAction::kJournalKeyNavigate);
+        table.Bind(256, 0, HotkeyAction::kJournalMouseSelect);
+        table.Bind(264, 0, HotkeyAction::kJournalScroll);
+        table.Bind(265, 0, HotkeyAction::kJournalScroll);
+        table.Bind(kNoteHotkey, 0, HotkeyAction::kNoteInput);
+        table.Bind(kQuickAccessHotkey, 0, HotkeyAction::kQuickAccess);
+        return table;
+    }
+
+    template <typename Pass>
+    PassResult ReplayBatches(const std::vector<Batch>& session, int rounds, Pass pass) {
+        PassResult result;
+        auto start = Clock::now();
+        for (int round = 0; round < rounds; ++round) {
+            for (const auto& batch : session) {
+                pass(batch, result);
+            }
+        }
+        result.nanoseconds = NanosecondsSince(start);
+        return result;
+    }
+}
+
+int main(int argc, char** argv) {
+    int batchCount = argc > 1 ? std::atoi(argv[1]) : 20000;
+    if (batchCount <= 0) {
+        std::fprintf(stderr, "usage: %s [batchCount]\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<Batch> session = GenerateSession(batchCount);
+    std::size_t eventCount = 0;
+    for (const auto& batch : session) {
+        eventCount += batch.events.size();
+    }
+
+    ControlMapModel controlMap;
+    static InputTables::ControlBitmap<kDeviceCount> bitmap;  // 24 KB, keep it off the stack
+    controlMap.Fill(bitmap);
+
+    // Replay several times so short sessions still give measurable totals
+    const int rounds = 50;
+    std::vector<Event> modalButtons = ModalButtons(session);
+    FilterResult search = ReplayFilter(modalButtons, rounds, [&](std::size_t device, std::uint32_t code) {
+        return !controlMap.GetUserEventName(code, device).empty();
+    });
+    FilterResult bits = ReplayFilter(modalButtons, rounds, [&](std::size_t device, std::uint32_t code) {
+        return bitmap.Test(device, code);
+    });
+
+    InputTables::HotkeyTable hotkeys = BuildHotkeys();
+    PassResult baseline = ReplayBatches(session, rounds, [](const Batch& batch, PassResult& result) {
+        BaselineSink(batch, result);
+    });
+    PassResult single = ReplayBatches(session, rounds, [&](const Batch& batch, PassResult& result) {
+        SinglePass(batch, hotkeys, bitmap, result);
+    });
+
+    // Both lookups must drop the same events and both passes see the same hotkey
+    // presses; this also keeps the timed work alive
+    if (search.dropped != bits.dropped || baseline.noteHotkeys != single.noteHotkeys) {
+        std::fprintf(stderr, "verification failed: dropped %zu vs %zu, hotkeys %zu vs %zu\n",
+                     search.dropped, bits.dropped, baseline.noteHotkeys, single.noteHotkeys);
+        return 1;
+    }
+
+    auto perEvent = [](const FilterResult& result) {
+        return result.events ? result.nanoseconds / static_cast<double>(result.events) : 0.0;
+    };
+    std::printf("session         %d batches, %zu events, %zu modal button events (x%d rounds)\n",
+                batchCount, eventCount, modalButtons.size(), rounds);
+    std::printf("modal filter    mapping search %.1f ns/event, bitmap %.1f ns/event (%zu dropped)\n",
+                perEvent(search), perEvent(bits), search.dropped / rounds);
+
+    auto printPass = [&](const char* name, const PassResult& result) {
+        double batches = static_cast<double>(session.size()) * rounds;
+        std::printf("%-15s %.1f ns/batch plugin work, %.2f UI queries/batch, %.3f quest reads/batch, "
+                    "worst batch %zu engine calls\n",
+                    name, result.nanoseconds / batches, static_cast<double>(result.uiQueries) / batches,
+                    static_cast<double>(result.questReads) / batches, result.worstBatch);
+    };
+    printPass("baseline sink", baseline);
+    printPass("single pass", single);
+    return 0;
+}
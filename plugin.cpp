@@ -16,12 +16,37 @@
 #include "RE/Skyrim.h"
 #include "SKSE/SKSE.h"
 
+#include "PersonalNotesAPI.h"
+#include "NoteEditorModel.h"
+#include "DurableFile.h"
+#include "NoteBackupFormat.h"
+#include "BackupJSON.h"
+#include "FrameScheduler.h"
+#include "InputTables.h"
+
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/basic_file_sink.h>
 
 #include <windows.h>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <array>
+#include <bitset>
+#include <bit>
+#include <memory>
+#include <functional>
+#include <optional>
+#include <deque>
+#include <thread>
+#include <condition_variable>
+#include <future>
+#include <limits>
+#include <span>
+#include <numeric>
+#include <atomic>
+#include <mutex>
 #include <shared_mutex>
 #include <ctime>
 #include <fstream>
@@ -29,6 +54,7 @@
 #include <filesystem>
 #include <iomanip>
 #include <chrono>
+#include <cmath>
 
 //=============================================================================
 // Version Information
@@ -46,8 +72,11 @@ namespace Paths {
     constexpr const char* BASE_DIR = "Data/SKSE/Plugins/PersonalNotes";
     constexpr const char* LOG_FILE = "Data/SKSE/Plugins/PersonalNotes.log";  // Standard: same folder as DLL
     constexpr const char* BACKUP_DIR = "Data/SKSE/Plugins/PersonalNotes/backup";
+    constexpr const char* BACKUP_CATALOG = "Data/SKSE/Plugins/PersonalNotes/backup/catalog.json";
     constexpr const char* IMPORT_DIR = "Data/SKSE/Plugins/PersonalNotes/import";
     constexpr const char* IMPORT_FILE = "Data/SKSE/Plugins/PersonalNotes/import/notes.json";
+    constexpr const char* IMPORT_BINARY_FILE = "Data/SKSE/Plugins/PersonalNotes/import/notes.pnb";  // Used if there is no notes.json
+    constexpr const char* TRACE_DIR = "Data/SKSE/Plugins/PersonalNotes/trace";
 }
 
 //=============================================================================
@@ -59,17 +88,48 @@ namespace UIConstants {
     constexpr int TEXTFIELD_TOP_DEPTH = 999999;      // Very high depth to render on absolute top
     constexpr int TEXTFIELD_DEFAULT_WIDTH = 600;     // Default width for text field
     constexpr int TEXTFIELD_DEFAULT_HEIGHT = 50;     // Default height for text field
+
+    // Journal quest list badges
+    constexpr const char* NOTE_BADGE = " \xE2\x80\xA2";  // " •" appended to the title of quests with a note
+    constexpr size_t NOTE_BADGE_WINDOW = 32;            // Entries refreshed from the scroll position (> visible rows)
+
+    // Debug performance overlay (HUD)
+    constexpr int PERF_OVERLAY_X = 10;
+    constexpr int PERF_OVERLAY_Y = 10;
+    constexpr int PERF_OVERLAY_FONT_SIZE = 14;
 }
 
 namespace KeyCodes {
     // Keyboard scan codes
     constexpr uint32_t ARROW_UP = 200;
     constexpr uint32_t ARROW_DOWN = 208;
+    constexpr uint32_t ARROW_LEFT = 203;
+    constexpr uint32_t ARROW_RIGHT = 205;
     constexpr uint32_t PAGE_UP = 201;
     constexpr uint32_t PAGE_DOWN = 209;
+    constexpr uint32_t HOME = 199;
+    constexpr uint32_t END = 207;
+    constexpr uint32_t ESCAPE = 1;
+    constexpr uint32_t BACKSPACE = 14;
+    constexpr uint32_t ENTER = 28;
+    constexpr uint32_t NUMPAD_ENTER = 156;
+    constexpr uint32_t DELETE_KEY = 211;
+    constexpr uint32_t KEY_A = 30;
+    constexpr uint32_t KEY_C = 46;
+    constexpr uint32_t KEY_S = 31;
+    constexpr uint32_t KEY_V = 47;
+    constexpr uint32_t KEY_X = 45;
+    constexpr uint32_t KEY_Y = 21;
+    constexpr uint32_t KEY_Z = 44;
 
     // Mouse button codes
     constexpr uint32_t MOUSE_LEFT = 256;
+    constexpr uint32_t MOUSE_WHEEL_UP = 264;
+    constexpr uint32_t MOUSE_WHEEL_DOWN = 265;
+
+    // Gamepad button codes (InputTables::HotkeyTable::ToKeyCode)
+    constexpr uint32_t GAMEPAD_START = 270;
+    constexpr uint32_t GAMEPAD_B = 277;
 }
 
 //=============================================================================
@@ -121,18 +181,188 @@ namespace NoteUtils {
     }
 }
 
+//=============================================================================
+// Memory Accounting
+//=============================================================================
+
+/**
+ * @namespace MemStats
+ * @brief Per-subsystem heap accounting for the plugin's own containers.
+ *
+ * CountingAllocator is a stateless std allocator tagged with a Subsystem at compile
+ * time; containers that use it report live bytes, live allocations, lifetime
+ * allocations and peak bytes. Strings short enough for the small-string buffer
+ * never allocate and are not counted.
+ *
+ * The tag belongs to the type, so a copied note (e.g. inside a snapshot) counts
+ * towards kNotes for its text and kSnapshots for the vector holding it.
+ */
+namespace MemStats {
+    enum class Subsystem : std::uint8_t {
+        kNotes,            // NoteManager map, index and note text
+        kSnapshots,        // NoteSnapshot storage
+        kQuestNames,       // QuestNameCache
+        kPreviews,         // NotePreviewCache
+        kBridge,           // Papyrus argument containers
+        kInternedStrings,  // BSFixedStrings handed to Papyrus (game string cache, cumulative only)
+        kCount
+    };
+
+    constexpr size_t kSubsystemCount = static_cast<size_t>(Subsystem::kCount);
+
+    constexpr std::array<const char*, kSubsystemCount> kSubsystemNames{
+        "Notes",
+        "Snapshots",
+        "QuestNames",
+        "Previews",
+        "Bridge",
+        "InternedStrings"
+    };
+
+    struct Counters {
+        std::atomic<std::int64_t> liveBytes{ 0 };
+        std::atomic<std::int64_t> liveAllocations{ 0 };
+        std::atomic<std::uint64_t> totalAllocations{ 0 };
+        std::atomic<std::uint64_t> totalBytes{ 0 };
+        std::atomic<std::int64_t> peakBytes{ 0 };
+    };
+
+    inline std::array<Counters, kSubsystemCount> counters;
+
+    inline void OnAllocate(Subsystem subsystem, size_t bytes) {
+        auto& c = counters[static_cast<size_t>(subsystem)];
+        auto size = static_cast<std::int64_t>(bytes);
+        std::int64_t live = c.liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+        c.liveAllocations.fetch_add(1, std::memory_order_relaxed);
+        c.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+        c.totalBytes.fetch_add(bytes, std::memory_order_relaxed);
+
+        std::int64_t peak = c.peakBytes.load(std::memory_order_relaxed);
+        while (live > peak && !c.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        }
+    }
+
+    inline void OnDeallocate(Subsystem subsystem, size_t bytes) {
+        auto& c = counters[static_cast<size_t>(subsystem)];
+        c.liveBytes.fetch_sub(static_cast<std::int64_t>(bytes), std::memory_order_relaxed);
+        c.liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Count memory we cause to be allocated but do not own (e.g. game string cache).
+     *
+     * Only the lifetime counters move; live bytes are unknown for such memory.
+     */
+    inline void OnExternalAllocate(Subsystem subsystem, size_t bytes) {
+        auto& c = counters[static_cast<size_t>(subsystem)];
+        c.totalAllocations.fetch_add(1, std::memory_order_relaxed);
+        c.totalBytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    /**
+     * @class CountingAllocator
+     * @brief std::allocator wrapper that reports to a Subsystem's counters.
+     */
+    template <class T, Subsystem S>
+    class CountingAllocator {
+    public:
+        using value_type = T;
+
+        template <class U>
+        struct rebind {
+            using other = CountingAllocator<U, S>;
+        };
+
+        CountingAllocator() noexcept = default;
+
+        template <class U>
+        CountingAllocator(const CountingAllocator<U, S>&) noexcept {}
+
+        [[nodiscard]] T* allocate(size_t n) {
+            T* p = std::allocator<T>{}.allocate(n);
+            OnAllocate(S, n * sizeof(T));
+            return p;
+        }
+
+        void deallocate(T* p, size_t n) noexcept {
+            OnDeallocate(S, n * sizeof(T));
+            std::allocator<T>{}.deallocate(p, n);
+        }
+
+        template <class U>
+        bool operator==(const CountingAllocator<U, S>&) const noexcept { return true; }
+    };
+
+    template <Subsystem S>
+    using String = std::basic_string<char, std::char_traits<char>, CountingAllocator<char, S>>;
+
+    template <class T, Subsystem S>
+    using Vector = std::vector<T, CountingAllocator<T, S>>;
+
+    template <class K, class V, Subsystem S>
+    using HashMap = std::unordered_map<K, V, std::hash<K>, std::equal_to<K>, CountingAllocator<std::pair<const K, V>, S>>;
+
+    /**
+     * @brief Format a byte count for humans (B, KB or MB).
+     */
+    inline std::string FormatBytes(std::int64_t bytes) {
+        if (bytes < 1024) {
+            return fmt::format("{} B", bytes);
+        }
+        if (bytes < 1024 * 1024) {
+            return fmt::format("{:.1f} KB", static_cast<double>(bytes) / 1024.0);
+        }
+        return fmt::format("{:.2f} MB", static_cast<double>(bytes) / (1024.0 * 1024.0));
+    }
+
+    /**
+     * @brief Write one line per subsystem to the log.
+     * @param reason What triggered the dump (shown in the header line)
+     */
+    inline void LogUsage(const char* reason) {
+        std::int64_t totalLive = 0;
+        for (const auto& c : counters) {
+            totalLive += c.liveBytes.load(std::memory_order_relaxed);
+        }
+        spdlog::info("[MEM] Heap usage ({}): {} live", reason, FormatBytes(totalLive));
+
+        for (size_t i = 0; i < kSubsystemCount; ++i) {
+            const auto& c = counters[i];
+            if (static_cast<Subsystem>(i) == Subsystem::kInternedStrings) {
+                spdlog::info("[MEM]   {}: {} in {} strings (lifetime)",
+                             kSubsystemNames[i],
+                             FormatBytes(static_cast<std::int64_t>(c.totalBytes.load(std::memory_order_relaxed))),
+                             c.totalAllocations.load(std::memory_order_relaxed));
+                continue;
+            }
+            spdlog::info("[MEM]   {}: {} in {} allocs | peak {} | lifetime {} allocs, {}",
+                         kSubsystemNames[i],
+                         FormatBytes(c.liveBytes.load(std::memory_order_relaxed)),
+                         c.liveAllocations.load(std::memory_order_relaxed),
+                         FormatBytes(c.peakBytes.load(std::memory_order_relaxed)),
+                         c.totalAllocations.load(std::memory_order_relaxed),
+                         FormatBytes(static_cast<std::int64_t>(c.totalBytes.load(std::memory_order_relaxed))));
+        }
+    }
+}
+
 //=============================================================================
 // Data Structures
 //=============================================================================
 
+using NoteText = MemStats::String<MemStats::Subsystem::kNotes>;
+
 struct Note {
-    std::string text;
-    std::time_t timestamp;
+    NoteText text;
+    std::time_t created;   // Unix seconds the note was first written
+    std::time_t modified;  // Unix seconds of the last write (last-writer-wins merges compare this)
     RE::FormID questID;
 
-    Note() : timestamp(0), questID(0) {}
-    Note(const std::string& t, RE::FormID qid)
-        : text(t), timestamp(std::time(nullptr)), questID(qid) {}
+    Note() : created(0), modified(0), questID(0) {}
+    Note(std::string_view t, RE::FormID qid)
+        : text(t), created(std::time(nullptr)), modified(created), questID(qid) {}
+    Note(std::string_view t, RE::FormID qid, std::time_t createdTime, std::time_t modifiedTime)
+        : text(t), created(createdTime), modified(modifiedTime), questID(qid) {}
 
     bool Save(SKSE::SerializationInterface* intfc) const {
         // Write quest ID
@@ -149,15 +379,21 @@ struct Note {
             return false;
         }
 
-        // Write timestamp
-        if (!intfc->WriteRecordData(&timestamp, sizeof(timestamp))) {
+        // Write timestamps (v3)
+        auto createdTime = static_cast<std::int64_t>(created);
+        auto modifiedTime = static_cast<std::int64_t>(modified);
+        if (!intfc->WriteRecordData(&createdTime, sizeof(createdTime)) ||
+            !intfc->WriteRecordData(&modifiedTime, sizeof(modifiedTime))) {
             return false;
         }
 
         return true;
     }
 
-    bool Load(SKSE::SerializationInterface* intfc) {
+    /**
+     * @param version Record version: v2 stores one timestamp, v3 created + modified
+     */
+    bool Load(SKSE::SerializationInterface* intfc, std::uint32_t version) {
         // Read quest ID
         if (!intfc->ReadRecordData(&questID, sizeof(questID))) {
             return false;
@@ -175,1338 +411,5718 @@ struct Note {
             }
         }
 
-        // Read timestamp
-        if (!intfc->ReadRecordData(&timestamp, sizeof(timestamp))) {
+        // Read timestamps
+        if (version < 3) {
+            std::time_t timestamp = 0;
+            if (!intfc->ReadRecordData(&timestamp, sizeof(timestamp))) {
+                return false;
+            }
+            created = modified = timestamp;
+            return true;
+        }
+
+        std::int64_t createdTime = 0;
+        std::int64_t modifiedTime = 0;
+        if (!intfc->ReadRecordData(&createdTime, sizeof(createdTime)) ||
+            !intfc->ReadRecordData(&modifiedTime, sizeof(modifiedTime))) {
             return false;
         }
+        created = static_cast<std::time_t>(createdTime);
+        modified = static_cast<std::time_t>(modifiedTime);
 
         return true;
     }
 };
 
+/**
+ * Immutable copy of the note store at a given generation, sorted by FormID.
+ * Shared between readers; never modified after construction.
+ */
+struct NoteSnapshot {
+    std::uint64_t generation = 0;
+    MemStats::Vector<Note, MemStats::Subsystem::kSnapshots> notes;
+};
+
+using NoteMap = MemStats::HashMap<RE::FormID, Note, MemStats::Subsystem::kNotes>;
+
 //=============================================================================
-// Settings Manager
+// Lock-Free Queue
 //=============================================================================
 
 /**
- * @class SettingsManager
- * @brief Manages plugin configuration loaded from INI file.
+ * @class MPSCQueue
+ * @brief Bounded lock-free multi-producer single-consumer ring buffer.
  *
- * Loads and validates settings from Data/SKSE/Plugins/PersonalNotes.ini
- * including UI positioning, text formatting, and hotkey configuration.
- * All loaded values are clamped to reasonable ranges.
+ * Producers claim a slot with one CAS and never block; a full queue makes TryPush
+ * fail so the caller can decide what to drop. Based on Dmitry Vyukov's bounded
+ * MPMC queue, with the consumer side simplified for a single consumer.
+ *
+ * @tparam T Element type (default-constructible, copy-assignable)
+ * @tparam Capacity Number of slots, must be a power of two
+ * @thread_safety TryPush from any thread; TryPop from one consumer thread at a time.
  */
-class SettingsManager {
+template <class T, size_t Capacity>
+class MPSCQueue {
+    static_assert(std::has_single_bit(Capacity), "Capacity must be a power of two");
+
 public:
-    /**
-     * @brief Get the singleton instance.
-     * @return Pointer to singleton instance (never null)
-     */
-    static SettingsManager* GetSingleton() {
-        static SettingsManager instance;
-        return &instance;
+    MPSCQueue() {
+        for (size_t i = 0; i < Capacity; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
     }
 
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
     /**
-     * @brief Load and validate settings from INI file.
-     *
-     * Reads configuration from Data/SKSE/Plugins/PersonalNotes.ini and
-     * clamps all values to valid ranges (e.g., font sizes 8-72, positions within 4K bounds).
+     * @brief Enqueue a value.
+     * @return false if the queue is full (value not enqueued)
      */
-    void LoadSettings() {
-        constexpr auto path = L"Data/SKSE/Plugins/PersonalNotes.ini";
-
-        // Flush Windows INI cache to ensure we read the latest file (dMenu may have modified it)
-        WritePrivateProfileStringW(nullptr, nullptr, nullptr, path);
-
-        // Check for UTF-8 BOM and remove it if present (dMenu may write with BOM)
-        {
-            std::ifstream iniFile("Data/SKSE/Plugins/PersonalNotes.ini", std::ios::binary);
-            if (iniFile) {
-                unsigned char bytes[3];
-                iniFile.read(reinterpret_cast<char*>(bytes), 3);
-
-                // Check for UTF-8 BOM (EF BB BF)
-                if (iniFile.gcount() >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF) {
-                    // Read rest of file
-                    std::string content((std::istreambuf_iterator<char>(iniFile)), std::istreambuf_iterator<char>());
-                    iniFile.close();
-
-                    // Write back without BOM
-                    std::ofstream outFile("Data/SKSE/Plugins/PersonalNotes.ini", std::ios::binary);
-                    if (outFile) {
-                        outFile.write(content.c_str(), content.size());
-                        outFile.close();
-                        spdlog::info("[SETTINGS] Removed UTF-8 BOM from INI file");
-
-                        // Flush cache after rewriting
-                        WritePrivateProfileStringW(nullptr, nullptr, nullptr, path);
-                    }
+    bool TryPush(T value) {
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & (Capacity - 1)];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
                 }
+            } else if (diff < 0) {
+                return false;  // Full
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
             }
         }
-
-        // Helper to read number from INI (handles both int and float formats from dMenu)
-        // dMenu writes integers as floats (e.g., "500.000000"), so we read as float and convert
-        auto ReadNumber = [](const wchar_t* section, const wchar_t* key, float defaultValue, const wchar_t* iniPath) -> float {
-            wchar_t buffer[32];
-            GetPrivateProfileStringW(section, key, L"", buffer, 32, iniPath);
-            if (buffer[0] == L'\0') {
-                return defaultValue;
-            }
-            return std::wcstof(buffer, nullptr);
-        };
-
-        // TextField
-        textFieldX = ReadNumber(L"TextField", L"fPositionX", 5.0f, path);
-        textFieldY = ReadNumber(L"TextField", L"fPositionY", 5.0f, path);
-        textFieldFontSize = static_cast<int>(ReadNumber(L"TextField", L"iFontSize", 20.0f, path));
-        textFieldColor = static_cast<int>(ReadNumber(L"TextField", L"iTextColor", 16777215.0f, path));
-
-        // TextInput
-        textInputWidth = static_cast<int>(ReadNumber(L"TextInput", L"iWidth", 500.0f, path));
-        textInputHeight = static_cast<int>(ReadNumber(L"TextInput", L"iHeight", 400.0f, path));
-        textInputFontSize = static_cast<int>(ReadNumber(L"TextInput", L"iFontSize", 14.0f, path));
-        textInputAlignment = static_cast<int>(ReadNumber(L"TextInput", L"iAlignment", 0.0f, path));
-
-        // Hotkey
-        noteHotkeyScanCode = static_cast<int>(ReadNumber(L"Hotkey", L"iScanCode", 51.0f, path));
-        quickAccessScanCode = static_cast<int>(ReadNumber(L"Hotkey", L"iQuickAccessScanCode", 52.0f, path));
-
-        // Validate and clamp loaded values to reasonable ranges
-        textFieldX = std::clamp(textFieldX, 0.0f, 3840.0f);      // Max 4K width
-        textFieldY = std::clamp(textFieldY, 0.0f, 2160.0f);      // Max 4K height
-        textFieldFontSize = std::clamp(textFieldFontSize, 8, 72);
-        // textFieldColor: allow any value (0x000000 to 0xFFFFFF valid)
-
-        textInputWidth = std::clamp(textInputWidth, 200, 3840);
-        textInputHeight = std::clamp(textInputHeight, 100, 2160);
-        textInputFontSize = std::clamp(textInputFontSize, 8, 72);
-        textInputAlignment = std::clamp(textInputAlignment, 0, 2);  // 0=left, 1=center, 2=right
-
-        noteHotkeyScanCode = std::clamp(noteHotkeyScanCode, 0, 255);  // Valid scan code range
-        quickAccessScanCode = std::clamp(quickAccessScanCode, 0, 255);  // Valid scan code range
-
-        // Update last modified timestamp
-        UpdateTimestamp();
-
-        spdlog::info("[SETTINGS] Loaded from INI");
     }
 
     /**
-     * @brief Reload settings if INI file has been modified.
-     * @return True if settings were reloaded, false if no change detected.
-     *
-     * Checks if PersonalNotes.ini has been modified since last load.
-     * If modified, reloads all settings. Used for runtime config changes via dMenu.
+     * @brief Dequeue a value (consumer thread only).
+     * @return false if the queue is empty
      */
-    bool ReloadIfChanged() {
-        namespace fs = std::filesystem;
-
-        try {
-            fs::path iniPath = "Data/SKSE/Plugins/PersonalNotes.ini";
-
-            if (!fs::exists(iniPath)) {
-                return false;
-            }
-
-            auto currentTimestamp = fs::last_write_time(iniPath);
-
-            if (currentTimestamp != lastModifiedTime_) {
-                spdlog::info("[SETTINGS] INI changed, reloading");
-                LoadSettings();
-                return true;
-            }
-        } catch (const std::exception& e) {
-            spdlog::warn("[SETTINGS] Failed to check INI timestamp: {}", e.what());
+    bool TryPop(T& out) {
+        Cell& cell = cells_[dequeuePos_ & (Capacity - 1)];
+        size_t sequence = cell.sequence.load(std::memory_order_acquire);
+        if (static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(dequeuePos_ + 1) < 0) {
+            return false;  // Empty (or producer still writing this slot)
         }
 
-        return false;
+        out = std::move(cell.value);
+        cell.sequence.store(dequeuePos_ + Capacity, std::memory_order_release);
+        ++dequeuePos_;
+        return true;
     }
 
-    // TextField
-    float textFieldX = 5.0f;
-    float textFieldY = 5.0f;
-    int textFieldFontSize = 20;
-    int textFieldColor = 0xFFFFFF;
-
-    // TextInput
-    int textInputWidth = 500;
-    int textInputHeight = 400;
-    int textInputFontSize = 14;
-    int textInputAlignment = 0;
-
-    // Hotkey
-    int noteHotkeyScanCode = 51;
-    int quickAccessScanCode = 52;  // dot key
-
 private:
-    SettingsManager() = default;
-
-    /**
-     * @brief Update timestamp from INI file.
-     *
-     * Records the last modified time of PersonalNotes.ini for change detection.
-     */
-    void UpdateTimestamp() {
-        namespace fs = std::filesystem;
-
-        try {
-            fs::path iniPath = "Data/SKSE/Plugins/PersonalNotes.ini";
-
-            if (fs::exists(iniPath)) {
-                lastModifiedTime_ = fs::last_write_time(iniPath);
-            }
-        } catch (const std::exception& e) {
-            spdlog::warn("[SETTINGS] Failed to update INI timestamp: {}", e.what());
-        }
-    }
-
-    // INI file timestamp for change detection
-    std::filesystem::file_time_type lastModifiedTime_;
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value{};
+    };
+
+    std::array<Cell, Capacity> cells_;
+    alignas(64) std::atomic<size_t> enqueuePos_{ 0 };
+    alignas(64) size_t dequeuePos_ = 0;  // Consumer-owned
 };
 
 //=============================================================================
-// Note Manager
+// Job System
 //=============================================================================
 
+enum class JobPriority : std::uint8_t {
+    kUICritical = 0,  // Work the player is waiting on (export started from a menu, ...)
+    kBackground = 1,  // Maintenance (pruning, rebuilds, ...)
+    kCount
+};
+
 /**
- * @class NoteManager
- * @brief Thread-safe manager for quest and general notes with SKSE serialization.
+ * @class JobSystem
+ * @brief Small work-stealing thread pool for file I/O and other slow plugin work.
  *
- * Manages a collection of notes indexed by quest FormID. Thread-safe for
- * concurrent read/write operations using shared_mutex. Notes are persisted
- * across game sessions via SKSE co-save system.
+ * Each worker owns a deque per priority. Workers pop their own queue from the back
+ * (most recent, cache-warm) and steal from the front of other workers' queues when
+ * idle. UI-critical jobs are always taken before background jobs, including when
+ * stealing. Results that must touch game state go back through RunOnMainThread().
+ *
+ * Threads are started lazily on the first Submit(), so the pool costs nothing
+ * until something actually needs it.
  *
- * @note Uses FormID 0xFFFFFFFF (GENERAL_NOTE_ID) for general notes not tied to specific quests.
  * @thread_safety All public methods are thread-safe.
  */
-class NoteManager {
+class JobSystem {
 public:
-    static constexpr std::uint32_t kDataKey = 'PNOT';  // PersonalNOTes
-    static constexpr std::uint32_t kSerializationVersion = 2;
-    static constexpr RE::FormID GENERAL_NOTE_ID = 0xFFFFFFFF;  // Special ID for general notes
+    using Job = std::function<void()>;
+
+    static constexpr size_t kWorkerCount = 2;
 
     /**
      * @brief Get the singleton instance.
-     * @return Pointer to singleton instance (never null, valid for program lifetime)
+     * @return Pointer to singleton instance (never null)
      */
-    static NoteManager* GetSingleton() {
-        static NoteManager instance;
+    static JobSystem* GetSingleton() {
+        static JobSystem instance;
         return &instance;
     }
 
     /**
-     * @brief Retrieves note text for a specific quest.
-     * @param questID The quest's FormID (use GENERAL_NOTE_ID for general notes)
-     * @return Note text if exists, empty string otherwise
-     * @thread_safety Thread-safe (uses shared lock)
+     * @brief Queue a job on the pool.
+     * @param priority Scheduling class of the job
+     * @param job Work to run on a worker thread (exceptions are caught and logged)
      */
-    [[nodiscard]] std::string GetNoteForQuest(RE::FormID questID) const {
-        std::shared_lock lock(lock_);
+    void Submit(JobPriority priority, Job job) {
+        std::call_once(started_, [this]() { Start(); });
 
-        if (auto it = notesByQuest_.find(questID); it != notesByQuest_.end()) {
-            return it->second.text;
+        // Jobs submitted from a worker stay local; others are spread round-robin
+        size_t index = currentWorker_ >= 0
+            ? static_cast<size_t>(currentWorker_)
+            : nextWorker_.fetch_add(1, std::memory_order_relaxed) % kWorkerCount;
+
+        {
+            std::lock_guard lock(workers_[index]->lock);
+            workers_[index]->queues[static_cast<size_t>(priority)].push_back(std::move(job));
         }
-        return "";
+        {
+            std::lock_guard lock(wakeLock_);
+            pending_++;
+        }
+        wake_.notify_one();
     }
 
     /**
-     * @brief Saves or updates a note for a quest.
-     * @param questID The quest's FormID (0 is invalid, GENERAL_NOTE_ID for general notes)
-     * @param text Note text to save (empty string deletes the note)
-     * @thread_safety Thread-safe (uses unique lock)
-     * @note Input is validated and sanitized before storage
+     * @brief Queue a job and continue on the main thread with its result.
+     * @param priority Scheduling class of the job
+     * @param work Callable run on a worker, returning a value
+     * @param continuation Callable run on the main thread with work's result
      */
-    void SaveNoteForQuest(RE::FormID questID, const std::string& text) {
-        // Validate FormID
-        if (questID == 0) {
-            spdlog::warn("[NOTE] Invalid quest ID: 0");
-            return;
+    template <class Work, class Continuation>
+    void SubmitThen(JobPriority priority, Work work, Continuation continuation) {
+        Submit(priority, [work = std::move(work), continuation = std::move(continuation)]() mutable {
+            auto result = std::make_shared<decltype(work())>(work());
+            RunOnMainThread([continuation = std::move(continuation), result]() mutable {
+                continuation(std::move(*result));
+            });
+        });
+    }
+
+    /**
+     * @brief Run a callable on the main thread via the SKSE task interface.
+     * @param task Callable to run during the next main-thread task pass
+     */
+    static void RunOnMainThread(std::function<void()> task) {
+        if (auto tasks = SKSE::GetTaskInterface()) {
+            tasks->AddTask(std::move(task));
+        } else {
+            spdlog::error("[JOBS] Task interface unavailable, dropping main-thread continuation");
         }
+    }
 
-        // Validate quest exists (except for GENERAL_NOTE_ID)
-        if (questID != GENERAL_NOTE_ID) {
-            auto quest = RE::TESForm::LookupByID<RE::TESQuest>(questID);
-            if (!quest) {
-                spdlog::warn("[NOTE] Quest 0x{:X} not found, saving note anyway", questID);
-                // Allow saving anyway - quest might be from another plugin
+private:
+    struct Worker {
+        std::mutex lock;
+        std::array<std::deque<Job>, static_cast<size_t>(JobPriority::kCount)> queues;
+    };
+
+    JobSystem() {
+        for (auto& worker : workers_) {
+            worker = std::make_unique<Worker>();
+        }
+    }
+
+    /**
+     * Workers are detached rather than joined: at process exit Windows has already
+     * terminated them, and joining from DLL teardown can deadlock on the loader lock.
+     */
+    ~JobSystem() {
+        {
+            std::lock_guard lock(wakeLock_);
+            stopping_ = true;
+        }
+        wake_.notify_all();
+        for (auto& thread : threads_) {
+            if (thread.joinable()) {
+                thread.detach();
             }
         }
+    }
 
-        std::unique_lock lock(lock_);
+    void Start() {
+        for (size_t i = 0; i < kWorkerCount; ++i) {
+            threads_.emplace_back([this, i]() { WorkerLoop(i); });
+        }
+        spdlog::info("[JOBS] Started {} worker threads", kWorkerCount);
+    }
 
-        if (text.empty()) {
-            // Empty text = delete note
-            notesByQuest_.erase(questID);
-        } else {
-            // Sanitize input text before storage
-            std::string sanitizedText = NoteUtils::SanitizeNoteText(text);
+    void WorkerLoop(size_t index) {
+        currentWorker_ = static_cast<int>(index);
+        SetThreadDescription(GetCurrentThread(), L"PersonalNotes Worker");
+
+        for (;;) {
+            {
+                std::unique_lock lock(wakeLock_);
+                wake_.wait(lock, [this]() { return stopping_ || pending_ > 0; });
+                if (stopping_) {
+                    return;
+                }
+                pending_--;
+            }
+
+            // pending_ counted one queued job for us; keep looking until we find it
+            Job job;
+            while (!TryTakeJob(index, job)) {
+                std::this_thread::yield();
+            }
 
-            Note note(sanitizedText, questID);
-            notesByQuest_[questID] = note;
+            try {
+                job();
+            } catch (const std::exception& e) {
+                spdlog::error("[JOBS] Job failed: {}", e.what());
+            } catch (...) {
+                spdlog::error("[JOBS] Job failed with unknown exception");
+            }
         }
     }
 
     /**
-     * @brief Checks if a note exists for a quest.
-     * @param questID The quest's FormID
-     * @return true if note exists, false otherwise
-     * @thread_safety Thread-safe (uses shared lock)
+     * Takes the highest-priority job available: own queue first, then steal.
      */
-    [[nodiscard]] bool HasNoteForQuest(RE::FormID questID) const {
-        std::shared_lock lock(lock_);
-        return notesByQuest_.find(questID) != notesByQuest_.end();
+    bool TryTakeJob(size_t index, Job& out) {
+        for (size_t priority = 0; priority < static_cast<size_t>(JobPriority::kCount); ++priority) {
+            // Own queue: newest first
+            {
+                auto& worker = *workers_[index];
+                std::lock_guard lock(worker.lock);
+                auto& queue = worker.queues[priority];
+                if (!queue.empty()) {
+                    out = std::move(queue.back());
+                    queue.pop_back();
+                    return true;
+                }
+            }
+
+            // Steal: oldest first
+            for (size_t offset = 1; offset < kWorkerCount; ++offset) {
+                auto& victim = *workers_[(index + offset) % kWorkerCount];
+                std::lock_guard lock(victim.lock);
+                auto& queue = victim.queues[priority];
+                if (!queue.empty()) {
+                    out = std::move(queue.front());
+                    queue.pop_front();
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    std::array<std::unique_ptr<Worker>, kWorkerCount> workers_;
+    std::vector<std::thread> threads_;
+    std::once_flag started_;
+    std::atomic<size_t> nextWorker_{ 0 };
+
+    std::mutex wakeLock_;
+    std::condition_variable wake_;
+    size_t pending_ = 0;     // Queued jobs not yet claimed by a worker (guarded by wakeLock_)
+    bool stopping_ = false;  // Guarded by wakeLock_
+
+    static inline thread_local int currentWorker_ = -1;  // Worker index of this thread, -1 if not a worker
+};
+
+//=============================================================================
+// Frame Scheduler
+//=============================================================================
+
+/**
+ * Log FrameScheduler reports (FrameScheduler.h has no logging of its own).
+ */
+inline void LogFrameSchedulerReport(FrameScheduler::Report report, const IncrementalTask& task,
+                                    const FrameScheduler::TaskStats& stats, std::string_view error) {
+    auto micros = [](FrameScheduler::Clock::duration d) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    };
+    switch (report) {
+    case FrameScheduler::Report::kFirstOverrun:
+        spdlog::warn("[SCHED] Task '{}' overran its {}us budget by {}us",
+                     task.GetName(), task.GetBudget().count(), micros(stats.worstOverrun));
+        break;
+    case FrameScheduler::Report::kFinished:
+        spdlog::info("[SCHED] Task '{}' finished: {} frames, {}us total, {} overruns (worst +{}us)",
+                     task.GetName(), stats.frames, micros(stats.total), stats.overruns, micros(stats.worstOverrun));
+        break;
+    case FrameScheduler::Report::kFailed:
+        spdlog::error("[SCHED] Task '{}' failed: {}", task.GetName(), error);
+        break;
     }
+}
+
+//=============================================================================
+// Performance Instrumentation
+//=============================================================================
+
+/**
+ * @namespace Perf
+ * @brief Scoped latency timers with per-thread lock-free histograms.
+ *
+ * Each thread that records a sample gets its own ThreadHistograms block, linked
+ * into a global list on first use. Recording is a handful of relaxed loads and
+ * stores to thread-owned memory (no RMW, no locks); readers sum all blocks.
+ * Blocks are never freed: the game's threads live for the whole session.
+ *
+ * Buckets are log-linear (4 sub-buckets per power of two), so percentiles are
+ * accurate to within 25%.
+ */
+namespace Perf {
+    enum class Probe : std::uint8_t {
+        kInputActions,
+        kDispatchInputEvent,
+        kUpdateTextField,
+        kSave,
+        kLoad,
+        kExport,
+        kImport,
+        kQuestNoteQueue,      // Papyrus: dispatch → script running (VM backlog)
+        kQuestNoteRoundTrip,  // Papyrus: dispatch → script returned
+        kGeneralNoteQueue,
+        kGeneralNoteRoundTrip,
+        kNotesListQueue,
+        kNotesListRoundTrip,
+        kEditorOpen,          // Native editor: hotkey → menu shown
+        kUICommandDrain,
+        kCount
+    };
+
+    constexpr size_t kProbeCount = static_cast<size_t>(Probe::kCount);
+
+    constexpr std::array<const char*, kProbeCount> kProbeNames{
+        "InputActions",
+        "DispatchInputEvent",
+        "UpdateTextField",
+        "Save",
+        "Load",
+        "Export",
+        "Import",
+        "ShowQuestNoteInput queue",
+        "ShowQuestNoteInput round trip",
+        "ShowGeneralNoteInput queue",
+        "ShowGeneralNoteInput round trip",
+        "ShowNotesListMenu queue",
+        "ShowNotesListMenu round trip",
+        "NoteEditor open",
+        "UICommandQueue drain"
+    };
+
+    constexpr size_t kBucketCount = 256;
 
     /**
-     * @brief Deletes a note for a quest.
-     * @param questID The quest's FormID
-     * @thread_safety Thread-safe (uses unique lock)
+     * Maps a duration in ns to its log-linear bucket.
      */
-    void DeleteNoteForQuest(RE::FormID questID) {
-        std::unique_lock lock(lock_);
-        notesByQuest_.erase(questID);
+    constexpr size_t BucketIndex(std::uint64_t ns) {
+        if (ns < 4) {
+            return static_cast<size_t>(ns);
+        }
+        size_t msb = static_cast<size_t>(std::bit_width(ns)) - 1;
+        size_t sub = static_cast<size_t>(ns >> (msb - 2)) & 3;
+        return (msb - 1) * 4 + sub;
     }
 
     /**
-     * @brief Get general note (not tied to any quest).
-     * @return General note text, empty if none
-     * @thread_safety Thread-safe
+     * Smallest duration (ns) that falls into a bucket.
      */
-    [[nodiscard]] std::string GetGeneralNote() const {
-        return GetNoteForQuest(GENERAL_NOTE_ID);
+    constexpr std::uint64_t BucketLowerBound(size_t index) {
+        if (index < 4) {
+            return index;
+        }
+        size_t msb = index / 4 + 1;
+        return static_cast<std::uint64_t>(4 + index % 4) << (msb - 2);
     }
 
     /**
-     * @brief Save general note (not tied to any quest).
-     * @param text Note text to save
-     * @thread_safety Thread-safe
+     * Single-writer histogram. Only the owning thread writes; any thread may read.
      */
-    void SaveGeneralNote(const std::string& text) {
-        SaveNoteForQuest(GENERAL_NOTE_ID, text);
-    }
+    struct Histogram {
+        std::array<std::atomic<std::uint64_t>, kBucketCount> buckets{};
+        std::atomic<std::uint64_t> count{ 0 };
+        std::atomic<std::uint64_t> maxNs{ 0 };
+
+        void Record(std::uint64_t ns) {
+            auto& bucket = buckets[BucketIndex(ns)];
+            bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            if (ns > maxNs.load(std::memory_order_relaxed)) {
+                maxNs.store(ns, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    struct ThreadHistograms {
+        std::array<Histogram, kProbeCount> probes;
+        ThreadHistograms* next = nullptr;
+    };
+
+    inline std::atomic<ThreadHistograms*> threadList{ nullptr };
 
     /**
-     * @brief Get all notes as a map.
-     * @return Copy of all notes indexed by quest FormID
-     * @warning Returns a copy - expensive for large note collections
-     * @thread_safety Thread-safe (uses shared lock)
+     * Returns the calling thread's histograms, registering them on first use.
      */
-    [[nodiscard]] std::unordered_map<RE::FormID, Note> GetAllNotes() const {
-        std::shared_lock lock(lock_);
-        return notesByQuest_;
+    inline ThreadHistograms& LocalHistograms() {
+        thread_local ThreadHistograms* local = []() {
+            auto histograms = new ThreadHistograms();
+            histograms->next = threadList.load(std::memory_order_relaxed);
+            while (!threadList.compare_exchange_weak(histograms->next, histograms,
+                                                     std::memory_order_release, std::memory_order_relaxed)) {
+            }
+            return histograms;
+        }();
+        return *local;
     }
 
     /**
-     * @brief Get total number of notes.
-     * @return Count of all stored notes
-     * @thread_safety Thread-safe (uses shared lock)
+     * @brief Record a duration measured elsewhere (e.g. across threads or callbacks).
      */
-    [[nodiscard]] size_t GetNoteCount() const {
-        std::shared_lock lock(lock_);
-        return notesByQuest_.size();
+    inline void Record(Probe probe, std::chrono::nanoseconds duration) {
+        LocalHistograms().probes[static_cast<size_t>(probe)].Record(static_cast<std::uint64_t>(std::max<std::int64_t>(duration.count(), 0)));
     }
 
-    void Save(SKSE::SerializationInterface* intfc) {
-        std::shared_lock lock(lock_);
-
-        // Write note count
-        std::uint32_t count = static_cast<std::uint32_t>(notesByQuest_.size());
-        if (!intfc->WriteRecordData(&count, sizeof(count))) {
-            spdlog::error("[SAVE] Failed to write note count");
-            return;
-        }
-
-        // Write each note
-        for (const auto& [questID, note] : notesByQuest_) {
-            if (!note.Save(intfc)) {
-                spdlog::error("[SAVE] Failed to write note for quest 0x{:X}", questID);
-                return;
-            }
+    /**
+     * @class ScopedTimer
+     * @brief Records the lifetime of the scope into a probe's histogram.
+     */
+    class ScopedTimer {
+    public:
+        explicit ScopedTimer(Probe probe)
+            : probe_(probe), start_(std::chrono::steady_clock::now()) {}
+
+        ~ScopedTimer() {
+            auto elapsed = std::chrono::steady_clock::now() - start_;
+            auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+            LocalHistograms().probes[static_cast<size_t>(probe_)].Record(static_cast<std::uint64_t>(ns));
         }
 
-        spdlog::info("[SAVE] Saved {} notes (version {})", count, kSerializationVersion);
-    }
-
-    void Load(SKSE::SerializationInterface* intfc) {
-        std::unique_lock lock(lock_);
-        notesByQuest_.clear();
+        ScopedTimer(const ScopedTimer&) = delete;
+        ScopedTimer& operator=(const ScopedTimer&) = delete;
 
-        std::uint32_t type;
-        std::uint32_t version;
-        std::uint32_t length;
+    private:
+        Probe probe_;
+        std::chrono::steady_clock::time_point start_;
+    };
 
-        while (intfc->GetNextRecordInfo(type, version, length)) {
-            if (type == kDataKey) {
-                if (version == 1) {
-                    spdlog::warn("[LOAD] Version 1 save data found (expected v{}). Legacy format not compatible. Skipping.", kSerializationVersion);
-                    continue;
-                }
-                if (version != kSerializationVersion) {
-                    spdlog::warn("[LOAD] Unknown save version: {} (expected v{}). Skipping.", version, kSerializationVersion);
-                    continue;
+    /**
+     * Aggregated view of one probe across all threads.
+     */
+    struct Summary {
+        std::uint64_t count = 0;
+        std::uint64_t maxNs = 0;
+        std::array<std::uint64_t, kBucketCount> buckets{};
+
+        /**
+         * @brief Upper bound (ns) of the bucket containing the given percentile.
+         * @param fraction Percentile as a fraction, e.g. 0.99
+         */
+        [[nodiscard]] std::uint64_t Percentile(double fraction) const {
+            if (count == 0) {
+                return 0;
+            }
+            auto target = static_cast<std::uint64_t>(std::ceil(fraction * static_cast<double>(count)));
+            std::uint64_t seen = 0;
+            for (size_t i = 0; i < kBucketCount; ++i) {
+                seen += buckets[i];
+                if (seen >= target) {
+                    return i + 1 < kBucketCount ? std::min(BucketLowerBound(i + 1) - 1, maxNs) : maxNs;
                 }
+            }
+            return maxNs;
+        }
+    };
 
-                LoadNotesData(intfc);
+    /**
+     * @brief Sum a probe's histograms over all threads.
+     */
+    inline Summary Summarize(Probe probe) {
+        Summary summary;
+        for (auto histograms = threadList.load(std::memory_order_acquire); histograms; histograms = histograms->next) {
+            const auto& histogram = histograms->probes[static_cast<size_t>(probe)];
+            summary.count += histogram.count.load(std::memory_order_relaxed);
+            summary.maxNs = std::max(summary.maxNs, histogram.maxNs.load(std::memory_order_relaxed));
+            for (size_t i = 0; i < kBucketCount; ++i) {
+                summary.buckets[i] += histogram.buckets[i].load(std::memory_order_relaxed);
             }
         }
+        return summary;
     }
 
-    void LoadNotesData(SKSE::SerializationInterface* intfc) {
-        // Read note count
-        std::uint32_t count = 0;
-        if (!intfc->ReadRecordData(&count, sizeof(count))) {
-            spdlog::error("[LOAD] Failed to read note count");
-            return;  // Now safe - won't break record iteration
+    /**
+     * @brief Format a duration for humans (ns, us or ms).
+     */
+    inline std::string FormatDuration(std::uint64_t ns) {
+        if (ns < 1000) {
+            return fmt::format("{}ns", ns);
         }
+        if (ns < 1000000) {
+            return fmt::format("{:.1f}us", static_cast<double>(ns) / 1e3);
+        }
+        return fmt::format("{:.2f}ms", static_cast<double>(ns) / 1e6);
+    }
 
-        std::uint32_t loadedCount = 0;
-        std::uint32_t failedCount = 0;
-
-        // Read each note
-        for (std::uint32_t i = 0; i < count; ++i) {
-            Note note;
-            if (note.Load(intfc)) {
-                notesByQuest_[note.questID] = note;
-                loadedCount++;
-            } else {
-                spdlog::error("[LOAD] Failed to load note {}/{}", i + 1, count);
-                failedCount++;
-                // Continue loading remaining notes instead of failing completely
+    /**
+     * @brief One line per probe with samples: name, count, p50, p99, max.
+     */
+    inline std::string FormatSummaries() {
+        std::string text;
+        for (size_t i = 0; i < kProbeCount; ++i) {
+            auto summary = Summarize(static_cast<Probe>(i));
+            if (summary.count == 0) {
+                continue;
             }
+            text += fmt::format("{} n={} p50={} p99={} max={}\n",
+                                kProbeNames[i], summary.count,
+                                FormatDuration(summary.Percentile(0.50)),
+                                FormatDuration(summary.Percentile(0.99)),
+                                FormatDuration(summary.maxNs));
         }
+        return text;
+    }
 
-        if (failedCount > 0) {
-            spdlog::warn("[LOAD] Loaded {}/{} notes successfully ({} failed, version {})",
-                         loadedCount, count, failedCount, kSerializationVersion);
-        } else {
-            spdlog::info("[LOAD] Loaded {}/{} notes successfully (version {})", loadedCount, count, kSerializationVersion);
+    /**
+     * @brief Write all probe summaries to the log.
+     */
+    inline void LogSummaries() {
+        std::string text = FormatSummaries();
+        if (text.empty()) {
+            spdlog::info("[PERF] No samples recorded");
+            return;
+        }
+        std::istringstream lines(text);
+        for (std::string line; std::getline(lines, line);) {
+            spdlog::info("[PERF] {}", line);
         }
     }
 
-    void Revert(SKSE::SerializationInterface*) {
-        // Clear RAM when starting new game (prevents note leakage between different characters)
-        std::unique_lock lock(lock_);
-        notesByQuest_.clear();
-        spdlog::info("[REVERT] Cleared notes from RAM (new game started)");
+    /**
+     * @brief Log the summaries when the plugin is unloaded at game exit.
+     *
+     * Must be called after SetupLog(): the guard object is then constructed after
+     * spdlog's registry and therefore destroyed before it, so logging is still safe.
+     */
+    inline void LogSummariesOnExit() {
+        struct ExitGuard {
+            ~ExitGuard() { LogSummaries(); }
+        };
+        static ExitGuard guard;
     }
-
-private:
-    NoteManager() = default;
-
-    std::unordered_map<RE::FormID, Note> notesByQuest_;
-    mutable std::shared_mutex lock_;
-};
+}
 
 //=============================================================================
-// Backup Manager
+// Trace Recording
 //=============================================================================
 
 /**
- * @namespace BackupManager
- * @brief Handles JSON export/import of notes for backup and restore.
+ * @namespace Trace
+ * @brief Timeline recorder that writes Chrome Trace Event JSON (open in Perfetto).
  *
- * Exports notes to timestamped JSON files in Data/SKSE/Plugins/PersonalNotes/backup/
- * Imports notes from Data/SKSE/Plugins/PersonalNotes/import/notes.json on plugin load.
+ * Off by default. While recording, each thread appends fixed-size events to its
+ * own buffer: one plain store for the event and one release store for the count,
+ * no locks. Buffers are allocated the first time a thread records and reused by
+ * later sessions. When the buffer is full further events on that thread are
+ * dropped and counted.
+ *
+ * Stop() hands the buffers to a background job that writes
+ * PersonalNotes/trace/trace_<timestamp>_<session>.json. A new session cannot start until
+ * that write has finished, so writers never reset a buffer that is being read.
  */
-namespace BackupManager {
-    namespace fs = std::filesystem;
+namespace Trace {
+    constexpr size_t kEventsPerThread = 32768;
+
+    struct Event {
+        const char* name;      // String literal
+        const char* category;  // String literal
+        std::int64_t startNs;
+        std::int64_t durationNs;
+        char phase;            // 'X' complete, 'i' instant
+    };
+
+    struct ThreadBuffer {
+        std::unique_ptr<Event[]> events = std::make_unique<Event[]>(kEventsPerThread);
+        std::atomic<size_t> count{ 0 };
+        std::atomic<std::uint64_t> dropped{ 0 };
+        std::uint32_t session = 0;  // Owner-only: session the contents belong to
+        std::atomic<std::uint32_t> publishedSession{ 0 };
+        std::uint32_t threadID = 0;
+        std::string threadName;
+        ThreadBuffer* next = nullptr;
+    };
+
+    inline std::atomic<bool> recording{ false };
+    inline std::atomic<bool> flushing{ false };
+    inline std::atomic<std::uint32_t> session{ 0 };
+    inline std::atomic<std::int64_t> epochNs{ 0 };
+    inline std::atomic<ThreadBuffer*> bufferList{ nullptr };
+
+    inline std::int64_t NowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
 
     /**
-     * @brief Get current timestamp in ISO 8601 format for filenames.
-     * @return Timestamp string like "2025-11-16_22-30-45"
+     * Reads the OS thread description (set by SetThreadDescription) as JSON-safe UTF-8.
      */
-    std::string GetTimestampForFilename() {
-        auto now = std::time(nullptr);
-        auto tm = *std::localtime(&now);
-        std::ostringstream oss;
-        oss << std::put_time(&tm, "%Y-%m-%d_%H-%M-%S");
-        return oss.str();
+    inline std::string CurrentThreadName() {
+        std::string name;
+        PWSTR description = nullptr;
+        if (SUCCEEDED(GetThreadDescription(GetCurrentThread(), &description)) && description) {
+            int size = WideCharToMultiByte(CP_UTF8, 0, description, -1, nullptr, 0, nullptr, nullptr);
+            if (size > 1) {
+                name.resize(static_cast<size_t>(size - 1));
+                WideCharToMultiByte(CP_UTF8, 0, description, -1, name.data(), size, nullptr, nullptr);
+            }
+            LocalFree(description);
+        }
+        for (char& c : name) {
+            if (c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20) {
+                c = '_';
+            }
+        }
+        return name;
     }
 
     /**
-     * @brief Get current timestamp in ISO 8601 format for JSON content.
-     * @return Timestamp string like "2025-11-16T22:30:45"
+     * Returns the calling thread's buffer, registering it on first use.
      */
-    std::string GetTimestampISO8601() {
-        auto now = std::time(nullptr);
-        auto tm = *std::localtime(&now);
-        std::ostringstream oss;
-        oss << std::put_time(&tm, "%Y-%m-%dT%H:%M:%S");
-        return oss.str();
+    inline ThreadBuffer& LocalBuffer() {
+        thread_local ThreadBuffer* local = []() {
+            auto buffer = new ThreadBuffer();
+            buffer->threadID = GetCurrentThreadId();
+            buffer->threadName = CurrentThreadName();
+            buffer->next = bufferList.load(std::memory_order_relaxed);
+            while (!bufferList.compare_exchange_weak(buffer->next, buffer,
+                                                     std::memory_order_release, std::memory_order_relaxed)) {
+            }
+            return buffer;
+        }();
+        return *local;
     }
 
     /**
-     * @brief Escape string for JSON format.
-     * @param input Raw string
-     * @return JSON-escaped string
+     * @brief Append an event to the calling thread's buffer (no-op unless recording).
      */
-    std::string EscapeJSON(const std::string& input) {
-        std::ostringstream oss;
-        for (char c : input) {
-            switch (c) {
-            case '"':  oss << "\\\""; break;
-            case '\\': oss << "\\\\"; break;
-            case '\b': oss << "\\b"; break;
-            case '\f': oss << "\\f"; break;
-            case '\n': oss << "\\n"; break;
-            case '\r': oss << "\\r"; break;
-            case '\t': oss << "\\t"; break;
-            default:
-                if (c < 32) {
-                    oss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c);
-                } else {
-                    oss << c;
-                }
-            }
+    inline void Record(const Event& event) {
+        if (!recording.load(std::memory_order_relaxed)) {
+            return;
         }
-        return oss.str();
+
+        auto& buffer = LocalBuffer();
+        std::uint32_t current = session.load(std::memory_order_acquire);
+        if (buffer.session != current) {
+            buffer.session = current;
+            buffer.count.store(0, std::memory_order_relaxed);
+            buffer.dropped.store(0, std::memory_order_relaxed);
+            buffer.publishedSession.store(current, std::memory_order_release);
+        }
+
+        size_t index = buffer.count.load(std::memory_order_relaxed);
+        if (index >= kEventsPerThread) {
+            buffer.dropped.store(buffer.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return;
+        }
+        buffer.events[index] = event;
+        buffer.count.store(index + 1, std::memory_order_release);
     }
 
     /**
-     * @brief Unescape JSON string.
-     * @param input JSON-escaped string
-     * @return Unescaped string
+     * @brief Record a zero-duration marker.
      */
-    std::string UnescapeJSON(const std::string& input) {
-        std::string result;
-        result.reserve(input.size());
-        for (size_t i = 0; i < input.size(); ++i) {
-            if (input[i] == '\\' && i + 1 < input.size()) {
-                switch (input[i + 1]) {
-                case '"':  result += '"'; i++; break;
-                case '\\': result += '\\'; i++; break;
-                case 'b':  result += '\b'; i++; break;
-                case 'f':  result += '\f'; i++; break;
-                case 'n':  result += '\n'; i++; break;
-                case 'r':  result += '\r'; i++; break;
-                case 't':  result += '\t'; i++; break;
-                default: result += input[i]; break;
-                }
-            } else {
-                result += input[i];
-            }
+    inline void Instant(const char* name, const char* category) {
+        if (recording.load(std::memory_order_relaxed)) {
+            Record({ name, category, NowNs(), 0, 'i' });
         }
-        return result;
     }
 
     /**
-     * @brief Create directory if it doesn't exist.
-     * @param path Directory path to create
-     * @return true on success or if already exists
+     * @class Scope
+     * @brief Records the lifetime of the scope as a complete ('X') event.
+     *
+     * Costs one relaxed load when not recording.
      */
-    bool EnsureDirectoryExists(const std::string& path) {
-        try {
-            if (!fs::exists(path)) {
-                fs::create_directories(path);
-                spdlog::info("[BACKUP] Created directory: {}", path);
+    class Scope {
+    public:
+        Scope(const char* name, const char* category)
+            : name_(name), category_(category),
+              startNs_(recording.load(std::memory_order_relaxed) ? NowNs() : 0) {}
+
+        ~Scope() {
+            if (startNs_ != 0) {
+                Record({ name_, category_, startNs_, NowNs() - startNs_, 'X' });
             }
-            return true;
-        } catch (const fs::filesystem_error& e) {
-            spdlog::error("[BACKUP] Failed to create directory {}: {}", path, e.what());
-            return false;
         }
-    }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* name_;
+        const char* category_;
+        std::int64_t startNs_;
+    };
 
     /**
-     * @brief Export all notes to JSON file with timestamp.
-     * @return true on success, false on failure
+     * @brief Write the given session's events as Chrome Trace Event JSON.
+     * @return Path of the written file, empty on failure
      */
-    bool ExportNotesToJSON() {
-        auto mgr = NoteManager::GetSingleton();
-        auto notes = mgr->GetAllNotes();
+    inline std::string WriteSession(std::uint32_t sessionID, std::int64_t epoch) {
+        std::string json;
+        json.reserve(1 << 20);
+        json += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        json += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"PersonalNotes\"}}";
+
+        size_t eventCount = 0;
+        std::uint64_t droppedCount = 0;
+        for (auto buffer = bufferList.load(std::memory_order_acquire); buffer; buffer = buffer->next) {
+            if (buffer->publishedSession.load(std::memory_order_acquire) != sessionID) {
+                continue;
+            }
+            size_t count = buffer->count.load(std::memory_order_acquire);
+            droppedCount += buffer->dropped.load(std::memory_order_relaxed);
 
-        if (notes.empty()) {
-            RE::DebugNotification("No notes to export");
-            spdlog::warn("[BACKUP] No notes to export");
+            if (!buffer->threadName.empty()) {
+                fmt::format_to(std::back_inserter(json),
+                               ",\n{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}",
+                               buffer->threadID, buffer->threadName);
+            }
+
+            for (size_t i = 0; i < count; ++i) {
+                const Event& event = buffer->events[i];
+                double ts = static_cast<double>(event.startNs - epoch) / 1e3;
+                if (event.phase == 'X') {
+                    fmt::format_to(std::back_inserter(json),
+                                   ",\n{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":1,\"tid\":{}}}",
+                                   event.name, event.category, ts, static_cast<double>(event.durationNs) / 1e3, buffer->threadID);
+                } else {
+                    fmt::format_to(std::back_inserter(json),
+                                   ",\n{{\"name\":\"{}\",\"cat\":\"{}\",\"ph\":\"i\",\"s\":\"t\",\"ts\":{:.3f},\"pid\":1,\"tid\":{}}}",
+                                   event.name, event.category, ts, buffer->threadID);
+                }
+            }
+            eventCount += count;
+        }
+        json += "\n]}\n";
+
+        std::error_code ec;
+        std::filesystem::create_directories(Paths::TRACE_DIR, ec);
+        if (ec) {
+            spdlog::error("[TRACE] Failed to create directory {}: {}", Paths::TRACE_DIR, ec.message());
+            return {};
+        }
+
+        auto now = std::time(nullptr);
+        std::tm tm{};
+        localtime_s(&tm, &now);
+        std::ostringstream filename;
+        filename << Paths::TRACE_DIR << "/trace_" << std::put_time(&tm, "%Y%m%d_%H%M%S") << "_" << sessionID << ".json";
+        std::string path = filename.str();
+
+        std::ofstream file(path, std::ios::binary);
+        if (!file) {
+            spdlog::error("[TRACE] Failed to open {} for writing", path);
+            return {};
+        }
+        file.write(json.data(), static_cast<std::streamsize>(json.size()));
+
+        spdlog::info("[TRACE] Wrote {} events to {} ({} dropped)", eventCount, path, droppedCount);
+        return path;
+    }
+
+    /**
+     * @brief Start a recording session.
+     * @return false if already recording or the previous session is still being written
+     */
+    inline bool Start() {
+        if (flushing.load(std::memory_order_acquire) || recording.load(std::memory_order_relaxed)) {
             return false;
         }
+        epochNs.store(NowNs(), std::memory_order_relaxed);
+        session.fetch_add(1, std::memory_order_release);
+        recording.store(true, std::memory_order_release);
+        spdlog::info("[TRACE] Recording started");
+        return true;
+    }
 
-        // Ensure backup directory exists
-        if (!EnsureDirectoryExists(Paths::BACKUP_DIR)) {
-            RE::DebugNotification("Failed to create backup directory");
+    /**
+     * @brief Stop recording and write the trace file on a background worker.
+     * @return false if not recording
+     */
+    inline bool Stop() {
+        if (!recording.exchange(false, std::memory_order_acq_rel)) {
             return false;
         }
+        flushing.store(true, std::memory_order_release);
+
+        std::uint32_t sessionID = session.load(std::memory_order_relaxed);
+        std::int64_t epoch = epochNs.load(std::memory_order_relaxed);
+        JobSystem::GetSingleton()->Submit(JobPriority::kBackground, [sessionID, epoch]() {
+            bool written = !WriteSession(sessionID, epoch).empty();
+            flushing.store(false, std::memory_order_release);
+            JobSystem::RunOnMainThread([written]() {
+                RE::DebugNotification(written ? "Trace saved" : "Trace write failed");
+            });
+        });
+        return true;
+    }
 
-        // Get player name
-        std::string playerName = "Unknown";
-        auto player = RE::PlayerCharacter::GetSingleton();
-        if (player) {
-            const char* name = player->GetName();
-            if (name && name[0] != '\0') {
-                playerName = name;
+    /**
+     * @brief Write a still-running session synchronously when the plugin is unloaded.
+     *
+     * Same ordering requirement as Perf::LogSummariesOnExit(): call after SetupLog().
+     */
+    inline void FlushOnExit() {
+        struct ExitGuard {
+            ~ExitGuard() {
+                if (recording.exchange(false, std::memory_order_acq_rel)) {
+                    WriteSession(session.load(std::memory_order_relaxed), epochNs.load(std::memory_order_relaxed));
+                }
+            }
+        };
+        static ExitGuard guard;
+    }
+}
+
+//=============================================================================
+// Note Change Events
+//=============================================================================
+
+enum class NoteChangeKind : std::uint8_t {
+    kSaved,    // Note created or updated
+    kDeleted,  // Note removed
+    kReset     // Whole store replaced (load, revert, or lost events); questID is 0
+};
+
+/**
+ * Compact description of a committed change. Subscribers that need the text
+ * read it back from NoteManager.
+ */
+struct NoteChangeEvent {
+    RE::FormID questID = 0;
+    NoteChangeKind kind = NoteChangeKind::kReset;
+    std::uint64_t generation = 0;  // Store generation after the change
+};
+
+/**
+ * How a subscriber receives events.
+ * - kSync: called on the writing thread right after the lock is released (keep it cheap)
+ * - kQueued: pushed to a lock-free queue and drained on the main thread via the SKSE
+ *   task interface, once per burst of writes
+ */
+enum class NoteDelivery : std::uint8_t {
+    kSync,
+    kQueued
+};
+
+using NoteChangeCallback = std::function<void(const NoteChangeEvent&)>;
+
+/**
+ * @class NoteSubscription
+ * @brief One registered NoteManager subscriber.
+ *
+ * Queued subscriptions own a bounded MPSCQueue. If a writer finds it full the event is
+ * dropped and the subscriber gets a single kReset at the end of the next drain, so a
+ * slow consumer can never make a writer wait.
+ */
+class NoteSubscription : public std::enable_shared_from_this<NoteSubscription> {
+public:
+    static constexpr size_t kQueueCapacity = 256;
+
+    NoteSubscription(std::uint32_t id, std::string name, NoteDelivery delivery, NoteChangeCallback callback)
+        : id_(id), name_(std::move(name)), delivery_(delivery), callback_(std::move(callback)) {}
+
+    [[nodiscard]] std::uint32_t GetID() const { return id_; }
+
+    /**
+     * @brief Mark the subscription inactive (pending queued events are discarded).
+     */
+    void Cancel() {
+        active_.store(false, std::memory_order_release);
+    }
+
+    /**
+     * @brief Deliver an event (called on the writing thread).
+     */
+    void Deliver(const NoteChangeEvent& event) {
+        if (!active_.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        if (delivery_ == NoteDelivery::kSync) {
+            callback_(event);
+            return;
+        }
+
+        lastGeneration_.store(event.generation, std::memory_order_relaxed);
+        if (!queue_.TryPush(event)) {
+            overflowed_.store(true, std::memory_order_release);
+        }
+
+        // Schedule one drain per burst
+        if (!drainScheduled_.exchange(true, std::memory_order_acq_rel)) {
+            if (auto tasks = SKSE::GetTaskInterface()) {
+                tasks->AddTask([self = shared_from_this()]() { self->Drain(); });
+            } else {
+                drainScheduled_.store(false, std::memory_order_release);
             }
         }
+    }
 
-        // Sanitize player name for filename (remove invalid chars)
-        std::string safePlayerName = playerName;
-        for (char& c : safePlayerName) {
-            if (c == '\\' || c == '/' || c == ':' || c == '*' || c == '?' ||
-                c == '"' || c == '<' || c == '>' || c == '|' || c == ' ') {
-                c = '_';
+private:
+    /**
+     * Drains queued events on the main thread.
+     */
+    void Drain() {
+        // Clear first so writes racing with the drain schedule another pass
+        drainScheduled_.store(false, std::memory_order_release);
+
+        NoteChangeEvent event;
+        while (queue_.TryPop(event)) {
+            if (active_.load(std::memory_order_acquire)) {
+                callback_(event);
             }
         }
 
-        // Generate filename with player name and timestamp
-        std::string timestamp = GetTimestampForFilename();
-        std::string filename = std::string(Paths::BACKUP_DIR) + "/" + safePlayerName + "_notes_" + timestamp + ".json";
+        if (overflowed_.exchange(false, std::memory_order_acq_rel)) {
+            spdlog::warn("[EVENTS] Subscriber '{}' fell behind, sending reset", name_);
+            if (active_.load(std::memory_order_acquire)) {
+                callback_({ 0, NoteChangeKind::kReset, lastGeneration_.load(std::memory_order_relaxed) });
+            }
+        }
+    }
 
-        // Build JSON manually
-        std::ostringstream json;
-        json << "{\n";
-        json << "  \"exportDate\": \"" << GetTimestampISO8601() << "\",\n";
-        json << "  \"version\": \"1.0\",\n";
-        json << "  \"playerName\": \"" << EscapeJSON(playerName) << "\",\n";
-        json << "  \"noteCount\": " << notes.size() << ",\n";
-        json << "  \"notes\": [\n";
-
-        bool first = true;
-        for (const auto& [questID, note] : notes) {
-            if (!first) json << ",\n";
-            first = false;
+    std::uint32_t id_;
+    std::string name_;
+    NoteDelivery delivery_;
+    NoteChangeCallback callback_;
 
-            // Get quest name
-            std::string questName;
-            if (questID == NoteManager::GENERAL_NOTE_ID) {
-                questName = "General Note";
-            } else {
-                auto quest = RE::TESForm::LookupByID<RE::TESQuest>(questID);
-                questName = quest ? quest->GetName() : "Unknown Quest";
+    std::atomic<bool> active_{ true };
+    std::atomic<bool> drainScheduled_{ false };
+    std::atomic<bool> overflowed_{ false };
+    std::atomic<std::uint64_t> lastGeneration_{ 0 };
+    MPSCQueue<NoteChangeEvent, kQueueCapacity> queue_;
+};
+
+//=============================================================================
+// Settings Manager
+//=============================================================================
+
+/**
+ * @class SettingsManager
+ * @brief Manages plugin configuration loaded from INI file.
+ *
+ * Loads and validates settings from Data/SKSE/Plugins/PersonalNotes.ini
+ * including UI positioning, text formatting, and hotkey configuration.
+ * All loaded values are clamped to reasonable ranges.
+ */
+class SettingsManager {
+public:
+    /**
+     * @brief Get the singleton instance.
+     * @return Pointer to singleton instance (never null)
+     */
+    static SettingsManager* GetSingleton() {
+        static SettingsManager instance;
+        return &instance;
+    }
+
+    /**
+     * @brief Load and validate settings from INI file.
+     *
+     * Reads configuration from Data/SKSE/Plugins/PersonalNotes.ini and
+     * clamps all values to valid ranges (e.g., font sizes 8-72, positions within 4K bounds).
+     */
+    void LoadSettings() {
+        constexpr auto path = L"Data/SKSE/Plugins/PersonalNotes.ini";
+
+        // Flush Windows INI cache to ensure we read the latest file (dMenu may have modified it)
+        WritePrivateProfileStringW(nullptr, nullptr, nullptr, path);
+
+        // Check for UTF-8 BOM and remove it if present (dMenu may write with BOM)
+        {
+            std::ifstream iniFile("Data/SKSE/Plugins/PersonalNotes.ini", std::ios::binary);
+            if (iniFile) {
+                unsigned char bytes[3];
+                iniFile.read(reinterpret_cast<char*>(bytes), 3);
+
+                // Check for UTF-8 BOM (EF BB BF)
+                if (iniFile.gcount() >= 3 && bytes[0] == 0xEF && bytes[1] == 0xBB && bytes[2] == 0xBF) {
+                    // Read rest of file
+                    std::string content((std::istreambuf_iterator<char>(iniFile)), std::istreambuf_iterator<char>());
+                    iniFile.close();
+
+                    // Write back without BOM
+                    std::ofstream outFile("Data/SKSE/Plugins/PersonalNotes.ini", std::ios::binary);
+                    if (outFile) {
+                        outFile.write(content.c_str(), content.size());
+                        outFile.close();
+                        spdlog::info("[SETTINGS] Removed UTF-8 BOM from INI file");
+
+                        // Flush cache after rewriting
+                        WritePrivateProfileStringW(nullptr, nullptr, nullptr, path);
+                    }
+                }
+            }
+        }
+
+        // Helper to read number from INI (handles both int and float formats from dMenu)
+        // dMenu writes integers as floats (e.g., "500.000000"), so we read as float and convert
+        auto ReadNumber = [](const wchar_t* section, const wchar_t* key, float defaultValue, const wchar_t* iniPath) -> float {
+            wchar_t buffer[32];
+            GetPrivateProfileStringW(section, key, L"", buffer, 32, iniPath);
+            if (buffer[0] == L'\0') {
+                return defaultValue;
+            }
+            return std::wcstof(buffer, nullptr);
+        };
+
+        // TextField
+        textFieldX = ReadNumber(L"TextField", L"fPositionX", 5.0f, path);
+        textFieldY = ReadNumber(L"TextField", L"fPositionY", 5.0f, path);
+        textFieldFontSize = static_cast<int>(ReadNumber(L"TextField", L"iFontSize", 20.0f, path));
+        textFieldColor = static_cast<int>(ReadNumber(L"TextField", L"iTextColor", 16777215.0f, path));
+        noteBadges = ReadNumber(L"TextField", L"bNoteBadges", 1.0f, path) != 0.0f;
+        previewLines = static_cast<int>(ReadNumber(L"TextField", L"iPreviewLines", 3.0f, path));
+        previewWidth = static_cast<int>(ReadNumber(L"TextField", L"iPreviewWidth", 600.0f, path));
+
+        // TextInput
+        textInputWidth = static_cast<int>(ReadNumber(L"TextInput", L"iWidth", 500.0f, path));
+        textInputHeight = static_cast<int>(ReadNumber(L"TextInput", L"iHeight", 400.0f, path));
+        textInputFontSize = static_cast<int>(ReadNumber(L"TextInput", L"iFontSize", 14.0f, path));
+        textInputAlignment = static_cast<int>(ReadNumber(L"TextInput", L"iAlignment", 0.0f, path));
+
+        // Editor
+        nativeEditor = ReadNumber(L"Editor", L"bNativeEditor", 1.0f, path) != 0.0f;
+
+        // Hotkey
+        noteHotkeyScanCode = static_cast<int>(ReadNumber(L"Hotkey", L"iScanCode", 51.0f, path));
+        quickAccessScanCode = static_cast<int>(ReadNumber(L"Hotkey", L"iQuickAccessScanCode", 52.0f, path));
+        noteHotkeyModifiers = static_cast<int>(ReadNumber(L"Hotkey", L"iModifiers", 0.0f, path));
+        quickAccessModifiers = static_cast<int>(ReadNumber(L"Hotkey", L"iQuickAccessModifiers", 0.0f, path));
+        noteGamepadButton = static_cast<int>(ReadNumber(L"Hotkey", L"iGamepadButton", 0.0f, path));
+        quickAccessGamepadButton = static_cast<int>(ReadNumber(L"Hotkey", L"iQuickAccessGamepadButton", 0.0f, path));
+
+        // Validate and clamp loaded values to reasonable ranges
+        textFieldX = std::clamp(textFieldX, 0.0f, 3840.0f);      // Max 4K width
+        textFieldY = std::clamp(textFieldY, 0.0f, 2160.0f);      // Max 4K height
+        textFieldFontSize = std::clamp(textFieldFontSize, 8, 72);
+        // textFieldColor: allow any value (0x000000 to 0xFFFFFF valid)
+        previewLines = std::clamp(previewLines, 0, 10);        // 0 = status line only
+        previewWidth = std::clamp(previewWidth, 100, 3840);
+
+        textInputWidth = std::clamp(textInputWidth, 200, 3840);
+        textInputHeight = std::clamp(textInputHeight, 100, 2160);
+        textInputFontSize = std::clamp(textInputFontSize, 8, 72);
+        textInputAlignment = std::clamp(textInputAlignment, 0, 2);  // 0=left, 1=center, 2=right
+
+        noteHotkeyScanCode = std::clamp(noteHotkeyScanCode, 0, 281);  // Keyboard, mouse or gamepad key code
+        quickAccessScanCode = std::clamp(quickAccessScanCode, 0, 281);  // Keyboard, mouse or gamepad key code
+        noteHotkeyModifiers = std::clamp(noteHotkeyModifiers, 0, 7);    // 1=Shift, 2=Ctrl, 4=Alt
+        quickAccessModifiers = std::clamp(quickAccessModifiers, 0, 7);
+        noteGamepadButton = std::clamp(noteGamepadButton, 0, 281);      // 266-281 = gamepad, 0 = none
+        quickAccessGamepadButton = std::clamp(quickAccessGamepadButton, 0, 281);
+
+        // Backup
+        backupKeepPerCharacter = static_cast<int>(ReadNumber(L"Backup", L"iKeepPerCharacter", 0.0f, path));
+        backupMaxTotalMB = static_cast<int>(ReadNumber(L"Backup", L"iMaxTotalMB", 0.0f, path));
+        backupIncremental = ReadNumber(L"Backup", L"bIncremental", 0.0f, path) != 0.0f;
+        backupFullEvery = static_cast<int>(ReadNumber(L"Backup", L"iFullEvery", 10.0f, path));
+        autoBackup = ReadNumber(L"Backup", L"bAutoBackup", 0.0f, path) != 0.0f;
+        backupBinary = ReadNumber(L"Backup", L"bBinary", 0.0f, path) != 0.0f;
+        autoBackupMinutes = static_cast<int>(ReadNumber(L"Backup", L"iAutoBackupMinutes", 10.0f, path));
+        backupKeepPerCharacter = std::clamp(backupKeepPerCharacter, 0, 1000);  // 0 = keep all
+        backupMaxTotalMB = std::clamp(backupMaxTotalMB, 0, 10240);            // 0 = no size cap
+        backupFullEvery = std::clamp(backupFullEvery, 1, 100);                // 1 = every export is full
+        autoBackupMinutes = std::clamp(autoBackupMinutes, 1, 1440);
+
+        // Debug
+        perfOverlay = ReadNumber(L"Debug", L"bPerfOverlay", 0.0f, path) != 0.0f;
+        traceOnStartup = ReadNumber(L"Debug", L"bTrace", 0.0f, path) != 0.0f;
+
+        // Update last modified timestamp
+        UpdateTimestamp();
+        generation_.fetch_add(1, std::memory_order_release);
+
+        spdlog::info("[SETTINGS] Loaded from INI");
+    }
+
+    /**
+     * @brief Load settings on a job worker so plugin init does not wait on INI I/O.
+     *
+     * Nothing reads settings before kDataLoaded, which calls WaitUntilLoaded() first.
+     */
+    void LoadSettingsAsync() {
+        auto promise = std::make_shared<std::promise<void>>();
+        loaded_ = promise->get_future().share();
+        JobSystem::GetSingleton()->Submit(JobPriority::kUICritical, [this, promise]() {
+            LoadSettings();
+            promise->set_value();
+        });
+    }
+
+    /**
+     * @brief Block until a pending LoadSettingsAsync() has finished.
+     */
+    void WaitUntilLoaded() const {
+        if (loaded_.valid()) {
+            loaded_.wait();
+        }
+    }
+
+    /**
+     * @brief Incremented after every (re)load; lets dependents rebuild derived state.
+     */
+    [[nodiscard]] std::uint32_t GetGeneration() const {
+        return generation_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Reload settings if INI file has been modified.
+     * @return True if settings were reloaded, false if no change detected.
+     *
+     * Checks if PersonalNotes.ini has been modified since last load.
+     * If modified, reloads all settings. Used for runtime config changes via dMenu.
+     */
+    bool ReloadIfChanged() {
+        namespace fs = std::filesystem;
+
+        try {
+            fs::path iniPath = "Data/SKSE/Plugins/PersonalNotes.ini";
+
+            if (!fs::exists(iniPath)) {
+                return false;
             }
 
-            json << "    {\n";
-            json << "      \"questID\": " << questID << ",\n";
-            json << "      \"questName\": \"" << EscapeJSON(questName) << "\",\n";
-            json << "      \"text\": \"" << EscapeJSON(note.text) << "\",\n";
-            json << "      \"timestamp\": " << note.timestamp << "\n";
-            json << "    }";
+            auto currentTimestamp = fs::last_write_time(iniPath);
+
+            if (currentTimestamp != lastModifiedTime_) {
+                spdlog::info("[SETTINGS] INI changed, reloading");
+                LoadSettings();
+                return true;
+            }
+        } catch (const std::exception& e) {
+            spdlog::warn("[SETTINGS] Failed to check INI timestamp: {}", e.what());
         }
 
-        json << "\n  ]\n";
-        json << "}\n";
+        return false;
+    }
+
+    // TextField
+    float textFieldX = 5.0f;
+    float textFieldY = 5.0f;
+    int textFieldFontSize = 20;
+    int textFieldColor = 0xFFFFFF;
+    bool noteBadges = true;  // Mark quests with a note in the Journal quest list
+    int previewLines = 3;    // Note lines shown under the status line in the Journal
+    int previewWidth = 600;  // Journal TextField width; previews are wrapped to it
+
+    // TextInput
+    int textInputWidth = 500;
+    int textInputHeight = 400;
+    int textInputFontSize = 14;
+    int textInputAlignment = 0;
+
+    // Editor
+    bool nativeEditor = true;  // Use NoteEditor (if its movie is installed) instead of the Papyrus dialogs
+
+    // Hotkey
+    int noteHotkeyScanCode = 51;
+    int quickAccessScanCode = 52;  // dot key
+    int noteHotkeyModifiers = 0;   // KeyModifiers mask required with noteHotkeyScanCode
+    int quickAccessModifiers = 0;  // KeyModifiers mask required with quickAccessScanCode
+    int noteGamepadButton = 0;     // Extra binding, usually a gamepad key code (266-281); 0 = none
+    int quickAccessGamepadButton = 0;
+
+    // Backup
+    int backupKeepPerCharacter = 0;  // Newest exports kept per character; 0 = keep all (opt-in: deletes files)
+    int backupMaxTotalMB = 0;        // Size cap for the whole backup folder; 0 = none
+    bool backupIncremental = false;   // Write only changes since the previous export
+    int backupFullEvery = 10;         // Exports per chain (one full + incrementals)
+    bool autoBackup = false;          // Export on game save (throttled)
+    bool backupBinary = false;        // Write full backups in NoteBackupFormat (.pnb) instead of JSON
+    int autoBackupMinutes = 10;       // Minimum time between automatic exports
+
+    // Debug
+    bool perfOverlay = false;     // Show hot-path timings in the HUD
+    bool traceOnStartup = false;  // Start a Trace session once game data is loaded
+
+private:
+    SettingsManager() = default;
+
+    /**
+     * @brief Update timestamp from INI file.
+     *
+     * Records the last modified time of PersonalNotes.ini for change detection.
+     */
+    void UpdateTimestamp() {
+        namespace fs = std::filesystem;
+
+        try {
+            fs::path iniPath = "Data/SKSE/Plugins/PersonalNotes.ini";
+
+            if (fs::exists(iniPath)) {
+                lastModifiedTime_ = fs::last_write_time(iniPath);
+            }
+        } catch (const std::exception& e) {
+            spdlog::warn("[SETTINGS] Failed to update INI timestamp: {}", e.what());
+        }
+    }
+
+    // INI file timestamp for change detection
+    std::filesystem::file_time_type lastModifiedTime_;
+
+    std::shared_future<void> loaded_;  // Pending initial load (LoadSettingsAsync)
+    std::atomic<std::uint32_t> generation_{ 0 };
+};
+
+//=============================================================================
+// Note Manager
+//=============================================================================
+
+/**
+ * @class NoteManager
+ * @brief Thread-safe manager for quest and general notes with SKSE serialization.
+ *
+ * Manages a collection of notes indexed by quest FormID. Thread-safe for
+ * concurrent read/write operations using shared_mutex. Notes are persisted
+ * across game sessions via SKSE co-save system.
+ *
+ * Every committed change is published as a NoteChangeEvent to registered
+ * subscribers (journal overlay, plugin API, ...), so writers don't need to know
+ * who consumes their changes.
+ *
+ * @note Uses FormID 0xFFFFFFFF (GENERAL_NOTE_ID) for general notes not tied to specific quests.
+ * @thread_safety All public methods are thread-safe.
+ */
+class NoteManager {
+public:
+    static constexpr std::uint32_t kDataKey = 'PNOT';  // PersonalNOTes
+    static constexpr std::uint32_t kSerializationVersion = 3;
+    static constexpr RE::FormID GENERAL_NOTE_ID = 0xFFFFFFFF;  // Special ID for general notes
+
+    /**
+     * @brief Get the singleton instance.
+     * @return Pointer to singleton instance (never null, valid for program lifetime)
+     */
+    static NoteManager* GetSingleton() {
+        static NoteManager instance;
+        return &instance;
+    }
+
+    /**
+     * @brief Retrieves note text for a specific quest.
+     * @param questID The quest's FormID (use GENERAL_NOTE_ID for general notes)
+     * @return Note text if exists, empty string otherwise
+     * @thread_safety Thread-safe (uses shared lock)
+     */
+    [[nodiscard]] std::string GetNoteForQuest(RE::FormID questID) const {
+        std::shared_lock lock(lock_);
+
+        if (auto it = notesByQuest_.find(questID); it != notesByQuest_.end()) {
+            return std::string(it->second.text);
+        }
+        return "";
+    }
+
+    /**
+     * @brief Saves or updates a note for a quest.
+     * @param questID The quest's FormID (0 is invalid, GENERAL_NOTE_ID for general notes)
+     * @param text Note text to save (empty string deletes the note)
+     * @thread_safety Thread-safe (uses unique lock)
+     * @note Input is validated and sanitized before storage
+     */
+    void SaveNoteForQuest(RE::FormID questID, const std::string& text) {
+        // Validate FormID
+        if (questID == 0) {
+            spdlog::warn("[NOTE] Invalid quest ID: 0");
+            return;
+        }
+
+        // Validate quest exists (except for GENERAL_NOTE_ID)
+        if (questID != GENERAL_NOTE_ID) {
+            auto quest = RE::TESForm::LookupByID<RE::TESQuest>(questID);
+            if (!quest) {
+                spdlog::warn("[NOTE] Quest 0x{:X} not found, saving note anyway", questID);
+                // Allow saving anyway - quest might be from another plugin
+            }
+        }
+
+        NoteChangeEvent event{};
+        {
+            std::unique_lock lock(lock_);
+
+            if (text.empty()) {
+                // Empty text = delete note
+                if (!EraseNoteLocked(questID)) {
+                    return;  // Nothing to delete, nothing changed
+                }
+                event = { questID, NoteChangeKind::kDeleted, ++generation_ };
+            } else {
+                // Sanitize input text before storage
+                std::string sanitizedText = NoteUtils::SanitizeNoteText(text);
+
+                WriteNoteLocked(questID, sanitizedText);
+                event = { questID, NoteChangeKind::kSaved, ++generation_ };
+            }
+        }
+
+        Publish(event);
+    }
+
+    /**
+     * @brief Applies several writes under a single unique lock.
+     * @param writes (questID, text) pairs; empty text deletes the note
+     * @return Number of writes applied (entries with FormID 0 are skipped)
+     * @thread_safety Thread-safe (uses unique lock once for the whole batch)
+     * @note Input is sanitized like SaveNoteForQuest. Quests are not looked up, so batches
+     *       from other plugins don't pay for form lookups or per-note log lines.
+     */
+    size_t SaveNotes(std::span<const std::pair<RE::FormID, std::string_view>> writes) {
+        std::vector<NoteChangeEvent> events;
+        events.reserve(writes.size());
+        size_t applied = 0;
+
+        {
+            std::unique_lock lock(lock_);
+
+            for (const auto& [questID, text] : writes) {
+                if (questID == 0) {
+                    spdlog::warn("[NOTE] Invalid quest ID in batch: 0");
+                    continue;
+                }
+                applied++;
+
+                if (text.empty()) {
+                    if (EraseNoteLocked(questID)) {
+                        events.push_back({ questID, NoteChangeKind::kDeleted, ++generation_ });
+                    }
+                } else {
+                    WriteNoteLocked(questID, NoteUtils::SanitizeNoteText(std::string(text)));
+                    events.push_back({ questID, NoteChangeKind::kSaved, ++generation_ });
+                }
+            }
+        }
+
+        for (const auto& event : events) {
+            Publish(event);
+        }
+        return applied;
+    }
+
+    /**
+     * @brief Checks if a note exists for a quest.
+     * @param questID The quest's FormID
+     * @return true if note exists, false otherwise
+     * @thread_safety Thread-safe (uses shared lock)
+     */
+    [[nodiscard]] bool HasNoteForQuest(RE::FormID questID) const {
+        std::shared_lock lock(lock_);
+        return notesByQuest_.find(questID) != notesByQuest_.end();
+    }
+
+    /**
+     * @brief Batched HasNoteForQuest: answers a whole list under one shared lock.
+     * @param questIDs Quests to look up
+     * @param out Receives one flag per quest, in the same order (sized like questIDs)
+     * @thread_safety Thread-safe (uses shared lock)
+     */
+    void HasNotes(std::span<const RE::FormID> questIDs, std::span<bool> out) const {
+        std::shared_lock lock(lock_);
+        for (size_t i = 0; i < questIDs.size() && i < out.size(); ++i) {
+            out[i] = notesByQuest_.find(questIDs[i]) != notesByQuest_.end();
+        }
+    }
+
+    /**
+     * @brief Deletes a note for a quest.
+     * @param questID The quest's FormID
+     * @thread_safety Thread-safe (uses unique lock)
+     */
+    void DeleteNoteForQuest(RE::FormID questID) {
+        NoteChangeEvent event{};
+        {
+            std::unique_lock lock(lock_);
+            if (!EraseNoteLocked(questID)) {
+                return;
+            }
+            event = { questID, NoteChangeKind::kDeleted, ++generation_ };
+        }
+
+        Publish(event);
+    }
+
+    /**
+     * @brief Run a visitor against a single note without copying it.
+     * @param questID The quest's FormID
+     * @param visitor Callable taking const Note&, invoked while the shared lock is held
+     * @return true if the note exists and the visitor ran, false otherwise
+     * @thread_safety Thread-safe (uses shared lock). The visitor must not call back into NoteManager.
+     */
+    template <class Visitor>
+    bool VisitNote(RE::FormID questID, Visitor&& visitor) const {
+        std::shared_lock lock(lock_);
+
+        if (auto it = notesByQuest_.find(questID); it != notesByQuest_.end()) {
+            visitor(it->second);
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Get a page of note FormIDs in ascending FormID order.
+     * @param offset Index of the first ID to return
+     * @param count Maximum number of IDs to return
+     * @return Up to count FormIDs starting at offset (empty if offset is past the end)
+     * @thread_safety Thread-safe (uses shared lock)
+     */
+    [[nodiscard]] std::vector<RE::FormID> GetNoteIDs(size_t offset, size_t count) const {
+        std::shared_lock lock(lock_);
+
+        if (offset >= index_.size()) {
+            return {};
+        }
+        auto first = index_.begin() + offset;
+        auto last = first + std::min(count, index_.size() - offset);
+
+        std::vector<RE::FormID> result;
+        result.reserve(static_cast<size_t>(last - first));
+        for (auto it = first; it != last; ++it) {
+            result.push_back(it->questID);
+        }
+        return result;
+    }
+
+    /**
+     * @brief Get FormIDs of notes written at or after a timestamp.
+     * @param since Unix timestamp (seconds)
+     * @return Matching FormIDs in ascending FormID order
+     * @thread_safety Thread-safe (uses shared lock)
+     */
+    [[nodiscard]] std::vector<RE::FormID> GetNoteIDsModifiedSince(std::time_t since) const {
+        std::shared_lock lock(lock_);
+
+        std::vector<RE::FormID> result;
+        for (const auto& entry : index_) {
+            if (entry.modified >= since) {
+                result.push_back(entry.questID);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Get general note (not tied to any quest).
+     * @return General note text, empty if none
+     * @thread_safety Thread-safe
+     */
+    [[nodiscard]] std::string GetGeneralNote() const {
+        return GetNoteForQuest(GENERAL_NOTE_ID);
+    }
+
+    /**
+     * @brief Save general note (not tied to any quest).
+     * @param text Note text to save
+     * @thread_safety Thread-safe
+     */
+    void SaveGeneralNote(const std::string& text) {
+        SaveNoteForQuest(GENERAL_NOTE_ID, text);
+    }
+
+    /**
+     * @brief Get all notes as a map.
+     * @return Copy of all notes indexed by quest FormID
+     * @warning Returns a copy - expensive for large note collections
+     * @thread_safety Thread-safe (uses shared lock)
+     */
+    [[nodiscard]] NoteMap GetAllNotes() const {
+        std::shared_lock lock(lock_);
+        return notesByQuest_;
+    }
+
+    /**
+     * @brief Get total number of notes.
+     * @return Count of all stored notes
+     * @thread_safety Thread-safe (uses shared lock)
+     */
+    [[nodiscard]] size_t GetNoteCount() const {
+        std::shared_lock lock(lock_);
+        return notesByQuest_.size();
+    }
+
+    /**
+     * @brief Register a change subscriber.
+     * @param name Subscriber name (for logging)
+     * @param delivery kSync for cheap callbacks, kQueued for anything expensive or main-thread only
+     * @param callback Invoked once per committed change
+     * @return Subscription ID for Unsubscribe()
+     * @thread_safety Thread-safe
+     */
+    std::uint32_t Subscribe(std::string name, NoteDelivery delivery, NoteChangeCallback callback) {
+        std::lock_guard lock(subscribersLock_);
+
+        std::uint32_t id = nextSubscriptionID_++;
+        auto updated = std::make_shared<SubscriberList>(*subscribers_.load());
+        updated->push_back(std::make_shared<NoteSubscription>(id, std::move(name), delivery, std::move(callback)));
+        subscribers_.store(std::move(updated));
+        return id;
+    }
+
+    /**
+     * @brief Remove a change subscriber.
+     * @param id Subscription ID returned by Subscribe()
+     * @note A sync callback already running on another thread may still complete after this returns.
+     * @thread_safety Thread-safe
+     */
+    void Unsubscribe(std::uint32_t id) {
+        std::lock_guard lock(subscribersLock_);
+
+        auto updated = std::make_shared<SubscriberList>(*subscribers_.load());
+        std::erase_if(*updated, [id](const std::shared_ptr<NoteSubscription>& subscription) {
+            if (subscription->GetID() == id) {
+                subscription->Cancel();
+                return true;
+            }
+            return false;
+        });
+        subscribers_.store(std::move(updated));
+    }
+
+    /**
+     * @brief Get the store generation (incremented on every change).
+     * @return Current generation
+     * @thread_safety Thread-safe (lock-free)
+     */
+    [[nodiscard]] std::uint64_t GetGeneration() const {
+        return generation_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Get an immutable snapshot of all notes, sorted by FormID.
+     * @return Shared snapshot; reused as-is while the generation is unchanged
+     * @thread_safety Thread-safe (uses shared lock only when the snapshot must be rebuilt)
+     */
+    [[nodiscard]] std::shared_ptr<const NoteSnapshot> GetSnapshot() const {
+        {
+            std::lock_guard cacheLock(snapshotLock_);
+            if (snapshot_ && snapshot_->generation == GetGeneration()) {
+                return snapshot_;
+            }
+        }
+
+        auto snapshot = std::make_shared<NoteSnapshot>();
+        {
+            std::shared_lock lock(lock_);
+            snapshot->generation = generation_.load(std::memory_order_relaxed);
+            snapshot->notes.reserve(notesByQuest_.size());
+            for (const auto& [questID, note] : notesByQuest_) {
+                snapshot->notes.push_back(note);
+            }
+        }
+        std::sort(snapshot->notes.begin(), snapshot->notes.end(),
+                  [](const Note& a, const Note& b) { return a.questID < b.questID; });
+
+        std::lock_guard cacheLock(snapshotLock_);
+        if (!snapshot_ || snapshot_->generation < snapshot->generation) {
+            snapshot_ = snapshot;
+        }
+        return snapshot;
+    }
+
+    void Save(SKSE::SerializationInterface* intfc) {
+        Perf::ScopedTimer timer(Perf::Probe::kSave);
+        Trace::Scope trace("NoteManager::Save", "serialization");
+        std::shared_lock lock(lock_);
+
+        // Write note count
+        std::uint32_t count = static_cast<std::uint32_t>(notesByQuest_.size());
+        if (!intfc->WriteRecordData(&count, sizeof(count))) {
+            spdlog::error("[SAVE] Failed to write note count");
+            return;
+        }
+
+        // Write each note
+        for (const auto& [questID, note] : notesByQuest_) {
+            if (!note.Save(intfc)) {
+                spdlog::error("[SAVE] Failed to write note for quest 0x{:X}", questID);
+                return;
+            }
+        }
+
+        spdlog::info("[SAVE] Saved {} notes (version {})", count, kSerializationVersion);
+    }
+
+    void Load(SKSE::SerializationInterface* intfc) {
+        Perf::ScopedTimer timer(Perf::Probe::kLoad);
+        Trace::Scope trace("NoteManager::Load", "serialization");
+        NoteChangeEvent event{};
+        {
+            std::unique_lock lock(lock_);
+            notesByQuest_.clear();
+            index_.clear();
+
+            std::uint32_t type;
+            std::uint32_t version;
+            std::uint32_t length;
+
+            while (intfc->GetNextRecordInfo(type, version, length)) {
+                if (type == kDataKey) {
+                    if (version == 1) {
+                        spdlog::warn("[LOAD] Version 1 save data found (expected v{}). Legacy format not compatible. Skipping.", kSerializationVersion);
+                        continue;
+                    }
+                    if (version > kSerializationVersion) {
+                        spdlog::warn("[LOAD] Unknown save version: {} (expected v{}). Skipping.", version, kSerializationVersion);
+                        continue;
+                    }
+
+                    LoadNotesData(intfc, version);
+                }
+            }
+
+            event = { 0, NoteChangeKind::kReset, ++generation_ };
+        }
+
+        Publish(event);
+    }
+
+    void LoadNotesData(SKSE::SerializationInterface* intfc, std::uint32_t version) {
+        // Read note count
+        std::uint32_t count = 0;
+        if (!intfc->ReadRecordData(&count, sizeof(count))) {
+            spdlog::error("[LOAD] Failed to read note count");
+            return;  // Now safe - won't break record iteration
+        }
+
+        std::uint32_t loadedCount = 0;
+        std::uint32_t failedCount = 0;
+
+        // Read each note
+        for (std::uint32_t i = 0; i < count; ++i) {
+            Note note;
+            if (note.Load(intfc, version)) {
+                InsertNoteLocked(std::move(note));
+                loadedCount++;
+            } else {
+                spdlog::error("[LOAD] Failed to load note {}/{}", i + 1, count);
+                failedCount++;
+                // Continue loading remaining notes instead of failing completely
+            }
+        }
+
+        if (failedCount > 0) {
+            spdlog::warn("[LOAD] Loaded {}/{} notes successfully ({} failed, version {})",
+                         loadedCount, count, failedCount, version);
+        } else {
+            spdlog::info("[LOAD] Loaded {}/{} notes successfully (version {})", loadedCount, count, version);
+        }
+    }
+
+    /**
+     * @brief Last-writer-wins merge of notes from elsewhere (import).
+     * @param incoming Notes sorted by ascending FormID, at most one per FormID; winners are moved from
+     * @return Number of notes written
+     * @thread_safety Thread-safe (uses unique lock)
+     *
+     * One sorted-run merge of incoming against the index: conflicts are decided from
+     * the index's modification times, so only winning notes touch the hash map. An
+     * incoming note wins if it is newer or missing locally; ties keep the local note.
+     * Winners keep their own created/modified times.
+     */
+    size_t MergeNotes(std::span<Note> incoming) {
+        std::vector<NoteChangeEvent> events;
+        {
+            std::unique_lock lock(lock_);
+
+            Index merged;
+            merged.reserve(index_.size() + incoming.size());
+            auto local = index_.begin();
+
+            for (Note& note : incoming) {
+                if (note.questID == 0 || note.text.empty()) {
+                    continue;
+                }
+                while (local != index_.end() && local->questID < note.questID) {
+                    merged.push_back(*local++);
+                }
+
+                bool exists = local != index_.end() && local->questID == note.questID;
+                if (exists && local->modified >= note.modified) {
+                    merged.push_back(*local++);  // Local note is as new or newer
+                    continue;
+                }
+                if (exists) {
+                    ++local;
+                }
+
+                RE::FormID questID = note.questID;
+                merged.push_back({ questID, note.modified });
+                notesByQuest_.insert_or_assign(questID, std::move(note));
+                events.push_back({ questID, NoteChangeKind::kSaved, ++generation_ });
+            }
+
+            merged.insert(merged.end(), local, index_.end());
+            index_ = std::move(merged);
+        }
+
+        for (const auto& event : events) {
+            Publish(event);
+        }
+        return events.size();
+    }
+
+    void Revert(SKSE::SerializationInterface*) {
+        // Clear RAM when starting new game (prevents note leakage between different characters)
+        NoteChangeEvent event{};
+        {
+            std::unique_lock lock(lock_);
+            notesByQuest_.clear();
+            index_.clear();
+            event = { 0, NoteChangeKind::kReset, ++generation_ };
+        }
+        spdlog::info("[REVERT] Cleared notes from RAM (new game started)");
+
+        Publish(event);
+    }
+
+private:
+    using SubscriberList = std::vector<std::shared_ptr<NoteSubscription>>;
+
+    NoteManager() = default;
+
+    /**
+     * Publishes a committed change to all subscribers.
+     * Must be called without holding lock_ so subscribers may read back.
+     */
+    void Publish(const NoteChangeEvent& event) const {
+        auto current = subscribers_.load();
+        for (const auto& subscription : *current) {
+            subscription->Deliver(event);
+        }
+    }
+
+    /**
+     * Sorted index entry: FormID order plus the modification time, so ordered walks
+     * (paging, modified-since queries, merges) never touch the hash map.
+     */
+    struct IndexEntry {
+        RE::FormID questID;
+        std::time_t modified;
+    };
+
+    using Index = MemStats::Vector<IndexEntry, MemStats::Subsystem::kNotes>;
+
+    Index::iterator FindIndexLocked(RE::FormID questID) {
+        return std::lower_bound(index_.begin(), index_.end(), questID,
+            [](const IndexEntry& entry, RE::FormID id) { return entry.questID < id; });
+    }
+
+    /**
+     * Inserts or replaces a note, keeping index_ in sync.
+     * Caller must hold the unique lock.
+     */
+    void InsertNoteLocked(Note&& note) {
+        RE::FormID questID = note.questID;
+        std::time_t modified = note.modified;
+        notesByQuest_.insert_or_assign(questID, std::move(note));
+
+        auto it = FindIndexLocked(questID);
+        if (it != index_.end() && it->questID == questID) {
+            it->modified = modified;
+        } else {
+            index_.insert(it, { questID, modified });
+        }
+    }
+
+    /**
+     * Writes new text for a note now, keeping its created time if it already exists.
+     * Caller must hold the unique lock.
+     */
+    void WriteNoteLocked(RE::FormID questID, std::string_view text) {
+        Note note(text, questID);
+        if (auto it = notesByQuest_.find(questID); it != notesByQuest_.end()) {
+            note.created = it->second.created;
+        }
+        InsertNoteLocked(std::move(note));
+    }
+
+    /**
+     * Erases a note, keeping index_ in sync.
+     * Caller must hold the unique lock.
+     * @return true if a note was erased
+     */
+    bool EraseNoteLocked(RE::FormID questID) {
+        if (notesByQuest_.erase(questID) == 0) {
+            return false;
+        }
+        auto it = FindIndexLocked(questID);
+        if (it != index_.end() && it->questID == questID) {
+            index_.erase(it);
+        }
+        return true;
+    }
+
+    NoteMap notesByQuest_;
+    Index index_;  // Ascending FormIDs of notesByQuest_ (stable paging order) with modification times
+    mutable std::shared_mutex lock_;
+
+    std::atomic<std::uint64_t> generation_{ 0 };  // Bumped under unique lock on every change
+
+    mutable std::shared_ptr<const NoteSnapshot> snapshot_;  // Last snapshot handed out
+    mutable std::mutex snapshotLock_;
+
+    // Copy-on-write subscriber list: Publish() is a lock-free load
+    std::atomic<std::shared_ptr<const SubscriberList>> subscribers_{ std::make_shared<const SubscriberList>() };
+    std::uint32_t nextSubscriptionID_ = 1;
+    std::mutex subscribersLock_;  // Serializes Subscribe/Unsubscribe
+};
+
+//=============================================================================
+// Quest Name Cache
+//=============================================================================
+
+/**
+ * @class QuestNameCache
+ * @brief Caches display names of quests that have notes.
+ *
+ * Saves a form lookup and name copy per note when building the quick access
+ * list or an export. After a load the whole cache is refreshed incrementally by
+ * the FrameScheduler, which also reports notes whose quest no longer exists.
+ *
+ * @thread_safety All public methods are thread-safe.
+ */
+class QuestNameCache {
+public:
+    static constexpr const char* GENERAL_NOTE_NAME = "General Note";
+    static constexpr const char* UNKNOWN_QUEST_NAME = "Unknown Quest";
+
+    /**
+     * @brief Get the singleton instance.
+     * @return Pointer to singleton instance (never null)
+     */
+    static QuestNameCache* GetSingleton() {
+        static QuestNameCache instance;
+        return &instance;
+    }
+
+    /**
+     * @brief Get the display name for a note's quest.
+     * @param questID The quest's FormID (GENERAL_NOTE_ID for the general note)
+     * @return Cached name; resolved and cached on a miss
+     */
+    [[nodiscard]] std::string GetName(RE::FormID questID) {
+        if (questID == NoteManager::GENERAL_NOTE_ID) {
+            return GENERAL_NOTE_NAME;
+        }
+
+        {
+            std::shared_lock lock(lock_);
+            if (auto it = names_.find(questID); it != names_.end()) {
+                return std::string(it->second);
+            }
+        }
+
+        bool found = false;
+        std::string name = Resolve(questID, found);
+        Store(questID, name);
+        return name;
+    }
+
+    /**
+     * @brief Look a quest up and return its display name.
+     * @param questID The quest's FormID
+     * @param found Set to true if the quest form exists
+     */
+    [[nodiscard]] static std::string Resolve(RE::FormID questID, bool& found) {
+        auto quest = RE::TESForm::LookupByID<RE::TESQuest>(questID);
+        found = quest != nullptr;
+        return quest ? quest->GetName() : UNKNOWN_QUEST_NAME;
+    }
+
+    void Store(RE::FormID questID, std::string name) {
+        std::unique_lock lock(lock_);
+        names_.insert_or_assign(questID, Name(name));
+    }
+
+    void Clear() {
+        std::unique_lock lock(lock_);
+        names_.clear();
+    }
+
+    /**
+     * @brief Subscribe to NoteManager: rebuild after loads, pre-resolve new notes.
+     */
+    static void Register();
+
+private:
+    QuestNameCache() = default;
+
+    using Name = MemStats::String<MemStats::Subsystem::kQuestNames>;
+
+    MemStats::HashMap<RE::FormID, Name, MemStats::Subsystem::kQuestNames> names_;
+    mutable std::shared_mutex lock_;
+};
+
+/**
+ * @class QuestNameRefreshTask
+ * @brief Re-resolves quest names for all notes a slice per frame, and counts
+ * orphaned notes (notes whose quest isn't loaded).
+ */
+class QuestNameRefreshTask : public IncrementalTask {
+public:
+    QuestNameRefreshTask()
+        : ids_(NoteManager::GetSingleton()->GetNoteIDs(0, std::numeric_limits<size_t>::max())) {}
+
+    [[nodiscard]] const char* GetName() const override {
+        return "QuestNameRefresh";
+    }
+
+    [[nodiscard]] std::chrono::microseconds GetBudget() const override {
+        return std::chrono::microseconds(200);
+    }
+
+    bool Step(const FrameDeadline& deadline) override {
+        auto cache = QuestNameCache::GetSingleton();
+
+        while (next_ < ids_.size()) {
+            RE::FormID questID = ids_[next_++];
+            if (questID != NoteManager::GENERAL_NOTE_ID) {
+                bool found = false;
+                cache->Store(questID, QuestNameCache::Resolve(questID, found));
+                if (!found) {
+                    orphans_++;
+                }
+            }
+
+            if (deadline.Expired()) {
+                return false;
+            }
+        }
+
+        if (orphans_ > 0) {
+            spdlog::warn("[CACHE] {} of {} notes belong to quests that are not loaded (removed mod?)",
+                         orphans_, ids_.size());
+        }
+        return true;
+    }
+
+private:
+    std::vector<RE::FormID> ids_;
+    size_t next_ = 0;
+    size_t orphans_ = 0;
+};
+
+void QuestNameCache::Register() {
+    NoteManager::GetSingleton()->Subscribe("QuestNameCache", NoteDelivery::kQueued,
+        [](const NoteChangeEvent& event) {
+            auto cache = GetSingleton();
+            if (event.kind == NoteChangeKind::kReset) {
+                cache->Clear();
+                FrameScheduler::GetSingleton()->Add(std::make_unique<QuestNameRefreshTask>());
+            } else if (event.kind == NoteChangeKind::kSaved) {
+                (void)cache->GetName(event.questID);  // Resolve on the main thread, not at list time
+            }
+        });
+}
+
+//=============================================================================
+// Note Preview Cache
+//=============================================================================
+
+/**
+ * @class NotePreviewCache
+ * @brief Word-wrapped first lines of each note, for the Journal overlay.
+ *
+ * Built on first request straight from the stored note (no copy of the full
+ * text) and kept until the note is written. Invalidation is a kSync subscriber,
+ * so a preview read after a save always reflects it. Wrap settings changing
+ * drops the whole cache.
+ *
+ * @thread_safety All public methods are thread-safe.
+ */
+class NotePreviewCache {
+public:
+    /**
+     * @brief Get the singleton instance.
+     * @return Pointer to singleton instance (never null)
+     */
+    static NotePreviewCache* GetSingleton() {
+        static NotePreviewCache instance;
+        return &instance;
+    }
+
+    /**
+     * @brief Get the preview for a quest's note.
+     * @param questID The quest's FormID
+     * @param out Receives the wrapped preview lines ('\n'-separated)
+     * @return false if the quest has no note
+     */
+    bool Get(RE::FormID questID, std::string& out) {
+        auto settings = SettingsManager::GetSingleton();
+        std::uint32_t generation = settings->GetGeneration();
+        std::uint64_t epoch;
+
+        {
+            std::shared_lock lock(lock_);
+            if (generation == settingsGeneration_) {
+                if (auto it = previews_.find(questID); it != previews_.end()) {
+                    out.assign(it->second);
+                    return true;
+                }
+            }
+            epoch = epoch_;
+        }
+
+        size_t columns = ColumnsFor(settings->previewWidth, settings->textFieldFontSize);
+        bool found = NoteManager::GetSingleton()->VisitNote(questID, [&](const Note& note) {
+            out = Wrap(note.text, columns, static_cast<size_t>(settings->previewLines));
+        });
+        if (!found) {
+            return false;
+        }
+
+        std::unique_lock lock(lock_);
+        if (epoch != epoch_) {
+            return true;  // Note written while we were wrapping it; don't cache a stale preview
+        }
+        if (generation != settingsGeneration_) {
+            previews_.clear();
+            settingsGeneration_ = generation;
+        }
+        previews_.insert_or_assign(questID, Preview(out));
+        return true;
+    }
+
+    void Invalidate(RE::FormID questID) {
+        std::unique_lock lock(lock_);
+        previews_.erase(questID);
+        ++epoch_;
+    }
+
+    void Clear() {
+        std::unique_lock lock(lock_);
+        previews_.clear();
+        ++epoch_;
+    }
+
+    /**
+     * @brief Subscribe to NoteManager (kSync: drop previews as notes are written).
+     */
+    static void Register() {
+        NoteManager::GetSingleton()->Subscribe("NotePreviewCache", NoteDelivery::kSync,
+            [](const NoteChangeEvent& event) {
+                if (event.kind == NoteChangeKind::kReset) {
+                    GetSingleton()->Clear();
+                } else {
+                    GetSingleton()->Invalidate(event.questID);
+                }
+            });
+    }
+
+    /**
+     * @brief Approximate characters per line for a TextField width (average glyph ~0.5 em).
+     */
+    [[nodiscard]] static size_t ColumnsFor(int widthPixels, int fontSize) {
+        return std::max<size_t>(10, static_cast<size_t>(widthPixels / (std::max(fontSize, 1) * 0.5)));
+    }
+
+    /**
+     * @brief Greedy word wrap of the first maxLines lines of text.
+     * @param text UTF-8 note text
+     * @param columns Line width in code points; longer words are broken
+     * @param maxLines Lines to keep; "..." marks truncated text
+     */
+    [[nodiscard]] static std::string Wrap(std::string_view text, size_t columns, size_t maxLines) {
+        std::string result;
+        size_t lines = 0;
+        size_t lineWidth = 0;
+        size_t pos = 0;
+
+        auto isContinuation = [](char c) { return (static_cast<unsigned char>(c) & 0xC0) == 0x80; };
+        auto codePoints = [&](std::string_view s) {
+            return static_cast<size_t>(std::count_if(s.begin(), s.end(), [&](char c) { return !isContinuation(c); }));
+        };
+        auto newLine = [&]() {
+            if (++lines >= maxLines) {
+                return false;
+            }
+            result += '\n';
+            lineWidth = 0;
+            return true;
+        };
+
+        if (maxLines == 0) {
+            return result;
+        }
+
+        while (pos < text.size()) {
+            char c = text[pos];
+            if (c == '\n') {
+                ++pos;
+                if (!newLine()) {
+                    break;
+                }
+                continue;
+            }
+            if (c == ' ' || c == '\t' || c == '\r') {
+                ++pos;
+                if (lineWidth > 0 && lineWidth < columns && result.back() != ' ') {
+                    result += ' ';
+                    ++lineWidth;
+                }
+                continue;
+            }
+
+            size_t end = text.find_first_of(" \t\r\n", pos);
+            std::string_view word = text.substr(pos, end == std::string_view::npos ? std::string_view::npos : end - pos);
+            size_t width = codePoints(word);
+
+            if (lineWidth > 0 && lineWidth + width > columns) {
+                // Drop the trailing space and continue on the next line
+                if (!result.empty() && result.back() == ' ') {
+                    result.pop_back();
+                }
+                if (!newLine()) {
+                    break;
+                }
+            }
+
+            if (width <= columns - lineWidth) {
+                result += word;
+                lineWidth += width;
+                pos += word.size();
+                continue;
+            }
+
+            // Word longer than a line: take as many code points as fit
+            size_t take = 0;
+            for (size_t fit = 0; take < word.size() && fit < columns - lineWidth; ++fit) {
+                do {
+                    ++take;
+                } while (take < word.size() && isContinuation(word[take]));
+            }
+            result += word.substr(0, take);
+            lineWidth = columns;
+            pos += take;
+        }
+
+        while (!result.empty() && (result.back() == ' ' || result.back() == '\n')) {
+            result.pop_back();
+        }
+        if (pos < text.size()) {
+            result += "...";
+        }
+        return result;
+    }
+
+private:
+    NotePreviewCache() = default;
+
+    using Preview = MemStats::String<MemStats::Subsystem::kPreviews>;
+
+    MemStats::HashMap<RE::FormID, Preview, MemStats::Subsystem::kPreviews> previews_;
+    std::uint32_t settingsGeneration_ = 0;
+    std::uint64_t epoch_ = 0;  // Bumped by every invalidation
+    mutable std::shared_mutex lock_;
+};
+
+//=============================================================================
+// Backup Manager
+//=============================================================================
+
+/**
+ * @namespace BackupManager
+ * @brief Handles JSON export/import of notes for backup and restore.
+ *
+ * Exports notes to timestamped JSON files in Data/SKSE/Plugins/PersonalNotes/backup/
+ * Imports notes from Data/SKSE/Plugins/PersonalNotes/import/notes.json on plugin load.
+ */
+namespace BackupManager {
+    namespace fs = std::filesystem;
+
+    /**
+     * @brief Get current timestamp in ISO 8601 format for filenames.
+     * @return Timestamp string like "2025-11-16_22-30-45"
+     */
+    std::string GetTimestampForFilename() {
+        auto now = std::time(nullptr);
+        std::tm tm{};
+        localtime_s(&tm, &now);
+        std::ostringstream oss;
+        oss << std::put_time(&tm, "%Y-%m-%d_%H-%M-%S");
+        return oss.str();
+    }
+
+    /**
+     * @brief Get current timestamp in ISO 8601 format for JSON content.
+     * @return Timestamp string like "2025-11-16T22:30:45"
+     */
+    std::string GetTimestampISO8601() {
+        auto now = std::time(nullptr);
+        std::tm tm{};
+        localtime_s(&tm, &now);
+        std::ostringstream oss;
+        oss << std::put_time(&tm, "%Y-%m-%dT%H:%M:%S");
+        return oss.str();
+    }
+
+    using BackupJSON::EscapeJSON;
+    using BackupJSON::ExtractJSONValue;
+    using BackupJSON::UnescapeJSON;
+
+    /**
+     * @brief Create directory if it doesn't exist.
+     * @param path Directory path to create
+     * @return true on success or if already exists
+     */
+    bool EnsureDirectoryExists(const std::string& path) {
+        try {
+            if (!fs::exists(path)) {
+                fs::create_directories(path);
+                spdlog::info("[BACKUP] Created directory: {}", path);
+            }
+            return true;
+        } catch (const fs::filesystem_error& e) {
+            spdlog::error("[BACKUP] Failed to create directory {}: {}", path, e.what());
+            return false;
+        }
+    }
+
+    /**
+     * @brief FNV-1a 64-bit hash of a backup's contents (catalog identity, not security).
+     */
+    std::uint64_t HashContent(std::string_view data) {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (unsigned char c : data) {
+            hash = (hash ^ c) * 1099511628211ull;
+        }
+        return hash;
+    }
+
+    /**
+     * One export as recorded in the backup catalog.
+     */
+    struct CatalogEntry {
+        std::string file;        // File name inside Paths::BACKUP_DIR
+        std::string playerName;
+        std::time_t created = 0;  // Unix seconds of the export
+        std::uint32_t noteCount = 0;
+        std::uint64_t size = 0;  // Bytes
+        std::uint64_t hash = 0;  // HashContent() of the file
+        std::string base;        // Incremental backups: the full backup their chain starts from; "" for full
+    };
+
+    /**
+     * @namespace Catalog
+     * @brief Index of the exports in Paths::BACKUP_DIR (Paths::BACKUP_CATALOG).
+     *
+     * Lists backups without opening them and drives the retention policy. One entry
+     * per line, oldest first. If the catalog is missing or unreadable it is rebuilt
+     * once from the backup folder. All functions are thread-safe.
+     */
+    namespace Catalog {
+        inline std::mutex lock;
+        inline std::vector<CatalogEntry> entries;  // Ascending created
+        inline bool loaded = false;
+
+        inline bool IsBackupFile(const fs::path& path) {
+            if (path.extension() == NoteBackupFormat::kExtension) {
+                return true;
+            }
+            return path.extension() == ".json" && path.filename() != fs::path(Paths::BACKUP_CATALOG).filename();
+        }
+
+        /**
+         * @brief Describe an existing backup file (used when rebuilding the catalog).
+         */
+        inline std::optional<CatalogEntry> ScanBackupFile(const fs::path& path) {
+            std::ifstream file(path, std::ios::binary);
+            if (!file) {
+                return std::nullopt;
+            }
+            std::stringstream buffer;
+            buffer << file.rdbuf();
+            std::string json = buffer.str();
+
+            CatalogEntry entry;
+            entry.file = path.filename().string();
+            entry.size = json.size();
+            entry.hash = HashContent(json);
+
+            if (path.extension() == NoteBackupFormat::kExtension) {
+                NoteBackupFormat::MappedBackup backup;
+                if (!backup.Open(path.string())) {
+                    return std::nullopt;
+                }
+                entry.playerName = backup.PlayerName();
+                entry.noteCount = backup.Size();
+            } else {
+                // Player name and count sit in the header, before the notes array
+                std::string header = json.substr(0, json.find("\"notes\":"));
+                std::string countStr = ExtractJSONValue(header, "noteCount");
+                entry.playerName = UnescapeJSON(ExtractJSONValue(header, "playerName"));
+                entry.noteCount = countStr.empty() ? 0 : static_cast<std::uint32_t>(std::stoul(countStr));
+                entry.base = UnescapeJSON(ExtractJSONValue(header, "base"));
+            }
+            auto writeTime = std::chrono::clock_cast<std::chrono::system_clock>(fs::last_write_time(path));
+            entry.created = std::chrono::system_clock::to_time_t(writeTime);
+            return entry;
+        }
+
+        inline void RebuildLocked() {
+            entries.clear();
+            std::error_code ec;
+            for (const auto& item : fs::directory_iterator(Paths::BACKUP_DIR, ec)) {
+                if (!item.is_regular_file() || !IsBackupFile(item.path())) {
+                    continue;
+                }
+                try {
+                    if (auto entry = ScanBackupFile(item.path())) {
+                        entries.push_back(std::move(*entry));
+                    }
+                } catch (const std::exception& e) {
+                    spdlog::warn("[BACKUP] Skipping unreadable backup {}: {}", item.path().string(), e.what());
+                }
+            }
+            std::sort(entries.begin(), entries.end(), [](const CatalogEntry& a, const CatalogEntry& b) {
+                return a.created < b.created;
+            });
+            spdlog::info("[BACKUP] Rebuilt catalog from {} backups", entries.size());
+        }
+
+        /**
+         * @return false if the catalog file is missing or invalid
+         */
+        inline bool ReadLocked() {
+            std::ifstream file(Paths::BACKUP_CATALOG);
+            if (!file) {
+                return false;
+            }
+
+            entries.clear();
+            std::string line;
+            try {
+                while (std::getline(file, line)) {
+                    if (line.find("\"file\":") == std::string::npos) {
+                        continue;
+                    }
+                    CatalogEntry entry;
+                    entry.file = UnescapeJSON(ExtractJSONValue(line, "file"));
+                    entry.playerName = UnescapeJSON(ExtractJSONValue(line, "playerName"));
+                    entry.created = std::stoll(ExtractJSONValue(line, "created"));
+                    entry.noteCount = static_cast<std::uint32_t>(std::stoul(ExtractJSONValue(line, "noteCount")));
+                    entry.size = std::stoull(ExtractJSONValue(line, "size"));
+                    entry.hash = std::stoull(ExtractJSONValue(line, "hash"), nullptr, 16);
+                    entry.base = UnescapeJSON(ExtractJSONValue(line, "base"));
+                    entries.push_back(std::move(entry));
+                }
+            } catch (const std::exception& e) {
+                spdlog::warn("[BACKUP] Catalog is invalid ({}), rebuilding", e.what());
+                return false;
+            }
+            return true;
+        }
+
+        inline void WriteLocked() {
+            std::ostringstream json;
+            json << "{\n";
+            json << "  \"version\": 1,\n";
+            json << "  \"backups\": [\n";
+            for (size_t i = 0; i < entries.size(); ++i) {
+                const CatalogEntry& entry = entries[i];
+                json << "    { \"file\": \"" << EscapeJSON(entry.file)
+                     << "\", \"playerName\": \"" << EscapeJSON(entry.playerName)
+                     << "\", \"created\": " << entry.created
+                     << ", \"noteCount\": " << entry.noteCount
+                     << ", \"size\": " << entry.size
+                     << ", \"hash\": \"" << std::hex << std::setw(16) << std::setfill('0') << entry.hash << std::dec
+                     << "\", \"base\": \"" << EscapeJSON(entry.base)
+                     << "\" }" << (i + 1 < entries.size() ? ",\n" : "\n");
+            }
+            json << "  ]\n";
+            json << "}\n";
+
+            DurableFile file;
+            if (!file.Open(Paths::BACKUP_CATALOG) || !file.Write(json.view()) || !file.Commit()) {
+                spdlog::error("[BACKUP] Failed to write catalog: {}", file.LastError());
+            }
+        }
+
+        inline void EnsureLoadedLocked() {
+            if (loaded) {
+                return;
+            }
+            loaded = true;
+            if (!ReadLocked()) {
+                RebuildLocked();
+                WriteLocked();
+            }
+        }
+
+        /**
+         * @brief Add (or replace) the entry for a freshly written backup.
+         */
+        inline void Record(CatalogEntry entry) {
+            std::lock_guard guard(lock);
+            EnsureLoadedLocked();
+            std::erase_if(entries, [&](const CatalogEntry& existing) { return existing.file == entry.file; });
+            auto pos = std::upper_bound(entries.begin(), entries.end(), entry.created,
+                [](std::time_t created, const CatalogEntry& existing) { return created < existing.created; });
+            entries.insert(pos, std::move(entry));
+            WriteLocked();
+        }
+
+        /**
+         * @brief Catalog entry for a backup file name, if it has one.
+         */
+        inline std::optional<CatalogEntry> Find(const std::string& file) {
+            std::lock_guard guard(lock);
+            EnsureLoadedLocked();
+            auto it = std::find_if(entries.begin(), entries.end(),
+                [&](const CatalogEntry& entry) { return entry.file == file; });
+            if (it == entries.end()) {
+                return std::nullopt;
+            }
+            return *it;
+        }
+
+        /**
+         * @brief All catalogued backups, newest first. Does not open any backup file.
+         */
+        inline std::vector<CatalogEntry> List() {
+            std::lock_guard guard(lock);
+            EnsureLoadedLocked();
+            return std::vector<CatalogEntry>(entries.rbegin(), entries.rend());
+        }
+
+        /**
+         * @brief Delete backups beyond the retention policy (runs as a background job).
+         * @param keepPerCharacter Newest backups kept per player name (0 = no limit)
+         * @param maxTotalBytes Cap on the summed size of all backups (0 = no limit)
+         *
+         * Incremental backups are useless without the rest of their chain, so the
+         * policy counts and deletes whole chains (a full backup plus the incrementals
+         * based on it). The newest chain is always kept, even if it alone exceeds the cap.
+         */
+        inline void ApplyRetention(size_t keepPerCharacter, std::uint64_t maxTotalBytes) {
+            Trace::Scope trace("ApplyRetention", "export");
+            std::lock_guard guard(lock);
+            EnsureLoadedLocked();
+            if (entries.empty()) {
+                return;
+            }
+
+            auto chainOf = [](const CatalogEntry& entry) -> const std::string& {
+                return entry.base.empty() ? entry.file : entry.base;
+            };
+            std::unordered_map<std::string, std::uint64_t> chainBytes;
+            for (const CatalogEntry& entry : entries) {
+                chainBytes[chainOf(entry)] += entry.size;
+            }
+
+            // Walk chains newest to oldest (by their full backup), marking what the policy drops
+            std::unordered_set<std::string> droppedChains;
+            std::unordered_map<std::string, size_t> keptPerPlayer;
+            std::uint64_t keptBytes = 0;
+            bool newest = true;
+            for (size_t i = entries.size(); i-- > 0;) {
+                const CatalogEntry& entry = entries[i];
+                if (!entry.base.empty()) {
+                    continue;
+                }
+                std::uint64_t bytes = chainBytes[entry.file];
+                size_t& kept = keptPerPlayer[entry.playerName];
+                if (!newest && ((keepPerCharacter > 0 && kept >= keepPerCharacter) ||
+                                (maxTotalBytes > 0 && keptBytes + bytes > maxTotalBytes))) {
+                    droppedChains.insert(entry.file);
+                    continue;
+                }
+                newest = false;
+                ++kept;
+                keptBytes += bytes;
+            }
+
+            std::vector<CatalogEntry> remaining;
+            remaining.reserve(entries.size());
+            size_t removedCount = 0;
+            for (size_t i = 0; i < entries.size(); ++i) {
+                if (!droppedChains.contains(chainOf(entries[i]))) {
+                    remaining.push_back(std::move(entries[i]));
+                    continue;
+                }
+                std::error_code ec;
+                fs::remove(fs::path(Paths::BACKUP_DIR) / entries[i].file, ec);
+                if (ec) {
+                    spdlog::warn("[BACKUP] Failed to delete old backup {}: {}", entries[i].file, ec.message());
+                    remaining.push_back(std::move(entries[i]));  // Retry next time
+                    continue;
+                }
+                ++removedCount;
+            }
+
+            if (removedCount > 0) {
+                entries = std::move(remaining);
+                WriteLocked();
+                spdlog::info("[BACKUP] Retention removed {} old backups ({} kept, {} bytes)", removedCount, entries.size(), keptBytes);
+            } else {
+                entries = std::move(remaining);
+            }
+        }
+    }
+
+    /**
+     * Everything an export needs from game state, gathered on the calling thread
+     * so the worker never touches forms or the player.
+     */
+    struct ExportRequest {
+        std::string playerName;
+        std::string filename;
+        std::string exportDate;
+        std::shared_ptr<const NoteSnapshot> snapshot;
+        std::vector<std::string> questNames;  // Parallel to snapshot->notes
+        size_t keepPerCharacter = 0;  // Retention policy applied after the write
+        std::uint64_t maxTotalBytes = 0;
+        std::uint32_t fullEvery = 1;  // Backups per chain before the next full one; 1 = always full
+        bool binary = false;          // Full backups as .pnb (incrementals are always JSON)
+    };
+
+    /**
+     * A note as of the last backup, enough to tell whether it changed since.
+     */
+    struct ExportedNote {
+        RE::FormID questID;
+        std::time_t modified;
+        std::uint64_t textHash;
+    };
+
+    /**
+     * @namespace Chain
+     * @brief The backup chain exports currently extend (in memory; a new session starts with a full backup).
+     */
+    namespace Chain {
+        inline std::mutex lock;  // Held for a whole export, so chain links are written in order
+        inline std::string playerName;
+        inline std::string baseFile;      // Full backup the chain starts from; "" = no chain yet
+        inline std::string previousFile;  // Last backup written to the chain
+        inline std::uint32_t length = 0;  // Backups in the chain, the full one included
+        inline std::vector<ExportedNote> notes;  // Ascending FormID, as of previousFile
+    }
+
+    /**
+     * @brief Compare the snapshot with the chain's last backup in one sorted pass.
+     * @param current Snapshot notes as ExportedNote, ascending FormID
+     * @param changed Receives indexes into current of new or modified notes
+     * @param deleted Receives FormIDs in the last backup that are gone now
+     */
+    void DiffAgainstChain(const std::vector<ExportedNote>& current, std::vector<size_t>& changed,
+                          std::vector<RE::FormID>& deleted) {
+        const auto& previous = Chain::notes;
+        size_t p = 0;
+        for (size_t c = 0; c < current.size(); ++c) {
+            while (p < previous.size() && previous[p].questID < current[c].questID) {
+                deleted.push_back(previous[p++].questID);
+            }
+            if (p < previous.size() && previous[p].questID == current[c].questID) {
+                if (previous[p].modified != current[c].modified || previous[p].textHash != current[c].textHash) {
+                    changed.push_back(c);
+                }
+                ++p;
+            } else {
+                changed.push_back(c);
+            }
+        }
+        for (; p < previous.size(); ++p) {
+            deleted.push_back(previous[p].questID);
+        }
+    }
+
+    /**
+     * @brief Append one note object of the export "notes" array.
+     */
+    void AppendNoteJSON(std::ostringstream& json, RE::FormID questID, std::string_view questName,
+                        std::string_view text, std::time_t created, std::time_t modified) {
+        json << "    {\n";
+        json << "      \"questID\": " << questID << ",\n";
+        json << "      \"questName\": \"" << EscapeJSON(questName) << "\",\n";
+        json << "      \"text\": \"" << EscapeJSON(text) << "\",\n";
+        json << "      \"created\": " << created << ",\n";
+        json << "      \"modified\": " << modified << "\n";
+        json << "    }";
+    }
+
+    /**
+     * @brief Format and write an export file (runs on a worker thread).
+     * @param request Snapshot and metadata gathered by ExportNotesToJSON()
+     * @return true on success, false on failure
+     */
+    bool WriteExportFile(const ExportRequest& request) {
+        Perf::ScopedTimer timer(Perf::Probe::kExport);
+        Trace::Scope trace("WriteExportFile", "export");
+        const auto& notes = request.snapshot->notes;
+
+        // Ensure backup directory exists
+        if (!EnsureDirectoryExists(Paths::BACKUP_DIR)) {
+            return false;
+        }
+
+        std::lock_guard chainGuard(Chain::lock);
+
+        std::vector<ExportedNote> current;
+        current.reserve(notes.size());
+        for (const Note& note : notes) {
+            current.push_back({ note.questID, note.modified, HashContent(note.text) });
+        }
+
+        // Extend the chain with an incremental backup, or start a new one with a full backup
+        bool incremental = request.fullEvery > 1 && !Chain::baseFile.empty() &&
+                           Chain::playerName == request.playerName && Chain::length < request.fullEvery;
+        std::vector<size_t> written;
+        std::vector<RE::FormID> deleted;
+        if (incremental) {
+            DiffAgainstChain(current, written, deleted);
+            if (written.empty() && deleted.empty()) {
+                spdlog::info("[BACKUP] No changes since {}, nothing to export", Chain::previousFile);
+                return true;
+            }
+        } else {
+            written.resize(notes.size());
+            std::iota(written.begin(), written.end(), size_t{ 0 });
+        }
+
+        std::string filename = request.filename;
+        bool binary = request.binary && !incremental;
+        if (incremental) {
+            filename.insert(filename.size() - std::string_view(".json").size(), "_inc");
+        } else if (binary) {
+            filename = fs::path(filename).replace_extension(NoteBackupFormat::kExtension).string();
+        }
+        std::string fileOnly = fs::path(filename).filename().string();
+
+        std::ostringstream json;
+        std::string binaryContents;
+        if (binary) {
+            std::vector<NoteBackupFormat::NoteRecord> records;
+            records.reserve(notes.size());
+            for (size_t i = 0; i < notes.size(); ++i) {
+                const Note& note = notes[i];
+                records.push_back({ note.questID, note.text, request.questNames[i], note.created, note.modified });
+            }
+            binaryContents = NoteBackupFormat::Write(request.playerName, request.exportDate, records);
+            if (binaryContents.empty()) {
+                spdlog::error("[BACKUP] Notes too large for the binary format");
+                return false;
+            }
+        } else {
+            // Build JSON manually
+            json << "{\n";
+            json << "  \"exportDate\": \"" << request.exportDate << "\",\n";
+            json << "  \"version\": \"1.0\",\n";
+            json << "  \"playerName\": \"" << EscapeJSON(request.playerName) << "\",\n";
+            if (incremental) {
+                json << "  \"kind\": \"incremental\",\n";
+                json << "  \"base\": \"" << EscapeJSON(Chain::baseFile) << "\",\n";
+                json << "  \"previous\": \"" << EscapeJSON(Chain::previousFile) << "\",\n";
+                json << "  \"deleted\": [";
+                for (size_t i = 0; i < deleted.size(); ++i) {
+                    json << (i > 0 ? ", " : "") << deleted[i];
+                }
+                json << "],\n";
+            } else {
+                json << "  \"kind\": \"full\",\n";
+            }
+            json << "  \"noteCount\": " << written.size() << ",\n";
+            json << "  \"notes\": [\n";
+
+            for (size_t w = 0; w < written.size(); ++w) {
+                size_t i = written[w];
+                const Note& note = notes[i];
+                if (w > 0) json << ",\n";
+
+                AppendNoteJSON(json, note.questID, request.questNames[i], note.text, note.created, note.modified);
+            }
+
+            json << "\n  ]\n";
+            json << "}\n";
+        }
+        std::string_view contents = binary ? std::string_view(binaryContents) : json.view();
+
+        // Write to a temp file and rename it into place, so a crash mid-export
+        // never leaves a truncated backup behind
+        DurableFile file;
+        if (!file.Open(filename)) {
+            spdlog::error("[BACKUP] Failed to open file for writing: {}", file.LastError());
+            return false;
+        }
+        if (!file.Write(contents) || !file.Commit()) {
+            spdlog::error("[BACKUP] Export failed: {}", file.LastError());
+            return false;
+        }
+
+        if (incremental) {
+            spdlog::info("[BACKUP] Exported {} changed and {} deleted notes to {} (chain {}, {}/{})",
+                         written.size(), deleted.size(), filename, Chain::baseFile, Chain::length + 1, request.fullEvery);
+            ++Chain::length;
+        } else {
+            spdlog::info("[BACKUP] Exported {} notes to {}", notes.size(), filename);
+            Chain::playerName = request.playerName;
+            Chain::baseFile = fileOnly;
+            Chain::length = 1;
+        }
+        Chain::previousFile = fileOnly;
+        Chain::notes = std::move(current);
+
+        CatalogEntry entry;
+        entry.file = fileOnly;
+        entry.playerName = request.playerName;
+        entry.created = std::time(nullptr);
+        entry.noteCount = static_cast<std::uint32_t>(written.size());
+        entry.size = contents.size();
+        entry.hash = HashContent(contents);
+        entry.base = incremental ? Chain::baseFile : std::string();
+        Catalog::Record(std::move(entry));
+
+        JobSystem::GetSingleton()->Submit(JobPriority::kBackground,
+            [keep = request.keepPerCharacter, maxBytes = request.maxTotalBytes]() {
+                Catalog::ApplyRetention(keep, maxBytes);
+            });
+        return true;
+    }
+
+    namespace AutoBackup {
+        inline void OnManualExport(std::uint64_t generation);  // Defined below with the rest of AutoBackup
+    }
+
+    /**
+     * @brief Export all notes to JSON file with timestamp.
+     * @param automatic Auto-backup: background priority, notification only on failure
+     * @return true if the export was started, false if there is nothing to export
+     *
+     * Gathers the note snapshot, player name and quest names on the calling thread,
+     * then formats and writes the file on the job system. The result notification
+     * is shown from the main thread when the write finishes.
+     */
+    bool ExportNotesToJSON(bool automatic = false) {
+        Trace::Scope trace("ExportNotesToJSON", "export");
+        auto request = std::make_shared<ExportRequest>();
+        request->snapshot = NoteManager::GetSingleton()->GetSnapshot();
+        const auto& notes = request->snapshot->notes;
+
+        if (notes.empty()) {
+            if (!automatic) {
+                RE::DebugNotification("No notes to export");
+            }
+            spdlog::warn("[BACKUP] No notes to export");
+            return false;
+        }
+
+        // Get player name
+        std::string playerName = "Unknown";
+        auto player = RE::PlayerCharacter::GetSingleton();
+        if (player) {
+            const char* name = player->GetName();
+            if (name && name[0] != '\0') {
+                playerName = name;
+            }
+        }
+
+        // Sanitize player name for filename (remove invalid chars)
+        std::string safePlayerName = playerName;
+        for (char& c : safePlayerName) {
+            if (c == '\\' || c == '/' || c == ':' || c == '*' || c == '?' ||
+                c == '"' || c == '<' || c == '>' || c == '|' || c == ' ') {
+                c = '_';
+            }
+        }
+
+        // Generate filename with player name and timestamp
+        std::string timestamp = GetTimestampForFilename();
+        request->filename = std::string(Paths::BACKUP_DIR) + "/" + safePlayerName + "_notes_" + timestamp + ".json";
+        request->exportDate = GetTimestampISO8601();
+        request->playerName = std::move(playerName);
+
+        auto settings = SettingsManager::GetSingleton();
+        request->keepPerCharacter = static_cast<size_t>(settings->backupKeepPerCharacter);
+        request->maxTotalBytes = static_cast<std::uint64_t>(settings->backupMaxTotalMB) * 1024 * 1024;
+        request->fullEvery = settings->backupIncremental ? static_cast<std::uint32_t>(settings->backupFullEvery) : 1;
+        request->binary = settings->backupBinary;
+
+        // Resolve quest names while we are still allowed to touch forms
+        auto nameCache = QuestNameCache::GetSingleton();
+        request->questNames.reserve(notes.size());
+        for (const Note& note : notes) {
+            request->questNames.push_back(nameCache->GetName(note.questID));
+        }
+
+        JobSystem::GetSingleton()->SubmitThen(automatic ? JobPriority::kBackground : JobPriority::kUICritical,
+            [request]() { return WriteExportFile(*request); },
+            [automatic](bool success) {
+                if (!automatic) {
+                    RE::DebugNotification(success ? "Notes exported successfully" : "Export failed");
+                } else if (!success) {
+                    RE::DebugNotification("Automatic note backup failed");
+                }
+            });
+        if (!automatic) {
+            AutoBackup::OnManualExport(request->snapshot->generation);
+        }
+        return true;
+    }
+
+    /**
+     * @namespace AutoBackup
+     * @brief Backups triggered by game saves ([Backup] bAutoBackup).
+     *
+     * At most one backup per iAutoBackupMinutes: the first save inside the interval
+     * (quicksave spam) schedules a trailing backup on the FrameScheduler for the end
+     * of the interval, which exports the notes as they are then; later saves fold
+     * into it. Saves with no note changes since the last backup or manual export
+     * are skipped. State is touched on the main thread only.
+     */
+    namespace AutoBackup {
+        inline std::optional<std::chrono::steady_clock::time_point> lastBackup;
+        inline std::uint64_t lastGeneration = 0;  // NoteManager generation backed up (or exported) last
+        inline bool trailingPending = false;      // A TrailingBackupTask is waiting out the interval
+        inline std::uint32_t epoch = 0;           // Bumped by Reset(); older trailing tasks do nothing
+
+        [[nodiscard]] inline bool InInterval(std::chrono::steady_clock::time_point now) {
+            auto interval = std::chrono::minutes(SettingsManager::GetSingleton()->autoBackupMinutes);
+            return lastBackup && now - *lastBackup < interval;
+        }
+
+        /**
+         * @brief True if the notes changed since the last backup and there is something to back up.
+         */
+        [[nodiscard]] inline bool HasChanges(std::uint64_t generation) {
+            return generation != lastGeneration && NoteManager::GetSingleton()->GetNoteCount() > 0;
+        }
+
+        inline void Start(std::uint64_t generation, const char* reason) {
+            lastBackup = std::chrono::steady_clock::now();
+            lastGeneration = generation;
+
+            JobSystem::RunOnMainThread([reason]() {
+                spdlog::info("[BACKUP] Automatic backup {}", reason);
+                ExportNotesToJSON(true);
+            });
+        }
+
+        /**
+         * @class TrailingBackupTask
+         * @brief Waits until the throttle interval has passed, then backs up the
+         * changes from saves that landed inside it.
+         */
+        class TrailingBackupTask : public IncrementalTask {
+        public:
+            explicit TrailingBackupTask(std::uint32_t startEpoch) : epoch_(startEpoch) {}
+
+            [[nodiscard]] const char* GetName() const override {
+                return "AutoBackupTrailing";
+            }
+
+            [[nodiscard]] std::chrono::microseconds GetBudget() const override {
+                return std::chrono::microseconds(50);
+            }
+
+            bool Step(const FrameDeadline&) override {
+                if (epoch_ != epoch) {
+                    return true;  // A game was loaded meanwhile
+                }
+                if (InInterval(std::chrono::steady_clock::now())) {
+                    return false;  // A manual export may have moved the interval on
+                }
+                trailingPending = false;
+
+                std::uint64_t generation = NoteManager::GetSingleton()->GetGeneration();
+                if (SettingsManager::GetSingleton()->autoBackup && HasChanges(generation)) {
+                    Start(generation, "for saves inside the interval");
+                }
+                return true;
+            }
+
+        private:
+            std::uint32_t epoch_;
+        };
+
+        /**
+         * @brief Called from the save callback. Only checks the throttle; gathering
+         * the export runs as a later main-thread task and the write on a worker.
+         */
+        inline void OnGameSaved() {
+            if (!SettingsManager::GetSingleton()->autoBackup) {
+                return;
+            }
+            std::uint64_t generation = NoteManager::GetSingleton()->GetGeneration();
+            if (!HasChanges(generation)) {
+                return;
+            }
+
+            if (InInterval(std::chrono::steady_clock::now())) {
+                if (!trailingPending) {
+                    trailingPending = true;
+                    FrameScheduler::GetSingleton()->Add(std::make_unique<TrailingBackupTask>(epoch));
+                    spdlog::debug("[BACKUP] Auto-backup deferred to the end of the {} min interval",
+                                  SettingsManager::GetSingleton()->autoBackupMinutes);
+                }
+                return;
+            }
+            Start(generation, "after game save");
+        }
+
+        /**
+         * @brief A manual export covers the notes as of its snapshot, so the next
+         * save only backs up if they changed after it.
+         */
+        inline void OnManualExport(std::uint64_t generation) {
+            lastBackup = std::chrono::steady_clock::now();
+            lastGeneration = generation;
+        }
+
+        /**
+         * @brief Drop a pending trailing backup (kPreLoadGame); it belonged to the previous game.
+         */
+        inline void Reset() {
+            ++epoch;
+            trailingPending = false;
+        }
+    }
+
+    /**
+     * Notes read from the import file, not yet written to NoteManager.
+     */
+    struct ImportedNotes {
+        bool error = false;  // File present but unreadable or invalid
+        std::vector<Note> notes;
+        std::string path;    // Import file the notes came from
+    };
+
+    /**
+     * One parsed backup file.
+     */
+    struct BackupContents {
+        bool incremental = false;
+        std::string previous;             // Incremental only: backup this one applies on top of
+        std::vector<RE::FormID> deleted;  // Incremental only, ascending
+        std::vector<Note> notes;          // Ascending FormID
+        std::vector<std::string> questNames;  // Parallel to notes
+        std::string playerName;
+        std::string exportDate;
+    };
+
+    /**
+     * @brief Parse one backup file (throws std::exception on malformed numbers).
+     * @return false if the file is not a backup
+     */
+    bool ParseBackupJSON(const std::string& json, BackupContents& out) {
+        // Empty file: nothing to import, not an error
+        if (json.find_first_not_of(" \t\n\r") == std::string::npos) {
+            spdlog::info("[BACKUP] Backup file is empty, skipping");
+            return true;
+        }
+
+        // Find notes array
+        size_t notesArrayStart = json.find("\"notes\":");
+        if (notesArrayStart == std::string::npos) {
+            spdlog::error("[BACKUP] Invalid JSON: 'notes' array not found");
+            return false;
+        }
+
+        // Header fields sit before the notes array; older exports have none of these
+        std::string header = json.substr(0, notesArrayStart);
+        out.playerName = UnescapeJSON(ExtractJSONValue(header, "playerName"));
+        out.exportDate = UnescapeJSON(ExtractJSONValue(header, "exportDate"));
+        out.incremental = ExtractJSONValue(header, "kind") == "incremental";
+        if (out.incremental) {
+            out.previous = UnescapeJSON(ExtractJSONValue(header, "previous"));
+            size_t deletedStart = header.find("\"deleted\":");
+            size_t listStart = deletedStart == std::string::npos ? deletedStart : header.find('[', deletedStart);
+            size_t listEnd = listStart == std::string::npos ? listStart : header.find(']', listStart);
+            if (out.previous.empty() || listEnd == std::string::npos) {
+                spdlog::error("[BACKUP] Invalid incremental backup: chain fields missing");
+                return false;
+            }
+            std::istringstream ids(header.substr(listStart + 1, listEnd - listStart - 1));
+            std::string id;
+            while (std::getline(ids, id, ',')) {
+                if (id.find_first_not_of(" \t\r\n") != std::string::npos) {
+                    out.deleted.push_back(static_cast<RE::FormID>(std::stoul(id)));
+                }
+            }
+            std::sort(out.deleted.begin(), out.deleted.end());
+        }
+
+        // Find opening bracket of array
+        size_t arrayStart = json.find('[', notesArrayStart);
+        if (arrayStart == std::string::npos) {
+            spdlog::error("[BACKUP] Invalid JSON: notes array bracket not found");
+            return false;
+        }
+
+        // Parse each note object
+        size_t pos = arrayStart + 1;
+        while (pos < json.size()) {
+            // Find next note object
+            size_t objStart = json.find('{', pos);
+            if (objStart == std::string::npos) {
+                break;  // No more objects
+            }
+
+            // Note text may contain braces; only the object's own closing brace ends it
+            size_t objEnd = BackupJSON::FindObjectEnd(json, objStart);
+            if (objEnd == std::string::npos) {
+                spdlog::error("[BACKUP] Invalid JSON: unclosed object");
+                break;
+            }
+
+            std::string noteObj = json.substr(objStart, objEnd - objStart + 1);
+
+            // Extract fields
+            std::string questIDStr = ExtractJSONValue(noteObj, "questID");
+            std::string textEscaped = ExtractJSONValue(noteObj, "text");
+
+            if (questIDStr.empty() || textEscaped.empty()) {
+                spdlog::warn("[BACKUP] Skipping note with missing fields");
+                pos = objEnd + 1;
+                continue;
+            }
+
+            // Convert values; older exports have a single "timestamp", treated as both times
+            RE::FormID questID = static_cast<RE::FormID>(std::stoul(questIDStr));
+            std::string modifiedStr = ExtractJSONValue(noteObj, "modified");
+            if (modifiedStr.empty()) {
+                modifiedStr = ExtractJSONValue(noteObj, "timestamp");
+            }
+            std::string createdStr = ExtractJSONValue(noteObj, "created");
+            std::time_t modified = modifiedStr.empty() ? std::time(nullptr) : std::stoll(modifiedStr);
+            std::time_t created = createdStr.empty() ? modified : std::stoll(createdStr);
+
+            out.notes.emplace_back(NoteUtils::SanitizeNoteText(UnescapeJSON(textEscaped)), questID, created, modified);
+            out.questNames.push_back(UnescapeJSON(ExtractJSONValue(noteObj, "questName")));
+
+            pos = objEnd + 1;
+        }
+
+        // Exports are written in FormID order; hand-edited files may not be
+        auto byID = [](const Note& a, const Note& b) { return a.questID < b.questID; };
+        if (!std::is_sorted(out.notes.begin(), out.notes.end(), byID)) {
+            std::vector<size_t> order(out.notes.size());
+            std::iota(order.begin(), order.end(), size_t{ 0 });
+            std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return byID(out.notes[a], out.notes[b]); });
+
+            std::vector<Note> notes;
+            std::vector<std::string> questNames;
+            notes.reserve(order.size());
+            questNames.reserve(order.size());
+            for (size_t i : order) {
+                notes.push_back(std::move(out.notes[i]));
+                questNames.push_back(std::move(out.questNames[i]));
+            }
+            out.notes = std::move(notes);
+            out.questNames = std::move(questNames);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Read a binary (.pnb) backup through a memory mapping.
+     */
+    bool ReadBinaryBackup(const std::string& path, BackupContents& out) {
+        NoteBackupFormat::MappedBackup backup;
+        if (!backup.Open(path)) {
+            spdlog::error("[BACKUP] Cannot read binary backup {}: {}", path, backup.LastError());
+            return false;
+        }
+
+        out.playerName = backup.PlayerName();
+        out.exportDate = backup.ExportDate();
+        out.notes.reserve(backup.Size());
+        out.questNames.reserve(backup.Size());
+        NoteBackupFormat::NoteRecord record;
+        for (std::uint32_t i = 0; i < backup.Size(); ++i) {
+            if (!backup.At(i, record)) {
+                spdlog::error("[BACKUP] Binary backup {} is corrupt at note {}", path, i);
+                return false;
+            }
+            out.notes.emplace_back(NoteUtils::SanitizeNoteText(std::string(record.text)), record.questID,
+                                   static_cast<std::time_t>(record.created), static_cast<std::time_t>(record.modified));
+            out.questNames.emplace_back(record.questName);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Apply an incremental backup to the notes of the backup before it (one sorted pass).
+     */
+    std::vector<Note> ApplyIncremental(std::vector<Note>&& notes, BackupContents& delta) {
+        std::vector<Note> result;
+        result.reserve(notes.size() + delta.notes.size());
+        auto changed = delta.notes.begin();
+        auto deleted = delta.deleted.begin();
+
+        for (Note& note : notes) {
+            while (changed != delta.notes.end() && changed->questID < note.questID) {
+                result.push_back(std::move(*changed++));
+            }
+            while (deleted != delta.deleted.end() && *deleted < note.questID) {
+                ++deleted;
+            }
+            if (changed != delta.notes.end() && changed->questID == note.questID) {
+                result.push_back(std::move(*changed++));
+            } else if (deleted == delta.deleted.end() || *deleted != note.questID) {
+                result.push_back(std::move(note));
+            }
+        }
+        for (; changed != delta.notes.end(); ++changed) {
+            result.push_back(std::move(*changed));
+        }
+        return result;
+    }
+
+    /**
+     * @brief Read a whole file into a string.
+     * @return false if it cannot be opened
+     */
+    bool ReadFileContents(const std::string& path, std::string& out) {
+        std::ifstream file(path);
+        if (!file) {
+            return false;
+        }
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        out = buffer.str();
+        return true;
+    }
+
+    /**
+     * @brief Parse a backup in either format (picked by extension).
+     * @return false if the file is missing or invalid (already logged)
+     */
+    bool LoadBackupFile(const std::string& path, BackupContents& out) {
+        if (fs::path(path).extension() == NoteBackupFormat::kExtension) {
+            return ReadBinaryBackup(path, out);
+        }
+        std::string json;
+        if (!ReadFileContents(path, json)) {
+            spdlog::error("[BACKUP] Failed to open {}", path);
+            return false;
+        }
+        return ParseBackupJSON(json, out);
+    }
+
+    /**
+     * @brief Convert a full backup between JSON and the binary format (runs on a worker thread).
+     * @param fileName Backup file name inside Paths::BACKUP_DIR
+     * @return true if the converted copy was written next to the original
+     *
+     * Logs both sizes and the read and write times, which compares the two formats
+     * on a real note collection.
+     */
+    bool ConvertBackup(const std::string& fileName) {
+        Trace::Scope trace("ConvertBackup", "export");
+        fs::path source = fs::path(Paths::BACKUP_DIR) / fileName;
+        bool toBinary = source.extension() != NoteBackupFormat::kExtension;
+        fs::path target = source;
+        target.replace_extension(toBinary ? NoteBackupFormat::kExtension : ".json");
+
+        auto start = std::chrono::steady_clock::now();
+        BackupContents contents;
+        if (!LoadBackupFile(source.string(), contents)) {
+            return false;
+        }
+        if (contents.incremental) {
+            spdlog::warn("[BACKUP] {} is an incremental backup; only full backups can be converted", fileName);
+            return false;
+        }
+        auto loaded = std::chrono::steady_clock::now();
+
+        std::string output;
+        if (toBinary) {
+            std::vector<NoteBackupFormat::NoteRecord> records;
+            records.reserve(contents.notes.size());
+            for (size_t i = 0; i < contents.notes.size(); ++i) {
+                const Note& note = contents.notes[i];
+                records.push_back({ note.questID, note.text, contents.questNames[i], note.created, note.modified });
+            }
+            output = NoteBackupFormat::Write(contents.playerName, contents.exportDate, records);
+            if (output.empty()) {
+                spdlog::error("[BACKUP] {} is too large for the binary format", fileName);
+                return false;
+            }
+        } else {
+            std::ostringstream json;
+            json << "{\n";
+            json << "  \"exportDate\": \"" << EscapeJSON(contents.exportDate) << "\",\n";
+            json << "  \"version\": \"1.0\",\n";
+            json << "  \"playerName\": \"" << EscapeJSON(contents.playerName) << "\",\n";
+            json << "  \"kind\": \"full\",\n";
+            json << "  \"noteCount\": " << contents.notes.size() << ",\n";
+            json << "  \"notes\": [\n";
+            for (size_t i = 0; i < contents.notes.size(); ++i) {
+                const Note& note = contents.notes[i];
+                if (i > 0) json << ",\n";
+                AppendNoteJSON(json, note.questID, contents.questNames[i], note.text, note.created, note.modified);
+            }
+            json << "\n  ]\n";
+            json << "}\n";
+            output = json.str();
+        }
+
+        DurableFile file;
+        if (!file.Open(target.string()) || !file.Write(output) || !file.Commit()) {
+            spdlog::error("[BACKUP] Conversion failed: {}", file.LastError());
+            return false;
+        }
+        auto written = std::chrono::steady_clock::now();
+
+        std::error_code ec;
+        auto sourceSize = fs::file_size(source, ec);
+        spdlog::info("[BACKUP] Converted {} notes: {} ({} bytes, read in {:.1f} ms) -> {} ({} bytes, written in {:.1f} ms)",
+                     contents.notes.size(), fileName, ec ? 0 : sourceSize,
+                     std::chrono::duration<double, std::milli>(loaded - start).count(),
+                     target.filename().string(), output.size(),
+                     std::chrono::duration<double, std::milli>(written - loaded).count());
+
+        // The copy holds the same point in time as its source, so it keeps the source's
+        // age for listing and retention
+        CatalogEntry entry;
+        entry.file = target.filename().string();
+        entry.playerName = contents.playerName;
+        if (auto sourceEntry = Catalog::Find(fileName)) {
+            entry.created = sourceEntry->created;
+        } else {
+            auto writeTime = fs::last_write_time(source, ec);
+            entry.created = ec ? std::time(nullptr)
+                               : std::chrono::system_clock::to_time_t(
+                                     std::chrono::clock_cast<std::chrono::system_clock>(writeTime));
+        }
+        entry.noteCount = static_cast<std::uint32_t>(contents.notes.size());
+        entry.size = output.size();
+        entry.hash = HashContent(output);
+        Catalog::Record(std::move(entry));
+        return true;
+    }
+
+    /**
+     * @brief Read and parse the import file (no game or NoteManager access; safe on a worker).
+     * @return Parsed notes; empty if there is no import file
+     *
+     * An incremental backup is reconstructed to the point in time it was written:
+     * its chain is followed back through Paths::BACKUP_DIR to the full backup, then
+     * the full backup and each incremental are applied in order, one pass per file.
+     */
+    ImportedNotes ParseImportFile() {
+        Perf::ScopedTimer timer(Perf::Probe::kImport);
+        Trace::Scope trace("ParseImportFile", "export");
+        ImportedNotes result;
+
+        // Check if import file exists (JSON first, then binary)
+        result.path = fs::exists(Paths::IMPORT_FILE) ? Paths::IMPORT_FILE : Paths::IMPORT_BINARY_FILE;
+        if (!fs::exists(result.path)) {
+            spdlog::info("[BACKUP] No import file found at {}", Paths::IMPORT_FILE);
+            return result;  // Not an error, just nothing to import
+        }
+
+        try {
+            // Newest first: the import file, then each backup it builds on
+            std::vector<BackupContents> chain(1);
+            if (!LoadBackupFile(result.path, chain.back())) {
+                result.error = true;
+                return result;
+            }
+            while (chain.back().incremental) {
+                std::string previous = (fs::path(Paths::BACKUP_DIR) / chain.back().previous).string();
+                if (chain.size() > 1000 || !fs::exists(previous)) {
+                    spdlog::error("[BACKUP] Incremental import needs {}, which is missing", previous);
+                    result.error = true;
+                    return result;
+                }
+                chain.emplace_back();
+                if (!LoadBackupFile(previous, chain.back())) {
+                    result.error = true;
+                    return result;
+                }
+            }
+
+            std::vector<Note> notes = std::move(chain.back().notes);
+            for (size_t i = chain.size() - 1; i-- > 0;) {
+                notes = ApplyIncremental(std::move(notes), chain[i]);
+            }
+            if (chain.size() > 1) {
+                spdlog::info("[BACKUP] Reconstructed {} notes from a chain of {} backups", notes.size(), chain.size());
+            }
+            result.notes = std::move(notes);
+        } catch (const std::exception& e) {
+            spdlog::error("[BACKUP] Import parsing failed: {}", e.what());
+            result.error = true;
+            result.notes.clear();
+        }
+
+        return result;
+    }
+
+    /**
+     * @brief Merge parsed notes into NoteManager (main thread: quests are looked up).
+     * Last writer wins: an imported note replaces a local one only if it was modified
+     * later. Deletes the import file once merged.
+     * @return Number of notes written, -1 on error
+     */
+    int ApplyImport(ImportedNotes& imported) {
+        Trace::Scope trace("ApplyImport", "export");
+        if (imported.error) {
+            return -1;
+        }
+
+        // Same validation as SaveNoteForQuest: warn, but keep notes for quests from mods not loaded right now
+        for (const auto& note : imported.notes) {
+            if (note.questID != NoteManager::GENERAL_NOTE_ID && !RE::TESForm::LookupByID<RE::TESQuest>(note.questID)) {
+                spdlog::warn("[BACKUP] Imported note for quest {:08X} not found, importing it anyway", note.questID);
+            }
+        }
+
+        // Sorted run for the merge; duplicates in the file keep their newest entry
+        std::sort(imported.notes.begin(), imported.notes.end(), [](const Note& a, const Note& b) {
+            return a.questID != b.questID ? a.questID < b.questID : a.modified > b.modified;
+        });
+        auto duplicates = std::unique(imported.notes.begin(), imported.notes.end(), [](const Note& a, const Note& b) {
+            return a.questID == b.questID;
+        });
+        imported.notes.erase(duplicates, imported.notes.end());
+
+        int importCount = static_cast<int>(NoteManager::GetSingleton()->MergeNotes(imported.notes));
+        spdlog::info("[BACKUP] Merged {} of {} imported notes from {} (older ones kept local text)",
+                     importCount, imported.notes.size(), imported.path);
+
+        if (!imported.notes.empty()) {
+
+            // Delete import file after successful import
+            try {
+                fs::remove(imported.path);
+                spdlog::info("[BACKUP] Deleted import file after successful import");
+            } catch (const fs::filesystem_error& e) {
+                spdlog::warn("[BACKUP] Failed to delete import file: {}", e.what());
+            }
+        }
+
+        return importCount;
+    }
+
+    /**
+     * @namespace DeferredImport
+     * @brief Import parsed during the load screen and applied after the co-save load.
+     *
+     * Begin() (kPreLoadGame) parses the import file on a job worker. Complete()
+     * (kPostLoadGame) marks the co-save as loaded. Whichever of the two finishes
+     * last merges the notes on the main thread, so they are always merged after
+     * NoteManager::Load (last writer wins, see ApplyImport). Neither step blocks
+     * the load.
+     */
+    namespace DeferredImport {
+        struct State {
+            std::mutex lock;
+            std::uint64_t session = 0;  // Bumped per load; results of an older load are dropped
+            bool loadDone = false;
+            std::optional<ImportedNotes> parsed;
+        };
+
+        inline State state;
+
+        /**
+         * Hands the import to the main thread once both halves are ready (lock released on return).
+         */
+        inline void TryApply(std::unique_lock<std::mutex>& lock) {
+            if (!state.loadDone || !state.parsed) {
+                return;
+            }
+            auto imported = std::make_shared<ImportedNotes>(std::move(*state.parsed));
+            state.parsed.reset();
+            lock.unlock();
+
+            if (imported->notes.empty() && !imported->error) {
+                return;  // No import file
+            }
+            JobSystem::RunOnMainThread([imported]() {
+                int importedCount = ApplyImport(*imported);
+                if (importedCount > 0) {
+                    spdlog::info("[LOAD] Merged {} imported notes with save data", importedCount);
+                }
+            });
+        }
+
+        /**
+         * @brief Start parsing the import file (a game load is starting).
+         */
+        inline void Begin() {
+            std::uint64_t session;
+            {
+                std::lock_guard lock(state.lock);
+                session = ++state.session;
+                state.loadDone = false;
+                state.parsed.reset();
+            }
+
+            JobSystem::GetSingleton()->Submit(JobPriority::kBackground, [session]() {
+                ImportedNotes imported = ParseImportFile();
+                std::unique_lock lock(state.lock);
+                if (session != state.session) {
+                    return;  // Another load started meanwhile
+                }
+                state.parsed = std::move(imported);
+                TryApply(lock);
+            });
+        }
+
+        /**
+         * @brief The co-save load has finished.
+         * @param loaded false if the game failed to load (the import file is kept for next time)
+         */
+        inline void Complete(bool loaded) {
+            std::unique_lock lock(state.lock);
+            if (!loaded) {
+                ++state.session;
+                state.parsed.reset();
+                return;
+            }
+            state.loadDone = true;
+            TryApply(lock);
+        }
+    }
+}
+
+//=============================================================================
+// Forward Declarations
+//=============================================================================
+
+namespace PapyrusBridge {
+    void ShowQuestNoteInput(RE::FormID questID);
+    void ShowGeneralNoteInput();
+    void ShowNotesListMenu();
+}
+
+//=============================================================================
+// Journal Quest Detection
+//=============================================================================
+
+[[nodiscard]] RE::FormID GetCurrentQuestInJournal() {
+    auto ui = RE::UI::GetSingleton();
+    if (!ui || !ui->IsMenuOpen("Journal Menu")) {
+        return 0;  // Not in journal
+    }
+
+    auto journalMenu = ui->GetMenu<RE::JournalMenu>();
+    if (!journalMenu) {
+        spdlog::error("[JOURNAL] Failed to get JournalMenu pointer");
+        return 0;
+    }
+
+    // Access quest tab and get selected entry
+    auto& rtData = journalMenu->GetRuntimeData();
+    auto& questsTab = rtData.questsTab;
+
+    if (!questsTab.unk18.IsObject()) {
+        return 0;
+    }
+
+    // Get selectedEntry.formID
+    RE::GFxValue selectedEntry;
+    if (!questsTab.unk18.GetMember("selectedEntry", &selectedEntry) || !selectedEntry.IsObject()) {
+        return 0;
+    }
+
+    RE::GFxValue formIDValue;
+    if (!selectedEntry.GetMember("formID", &formIDValue) || !formIDValue.IsNumber()) {
+        spdlog::warn("[JOURNAL] selectedEntry has no formID");
+        return 0;
+    }
+
+    RE::FormID questID = static_cast<RE::FormID>(formIDValue.GetUInt());
+    return questID;
+}
+
+//=============================================================================
+// UI Command Queue
+//=============================================================================
+
+enum class UICommandType : std::uint8_t {
+    kJournalOpened,     // Create the Journal overlay
+    kJournalClosed,     // Drop the Journal overlay
+    kRefreshNoteText,   // Show the note status for questID
+    kMouseHover,        // Mouse is over questID; shown unless a keyboard selection holds the text
+    kKeyboardSelect,    // questID was selected with the keyboard
+    kRefreshBadges,     // Re-check the visible quest list badges
+    kNoteChanged,       // A note was written (questID 0 = whole store reset)
+    kRenderEditor       // Push NoteEditor model changes to its TextFields
+};
+
+struct UICommand {
+    UICommandType type = UICommandType::kRefreshBadges;
+    RE::FormID questID = 0;
+    bool force = false;  // kRefreshNoteText / kRefreshBadges: update even if nothing seems to have changed
+};
+
+/**
+ * @class UICommandQueue
+ * @brief Marshals GFx updates from any thread onto the UI thread.
+ *
+ * Producers (input, Papyrus VM threads, note writers) post small commands to a
+ * lock-free MPSCQueue; one drain per burst runs as an SKSE UI task and coalesces
+ * them: the last Journal open/close wins and each kind of refresh runs at most
+ * once. Producers post raw facts (hovered or selected questID); decisions that
+ * depend on JournalNoteHelper state are made in the drain, so that state is only
+ * touched on the UI thread. If the queue overflows, the drain resynchronizes from the menu state
+ * and refreshes everything.
+ *
+ * @thread_safety Post() from any thread; everything else runs on the UI thread.
+ */
+class UICommandQueue {
+public:
+    static constexpr size_t kQueueCapacity = 256;
+
+    /**
+     * @brief Get the singleton instance.
+     * @return Pointer to singleton instance (never null)
+     */
+    static UICommandQueue* GetSingleton() {
+        static UICommandQueue instance;
+        return &instance;
+    }
+
+    /**
+     * @brief Queue a command and make sure a drain is scheduled.
+     */
+    void Post(const UICommand& command) {
+        if (!queue_.TryPush(command)) {
+            overflowed_.store(true, std::memory_order_release);
+        }
+
+        // Schedule one drain per burst
+        if (!drainScheduled_.exchange(true, std::memory_order_acq_rel)) {
+            if (auto tasks = SKSE::GetTaskInterface()) {
+                tasks->AddUITask([this]() { Drain(); });
+            } else {
+                drainScheduled_.store(false, std::memory_order_release);
+            }
+        }
+    }
+
+private:
+    UICommandQueue() = default;
+
+    /**
+     * Applies all queued commands (UI thread; defined after the UI classes it drives).
+     */
+    void Drain();
+
+    MPSCQueue<UICommand, kQueueCapacity> queue_;
+    std::atomic<bool> drainScheduled_{ false };
+    std::atomic<bool> overflowed_{ false };
+};
+
+//=============================================================================
+// Journal Note Helper
+//=============================================================================
+
+/**
+ * @class JournalNoteHelper
+ * @brief Manages UI overlay in Journal Menu showing note status.
+ *
+ * Creates and manages a TextField in the Journal Menu that displays whether
+ * the selected quest has an associated note. Handles lifecycle (open/close)
+ * and updates text based on quest selection changes.
+ */
+class JournalNoteHelper {
+public:
+    /**
+     * @brief Get the singleton instance.
+     * @return Pointer to singleton instance (never null)
+     */
+    static JournalNoteHelper* GetSingleton() {
+        static JournalNoteHelper instance;
+        return &instance;
+    }
+
+    /**
+     * @brief Initialize UI elements when Journal Menu opens.
+     *
+     * Creates TextField overlay with configured position and styling.
+     * Stores references to GFx objects and journal menu.
+     */
+    void OnJournalOpen();
+
+    /**
+     * @brief Cleanup when Journal Menu closes.
+     *
+     * Clears GFx object references and resets state tracking.
+     */
+    void OnJournalClose();
+
+    /**
+     * @brief Update TextField to reflect note status for current quest.
+     * @param questID The currently selected quest FormID (0 = none selected)
+     * @param forceUpdate If true, update even if quest hasn't changed
+     */
+    void UpdateTextField(RE::FormID questID, bool forceUpdate = false);
+
+    /**
+     * @brief Badge the visible quest list entries that have a note.
+     * @param force Refresh even if the list has not scrolled since the last call
+     *
+     * One batched NoteManager query for the visible window, then a single
+     * UpdateList() repaint, and only if a badge actually changed.
+     */
+    void RefreshBadges(bool force = false);
+
+    /**
+     * @brief Mark quest as keyboard-selected (UI thread, from the drain).
+     * @param questID The quest selected via keyboard
+     */
+    void SetKeyboardSelection(RE::FormID questID) {
+        keyboardSelectedQuest_ = questID;
+        lastInputWasKeyboard_ = true;
+    }
+
+    /**
+     * @brief Subscribe to NoteManager so the TextField follows note changes.
+     *
+     * Notes can be written from Papyrus VM threads or other plugins, so the sync
+     * callback only posts a command; GFx is touched when the UI thread drains it.
+     */
+    static void Register() {
+        NoteManager::GetSingleton()->Subscribe("JournalNoteHelper", NoteDelivery::kSync,
+            [](const NoteChangeEvent& event) {
+                RE::FormID questID = event.kind == NoteChangeKind::kReset ? 0 : event.questID;
+                UICommandQueue::GetSingleton()->Post({ UICommandType::kNoteChanged, questID });
+            });
+    }
+
+    /**
+     * @brief True if a note change for questID (0 = reset) affects the displayed text.
+     */
+    [[nodiscard]] bool IsAffectedBy(RE::FormID questID) const {
+        return lastQuestID_ != 0 && (questID == 0 || questID == lastQuestID_);
+    }
+
+    /**
+     * @brief Re-render the TextField for the quest it currently shows.
+     */
+    void RefreshNoteText() {
+        if (lastQuestID_ != 0) {
+            UpdateTextField(lastQuestID_, true);
+        }
+    }
+
+    [[nodiscard]] bool IsJournalOpen() const {
+        return journalMenu_ != nullptr;
+    }
+
+    /**
+     * @brief Quest the TextField currently shows (0 = none).
+     */
+    [[nodiscard]] RE::FormID GetShownQuest() const {
+        return lastQuestID_;
+    }
+
+    /**
+     * @brief Decide whether a mouse hover should change the TextField (UI thread, from the drain).
+     * @param questID The quest under mouse cursor
+     * @param shownQuestID Quest the TextField will show once the drain finishes
+     * @return true if the TextField should show questID
+     */
+    bool AcceptMouseHover(RE::FormID questID, RE::FormID shownQuestID) {
+        // If quest changed from keyboard selection, switch to mouse mode
+        if (questID != keyboardSelectedQuest_) {
+            lastInputWasKeyboard_ = false;
+        }
+
+        // Only update if not in keyboard mode, or if quest actually changed
+        return !lastInputWasKeyboard_ || questID != shownQuestID;
+    }
+
+private:
+    JournalNoteHelper() = default;
+
+    /**
+     * Checks if the helper is properly initialized and ready to use.
+     * @return true if TextField and menu references are valid
+     */
+    bool IsInitialized() const {
+        return noteTextField_.IsObject() && journalMenu_ != nullptr;
+    }
+
+    RE::GFxValue noteTextField_;
+    RE::GFxValue textFormat_;
+    RE::GPtr<RE::JournalMenu> journalMenu_;
+    RE::FormID lastQuestID_ = 0;        // Track last quest to detect changes
+    RE::FormID keyboardSelectedQuest_ = 0;  // Track keyboard-selected quest
+    bool lastInputWasKeyboard_ = false;     // True if last selection was via keyboard
+    std::int32_t lastBadgeScroll_ = -1;     // Quest list scroll position of the last badge refresh
+    std::uint32_t lastBadgeListSize_ = 0;   // Quest list size of the last badge refresh
+};
+
+//=============================================================================
+// Journal Note Helper Implementation
+//=============================================================================
+
+void JournalNoteHelper::OnJournalOpen() {
+    // Reload settings if INI was modified (dMenu changes)
+    SettingsManager::GetSingleton()->ReloadIfChanged();
+
+    auto ui = RE::UI::GetSingleton();
+    if (!ui) {
+        spdlog::error("[HELPER] Failed to get UI singleton");
+        return;
+    }
+
+    auto journalMenu = ui->GetMenu<RE::JournalMenu>();
+    if (!journalMenu) {
+        spdlog::error("[HELPER] Failed to get Journal Menu");
+        return;
+    }
+
+    // Store journal menu reference
+    journalMenu_ = journalMenu;
+
+    // Create TextField in Journal's _root
+    if (journalMenu->uiMovie) {
+        RE::GFxValue root;
+        if (journalMenu->uiMovie->GetVariable(&root, "_root")) {
+            RE::GFxValue textField;
+            RE::GFxValue createArgs[6];
+            auto settings = SettingsManager::GetSingleton();
+            createArgs[0].SetString("questNoteTextField");           // name
+            createArgs[1].SetNumber(UIConstants::TEXTFIELD_TOP_DEPTH);   // VERY high depth to be on absolute top
+            createArgs[2].SetNumber(settings->textFieldX);           // TOP-LEFT x position
+            createArgs[3].SetNumber(settings->textFieldY);           // TOP-LEFT y position
+            createArgs[4].SetNumber(settings->previewWidth);                 // width (previews are wrapped to it)
+            createArgs[5].SetNumber(UIConstants::TEXTFIELD_DEFAULT_HEIGHT);  // height
+
+            root.Invoke("createTextField", &textField, createArgs, 6);
+
+            if (textField.IsObject()) {
+                // Create TextFormat object
+                RE::GFxValue textFormat;
+                journalMenu->uiMovie->CreateObject(&textFormat, "TextFormat");
+
+                if (textFormat.IsObject()) {
+                    textFormat.SetMember("font", "$EverywhereBoldFont");
+                    textFormat.SetMember("size", settings->textFieldFontSize);
+                    textFormat.SetMember("color", settings->textFieldColor);
+
+                    // Apply defaultTextFormat
+                    textField.SetMember("defaultTextFormat", textFormat);
+                }
+
+                // Configure TextField
+                textField.SetMember("embedFonts", true);
+                textField.SetMember("selectable", false);
+                textField.SetMember("multiline", true);  // Preview lines arrive pre-wrapped
+                textField.SetMember("autoSize", "left");
+                textField.SetMember("text", "");
+
+                // Apply format to existing text
+                if (textFormat.IsObject()) {
+                    textField.Invoke("setTextFormat", nullptr, &textFormat, 1);
+                }
+
+                // Store references
+                noteTextField_ = textField;
+                textFormat_ = textFormat;
+
+                // Get initial quest and update TextField
+                RE::FormID currentQuest = GetCurrentQuestInJournal();
+                UpdateTextField(currentQuest);
+                lastQuestID_ = currentQuest;  // Initialize tracking
+            } else {
+                spdlog::error("[HELPER] createTextField failed");
+            }
+        }
+    }
+
+    RefreshBadges(true);
+}
+
+void JournalNoteHelper::OnJournalClose() {
+    // Clear references
+    noteTextField_.SetUndefined();
+    textFormat_.SetUndefined();
+    journalMenu_ = nullptr;
+    lastQuestID_ = 0;              // Reset tracking
+    keyboardSelectedQuest_ = 0;    // Reset keyboard selection
+    lastInputWasKeyboard_ = false;
+    lastBadgeScroll_ = -1;
+    lastBadgeListSize_ = 0;
+}
+
+void JournalNoteHelper::UpdateTextField(RE::FormID questID, bool forceUpdate) {
+    Perf::ScopedTimer timer(Perf::Probe::kUpdateTextField);
+
+    if (!IsInitialized()) {
+        return; // Helper not properly initialized
+    }
+
+    // Only update if quest changed (prevent spam), unless forced
+    if (!forceUpdate && questID == lastQuestID_) {
+        return;
+    }
+
+    lastQuestID_ = questID;  // Track current quest
+
+    std::string message;
+
+    if (questID == 0) {
+        // No quest selected - clear text
+        message = "";
+    } else {
+        // Cached preview: no copy of the full note and no re-wrap while hovering the list
+        std::string preview;
+        bool hasNote = NotePreviewCache::GetSingleton()->Get(questID, preview);
+
+        if (hasNote) {
+            message = "Press , to edit note";
+            if (!preview.empty()) {
+                message += '\n';
+                message += preview;
+            }
+        } else {
+            message = "Press , to add note";
+        }
+    }
+
+    // Update text
+    noteTextField_.SetMember("text", message.c_str());
+
+    // Reapply format (needed after text change)
+    if (textFormat_.IsObject()) {
+        noteTextField_.Invoke("setTextFormat", nullptr, &textFormat_, 1);
+    }
+}
+
+void JournalNoteHelper::RefreshBadges(bool force) {
+    if (!journalMenu_ || !SettingsManager::GetSingleton()->noteBadges) {
+        return;
+    }
+
+    auto& questList = journalMenu_->GetRuntimeData().questsTab.unk18;
+    RE::GFxValue entryList;
+    if (!questList.IsObject() || !questList.GetMember("entryList", &entryList) || !entryList.IsArray()) {
+        return;
+    }
+
+    // Nothing to do unless the list scrolled, was repopulated or notes changed
+    RE::GFxValue scrollValue;
+    questList.GetMember("scrollPosition", &scrollValue);
+    auto scroll = scrollValue.IsNumber() ? static_cast<std::int32_t>(scrollValue.GetNumber()) : 0;
+    std::uint32_t size = entryList.GetArraySize();
+    if (!force && scroll == lastBadgeScroll_ && size == lastBadgeListSize_) {
+        return;
+    }
+    lastBadgeScroll_ = scroll;
+    lastBadgeListSize_ = size;
+
+    // Visible window: gather entries and their FormIDs
+    constexpr size_t kWindow = UIConstants::NOTE_BADGE_WINDOW;
+    std::array<RE::GFxValue, kWindow> entries;
+    std::array<RE::FormID, kWindow> questIDs{};
+    std::array<bool, kWindow> hasNote{};
+    size_t count = 0;
+
+    for (std::uint32_t i = static_cast<std::uint32_t>(std::max(scroll, 0)); i < size && count < kWindow; ++i) {
+        RE::GFxValue formIDValue;
+        if (entryList.GetElement(i, &entries[count]) && entries[count].IsObject() &&
+            entries[count].GetMember("formID", &formIDValue) && formIDValue.IsNumber()) {
+            questIDs[count++] = static_cast<RE::FormID>(formIDValue.GetUInt());
+        }
+    }
+
+    NoteManager::GetSingleton()->HasNotes(std::span(questIDs.data(), count), std::span(hasNote.data(), count));
+
+    // Rewrite only the entries whose badge changed; the untouched title is kept on the entry
+    bool changed = false;
+    for (size_t i = 0; i < count; ++i) {
+        RE::GFxValue badged;
+        entries[i].GetMember("personalNotesBadge", &badged);
+        bool isBadged = badged.IsBool() && badged.GetBool();
+        if (isBadged == hasNote[i]) {
+            continue;
+        }
+
+        RE::GFxValue title;
+        if (!isBadged) {
+            entries[i].GetMember("text", &title);
+            if (!title.IsString()) {
+                continue;
+            }
+            entries[i].SetMember("personalNotesText", title);
+            std::string text = std::string(title.GetString()) + UIConstants::NOTE_BADGE;
+            entries[i].SetMember("text", text.c_str());
+        } else {
+            entries[i].GetMember("personalNotesText", &title);
+            if (title.IsString()) {
+                entries[i].SetMember("text", title);
+            }
+        }
+        entries[i].SetMember("personalNotesBadge", hasNote[i]);
+        changed = true;
+    }
+
+    if (changed) {
+        questList.Invoke("UpdateList");
+    }
+}
+
+//=============================================================================
+// Performance Overlay
+//=============================================================================
+
+/**
+ * @class PerfOverlay
+ * @brief Debug TextField in the HUD showing p50/p99 of the Perf probes.
+ *
+ * Enabled with [Debug] bPerfOverlay=1. Uses the same createTextField technique as
+ * JournalNoteHelper, on the HUD Menu movie. Refreshed twice a second from the
+ * frame hook; the TextField is recreated if the HUD movie changes (e.g. after
+ * returning to the main menu).
+ */
+class PerfOverlay {
+public:
+    static constexpr auto kRefreshInterval = std::chrono::milliseconds(500);
+
+    /**
+     * @brief Get the singleton instance.
+     * @return Pointer to singleton instance (never null)
+     */
+    static PerfOverlay* GetSingleton() {
+        static PerfOverlay instance;
+        return &instance;
+    }
+
+    /**
+     * @brief Refresh the overlay if enabled (main thread, once per frame).
+     */
+    void Update() {
+        auto now = std::chrono::steady_clock::now();
+        if (now - lastRefresh_ < kRefreshInterval) {
+            return;
+        }
+        lastRefresh_ = now;
+
+        auto ui = RE::UI::GetSingleton();
+        bool enabled = SettingsManager::GetSingleton()->perfOverlay;
+        if (!enabled || !ui || !ui->IsMenuOpen(RE::HUDMenu::MENU_NAME)) {
+            Release();
+            return;
+        }
+
+        auto hudMenu = ui->GetMenu(RE::HUDMenu::MENU_NAME);
+        if (hudMenu != hudMenu_) {
+            Release();
+            Create(hudMenu);
+        }
+
+        if (textField_.IsObject()) {
+            std::string text = Perf::FormatSummaries();
+            textField_.SetMember("text", text.c_str());
+        }
+    }
+
+private:
+    PerfOverlay() = default;
+
+    void Create(const RE::GPtr<RE::IMenu>& hudMenu) {
+        if (!hudMenu || !hudMenu->uiMovie) {
+            return;
+        }
+
+        RE::GFxValue root;
+        if (!hudMenu->uiMovie->GetVariable(&root, "_root")) {
+            return;
+        }
+
+        RE::GFxValue textField;
+        RE::GFxValue createArgs[6];
+        createArgs[0].SetString("personalNotesPerfOverlay");
+        createArgs[1].SetNumber(UIConstants::TEXTFIELD_TOP_DEPTH);
+        createArgs[2].SetNumber(UIConstants::PERF_OVERLAY_X);
+        createArgs[3].SetNumber(UIConstants::PERF_OVERLAY_Y);
+        createArgs[4].SetNumber(UIConstants::TEXTFIELD_DEFAULT_WIDTH);
+        createArgs[5].SetNumber(UIConstants::TEXTFIELD_DEFAULT_HEIGHT);
+        root.Invoke("createTextField", &textField, createArgs, 6);
+
+        if (!textField.IsObject()) {
+            spdlog::error("[PERF] createTextField failed in HUD Menu");
+            return;
+        }
+
+        RE::GFxValue textFormat;
+        hudMenu->uiMovie->CreateObject(&textFormat, "TextFormat");
+        if (textFormat.IsObject()) {
+            textFormat.SetMember("font", "$EverywhereMediumFont");
+            textFormat.SetMember("size", UIConstants::PERF_OVERLAY_FONT_SIZE);
+            textFormat.SetMember("color", 0xFFFF00);
+            textField.SetMember("defaultTextFormat", textFormat);
+        }
+
+        textField.SetMember("embedFonts", true);
+        textField.SetMember("selectable", false);
+        textField.SetMember("multiline", true);
+        textField.SetMember("autoSize", "left");
+
+        hudMenu_ = hudMenu;
+        textField_ = textField;
+    }
+
+    void Release() {
+        if (textField_.IsObject()) {
+            textField_.Invoke("removeTextField");
+        }
+        textField_.SetUndefined();
+        hudMenu_ = nullptr;
+    }
+
+    RE::GFxValue textField_;
+    RE::GPtr<RE::IMenu> hudMenu_;  // Keeps the movie alive while we hold textField_
+    std::chrono::steady_clock::time_point lastRefresh_;
+};
+
+//=============================================================================
+// Blocked Key Map
+//=============================================================================
+
+/**
+ * @class BlockedKeyMap
+ * @brief Per-device bitmap of button codes bound to a gameplay user event.
+ *
+ * Precomputes what ControlMap::GetUserEventName(code, device) != "" answers, so
+ * the dispatch hook can filter a button with one bit test instead of a linear
+ * search over the device's mappings per event. The filter only runs once the
+ * hook is installed (InputDispatchHook); bench/InputReplayBench compares both
+ * lookups on a replayed event stream.
+ *
+ * Built lazily on first use and rebuilt after Invalidate(). Controls are remapped
+ * from the Journal's settings pages, so InputHandler invalidates on Journal close.
+ * Input is dispatched on the main thread only; no locking.
+ */
+class BlockedKeyMap {
+public:
+    static constexpr size_t kDeviceCount = static_cast<size_t>(RE::INPUT_DEVICE::kTotal);
+
+    /**
+     * @brief Get the singleton instance.
+     * @return Pointer to singleton instance (never null)
+     */
+    static BlockedKeyMap* GetSingleton() {
+        static BlockedKeyMap instance;
+        return &instance;
+    }
+
+    /**
+     * @brief Check whether a button is bound to a gameplay control.
+     * @param device Input device of the event
+     * @param code Button idCode of the event
+     */
+    [[nodiscard]] bool IsBound(RE::INPUT_DEVICE device, std::uint32_t code) {
+        if (dirty_) {
+            Rebuild();
+        }
+        return bound_.Test(static_cast<size_t>(device), code);
+    }
+
+    /**
+     * @brief Rebuild before the next lookup (control map may have changed).
+     */
+    void Invalidate() {
+        dirty_ = true;
+    }
+
+private:
+    BlockedKeyMap() = default;
+
+    void Rebuild() {
+        auto ctrlMap = RE::ControlMap::GetSingleton();
+        if (!ctrlMap) {
+            return;  // Stay dirty; nothing bound until the control map exists
+        }
+
+        auto context = ctrlMap->controlMap[static_cast<size_t>(RE::UserEvents::INPUT_CONTEXT_ID::kGameplay)];
+        if (!context) {
+            return;
+        }
+
+        size_t boundCount = 0;
+        bound_.Clear();
+        for (size_t device = 0; device < kDeviceCount; ++device) {
+            for (const auto& mapping : context->deviceMappings[device]) {
+                if (!mapping.eventID.empty()) {
+                    bound_.Set(device, mapping.inputKey);
+                    ++boundCount;
+                }
+            }
+        }
+
+        dirty_ = false;
+        spdlog::info("[HOOK] Blocked key map rebuilt ({} bound controls)", boundCount);
+    }
+
+    InputTables::ControlBitmap<kDeviceCount> bound_;
+    bool dirty_ = true;
+};
+
+//=============================================================================
+// Frame Update Hook
+//=============================================================================
+
+/**
+ * Per-frame callback on the main thread. Hooks the empty call in Main::Update
+ * (the same spot other HUD plugins use) and drives the FrameScheduler from it.
+ */
+class FrameUpdateHook {
+public:
+    static void Install() {
+        auto& trampoline = SKSE::GetTrampoline();
+        REL::Relocation<uintptr_t> caller{ RELOCATION_ID(35565, 36564) };  // Main::Update
+        _Nullsub = trampoline.write_call<5>(caller.address() + RELOCATION_OFFSET(0x748, 0xC26), Nullsub);
+        FrameScheduler::GetSingleton()->SetReporter(LogFrameSchedulerReport);
+        spdlog::info("[HOOK] Frame update hook installed");
+    }
+
+private:
+    static void Nullsub() {
+        _Nullsub();
+        FrameScheduler::GetSingleton()->Tick();
+        PerfOverlay::GetSingleton()->Update();
+    }
+
+    static inline REL::Relocation<decltype(Nullsub)> _Nullsub;
+};
+
+//=============================================================================
+// Hotkey Dispatcher
+//=============================================================================
+
+using InputTables::HotkeyAction;
+using InputTables::HotkeyTable;
+
+static_assert(static_cast<std::uint32_t>(RE::INPUT_DEVICE::kKeyboard) == std::to_underlying(InputTables::Device::kKeyboard) &&
+              static_cast<std::uint32_t>(RE::INPUT_DEVICE::kMouse) == std::to_underlying(InputTables::Device::kMouse) &&
+              static_cast<std::uint32_t>(RE::INPUT_DEVICE::kGamepad) == std::to_underlying(InputTables::Device::kGamepad));
+
+namespace KeyModifiers {
+    using namespace InputTables::KeyModifiers;  // SHIFT, CTRL, ALT, COMBINATIONS
+
+    /**
+     * Modifier keys currently held (physical state, so no state is lost to filtered events).
+     */
+    inline std::uint8_t Current() {
+        std::uint8_t mask = 0;
+        if (GetAsyncKeyState(VK_SHIFT) & 0x8000) mask |= SHIFT;
+        if (GetAsyncKeyState(VK_CONTROL) & 0x8000) mask |= CTRL;
+        if (GetAsyncKeyState(VK_MENU) & 0x8000) mask |= ALT;
+        return mask;
+    }
+}
+
+/**
+ * @class HotkeyDispatcher
+ * @brief Builds the HotkeyTable (InputTables.h) from settings.
+ *
+ * The table is rebuilt from SettingsManager whenever its generation changes and
+ * published with an atomic shared_ptr swap, so a batch always sees one
+ * consistent table.
+ */
+class HotkeyDispatcher {
+public:
+    using Table = HotkeyTable;
+
+    /**
+     * @brief Get the singleton instance.
+     * @return Pointer to singleton instance (never null)
+     */
+    static HotkeyDispatcher* GetSingleton() {
+        static HotkeyDispatcher instance;
+        return &instance;
+    }
+
+    /**
+     * @brief Map a device-specific button code to the shared key code space.
+     * @return Key code, or Table::KEY_CODE_COUNT if the button has no key code
+     */
+    [[nodiscard]] static std::uint32_t ToKeyCode(RE::INPUT_DEVICE device, std::uint32_t idCode) {
+        return Table::ToKeyCode(static_cast<InputTables::Device>(device), idCode);
+    }
+
+    /**
+     * @brief Current table, rebuilt first if settings changed since it was built.
+     *
+     * Call once per input batch (main thread).
+     */
+    [[nodiscard]] std::shared_ptr<const Table> Acquire() {
+        auto table = table_.load(std::memory_order_acquire);
+        std::uint32_t generation = SettingsManager::GetSingleton()->GetGeneration();
+        if (!table || table->settingsGeneration != generation) {
+            table = Build(generation);
+            table_.store(table, std::memory_order_release);
+        }
+        return table;
+    }
+
+private:
+    HotkeyDispatcher() = default;
+
+    static std::shared_ptr<const Table> Build(std::uint32_t generation) {
+        auto table = std::make_shared<Table>();
+        table->settingsGeneration = generation;
+        size_t bindingCount = 0;
+
+        auto bind = [&](int keyCode, int modifiers, HotkeyAction action) {
+            if (keyCode <= 0 || keyCode >= static_cast<int>(Table::KEY_CODE_COUNT)) {
+                return;  // 0 = unbound
+            }
+            if (!table->Bind(static_cast<std::uint32_t>(keyCode), static_cast<std::uint8_t>(modifiers), action)) {
+                spdlog::warn("[INPUT] Key {} (modifiers {}) is bound twice, using the later binding", keyCode, modifiers);
+            }
+            ++bindingCount;
+        };
+
+        // Journal navigation keys
+        bind(KeyCodes::ARROW_UP, 0, HotkeyAction::kJournalKeyNavigate);
+        bind(KeyCodes::ARROW_DOWN, 0, HotkeyAction::kJournalKeyNavigate);
+        bind(KeyCodes::PAGE_UP, 0, HotkeyAction::kJournalKeyNavigate);
+        bind(KeyCodes::PAGE_DOWN, 0, HotkeyAction::kJournalKeyNavigate);
+        bind(KeyCodes::MOUSE_LEFT, 0, HotkeyAction::kJournalMouseSelect);
+        bind(KeyCodes::MOUSE_WHEEL_UP, 0, HotkeyAction::kJournalScroll);
+        bind(KeyCodes::MOUSE_WHEEL_DOWN, 0, HotkeyAction::kJournalScroll);
+
+        // User hotkeys (bound last so they win over navigation keys)
+        auto settings = SettingsManager::GetSingleton();
+        bind(settings->noteHotkeyScanCode, settings->noteHotkeyModifiers, HotkeyAction::kNoteInput);
+        bind(settings->noteGamepadButton, 0, HotkeyAction::kNoteInput);
+        bind(settings->quickAccessScanCode, settings->quickAccessModifiers, HotkeyAction::kQuickAccess);
+        bind(settings->quickAccessGamepadButton, 0, HotkeyAction::kQuickAccess);
+
+        spdlog::info("[INPUT] Hotkey table built ({} bindings)", bindingCount);
+        return table;
+    }
+
+    std::atomic<std::shared_ptr<const Table>> table_;
+};
+
+//=============================================================================
+// Note Editor Menu
+//=============================================================================
+
+/**
+ * @class NoteEditor
+ * @brief Native note editor: NoteEditorModel state plus the menu session around it.
+ *
+ * Replaces the Papyrus → Extended Vanilla Menus round trip for single-note
+ * editing. Opening is a UI message, keys and characters are taken straight from
+ * InputDispatchHook while the menu is open, and saving writes to NoteManager
+ * directly, so the VM is never involved.
+ *
+ * The menu movie (Interface/PersonalNotes/NoteEditor.swf, shipped in mod/) is an
+ * empty 1280x720 AS2 stage with a single frame; the panel and TextFields are
+ * created from here. If the movie is missing, or with [Editor] bNativeEditor=0,
+ * the Papyrus dialogs are used instead.
+ *
+ * KEYS: Enter = new line, Ctrl+Enter / Ctrl+S = save, Esc = cancel,
+ *       Ctrl+Z / Ctrl+Y = undo / redo, Ctrl+A = select all, Ctrl+X/C/V = clipboard,
+ *       Shift extends the selection, Ctrl moves/deletes by word.
+ *       Gamepad: Start = save, B = cancel (the hotkey can be a gamepad button,
+ *       and the menu is modal, so a controller alone must be able to leave it).
+ */
+class NoteEditor {
+public:
+    static constexpr const char* MENU_NAME = "PersonalNotes Editor";
+    static constexpr const char* MOVIE_PATH = "PersonalNotes/NoteEditor";
+    static constexpr const char* MOVIE_FILE = "Data/Interface/PersonalNotes/NoteEditor.swf";
+
+    /**
+     * @brief Get the singleton instance.
+     * @return Pointer to singleton instance (never null)
+     */
+    static NoteEditor* GetSingleton() {
+        static NoteEditor instance;
+        return &instance;
+    }
+
+    /**
+     * @brief Register the menu with the UI (kDataLoaded).
+     */
+    static void Register();
+
+    /**
+     * @brief True if the native editor should be used instead of the Papyrus dialogs.
+     */
+    [[nodiscard]] bool IsAvailable() const {
+        return registered_ && SettingsManager::GetSingleton()->nativeEditor;
+    }
+
+    /**
+     * @brief True from OnMenuShown() until the menu has closed; input belongs to the editor meanwhile.
+     */
+    [[nodiscard]] bool IsOpen() const {
+        return state_.load(std::memory_order_acquire) == State::kOpen;
+    }
+
+    /**
+     * @brief Open the editor for a note (main thread).
+     * @param questID Quest FormID, or NoteManager::GENERAL_NOTE_ID
+     * @return false if the editor is unavailable or already open
+     */
+    bool Open(RE::FormID questID, std::string title, std::string_view text);
+
+    /**
+     * @brief Feed an input event to the editor (main thread, from InputDispatchHook).
+     * @return true if the event was consumed (always, while open)
+     */
+    bool HandleEvent(const RE::InputEvent& event);
+
+    /**
+     * @brief Push pending model changes to the TextFields (UICommandQueue drain).
+     */
+    void Flush();
+
+    void OnMenuShown(RE::IMenu* menu);
+    void OnMenuHidden();
+
+    /**
+     * @brief Forget a pending or open session (kPreLoadGame); the loading screen hides the menu anyway.
+     */
+    void Reset();
+
+private:
+    static constexpr float kRepeatDelay = 0.4f;     // Seconds before a held key repeats
+    static constexpr float kRepeatInterval = 0.04f;
+    static constexpr auto kShowTimeout = std::chrono::seconds(5);  // kShow posted but the menu never appeared
+
+    enum class State : std::uint8_t {
+        kClosed,
+        kOpening,  // kShow posted, waiting for OnMenuShown()
+        kOpen
+    };
+
+    NoteEditor() = default;
+
+    bool HandleKey(std::uint32_t keyCode, std::uint8_t modifiers);
+    void HandleChar(std::uint32_t codePoint);
+    void Save();
+    void Close();
+
+    void CreateFields(RE::GFxMovieView* movie);
+    void Render();
+    [[nodiscard]] std::string BuildBodyHTML() const;
+
+    static std::string GetClipboardText();
+    static void SetClipboardText(const std::string& text);
+
+    NoteEditorModel model_{ NoteUtils::MAX_NOTE_LENGTH };
+    RE::FormID questID_ = 0;
+    std::string title_;
+
+    RE::GFxValue titleField_;
+    RE::GFxValue bodyField_;
+    RE::GFxValue hintField_;
+
+    std::atomic<State> state_{ State::kClosed };
+    bool registered_ = false;
+    bool dirty_ = false;
+    std::chrono::steady_clock::time_point openedAt_;
+
+    std::uint32_t repeatKey_ = 0;  // Held key and its next repeat time (heldDownSecs)
+    float nextRepeat_ = 0.0f;
+};
+
+/**
+ * Menu shell for NoteEditor: pauses the game, shows the cursor and owns the movie.
+ */
+class NoteEditorMenu : public RE::IMenu {
+public:
+    NoteEditorMenu() {
+        auto scaleform = RE::BSScaleformManager::GetSingleton();
+        if (!scaleform || !scaleform->LoadMovie(this, uiMovie, NoteEditor::MOVIE_PATH)) {
+            spdlog::error("[EDITOR] Failed to load {}", NoteEditor::MOVIE_PATH);
+        }
+
+        depthPriority = 3;
+        menuFlags.set(RE::UI_MENU_FLAGS::kPausesGame,
+                      RE::UI_MENU_FLAGS::kModal,
+                      RE::UI_MENU_FLAGS::kUsesCursor,
+                      RE::UI_MENU_FLAGS::kAllowTextInput,
+                      RE::UI_MENU_FLAGS::kDisablePauseMenu);
+        inputContext = Context::kMenuMode;
+    }
+
+    static RE::IMenu* Create() {
+        return new NoteEditorMenu();
+    }
+
+    RE::UI_MESSAGE_RESULTS ProcessMessage(RE::UIMessage& a_message) override {
+        switch (*a_message.type) {
+        case RE::UI_MESSAGE_TYPE::kShow:
+            NoteEditor::GetSingleton()->OnMenuShown(this);
+            return RE::UI_MESSAGE_RESULTS::kHandled;
+        case RE::UI_MESSAGE_TYPE::kHide:
+        case RE::UI_MESSAGE_TYPE::kForceHide:
+            NoteEditor::GetSingleton()->OnMenuHidden();
+            return RE::UI_MESSAGE_RESULTS::kHandled;
+        default:
+            return RE::IMenu::ProcessMessage(a_message);
+        }
+    }
+};
+
+void NoteEditor::Register() {
+    auto ui = RE::UI::GetSingleton();
+    if (!ui) {
+        spdlog::error("[EDITOR] Failed to get UI singleton");
+        return;
+    }
+
+    std::error_code ec;
+    if (!std::filesystem::exists(MOVIE_FILE, ec)) {
+        spdlog::warn("[EDITOR] {} not found (incomplete install?), using Papyrus dialogs", MOVIE_FILE);
+        return;
+    }
+
+    ui->Register(MENU_NAME, NoteEditorMenu::Create);
+    GetSingleton()->registered_ = true;
+    spdlog::info("[EDITOR] Native note editor registered");
+}
+
+bool NoteEditor::Open(RE::FormID questID, std::string title, std::string_view text) {
+    if (!IsAvailable()) {
+        return false;
+    }
+
+    // One editor at a time; repeats while it is opening are dropped here. A show
+    // that never arrived (menu failed to open) stops blocking after kShowTimeout.
+    State expected = State::kClosed;
+    if (!state_.compare_exchange_strong(expected, State::kOpening, std::memory_order_acq_rel)) {
+        if (expected != State::kOpening || std::chrono::steady_clock::now() - openedAt_ < kShowTimeout) {
+            spdlog::info("[EDITOR] Already open, ignoring");
+            return true;
+        }
+        spdlog::warn("[EDITOR] Previous open never showed the menu, retrying");
+    }
+
+    auto queue = RE::UIMessageQueue::GetSingleton();
+    if (!queue) {
+        state_.store(State::kClosed, std::memory_order_release);
+        return false;
+    }
+
+    questID_ = questID;
+    title_ = std::move(title);
+    model_.SetText(text);
+    repeatKey_ = 0;
+    openedAt_ = std::chrono::steady_clock::now();
+    Trace::Instant("NoteEditor::Open", "editor");
+
+    queue->AddMessage(MENU_NAME, RE::UI_MESSAGE_TYPE::kShow, nullptr);
+    return true;
+}
+
+void NoteEditor::OnMenuShown(RE::IMenu* menu) {
+    Perf::Record(Perf::Probe::kEditorOpen, std::chrono::steady_clock::now() - openedAt_);
+
+    if (auto controlMap = RE::ControlMap::GetSingleton()) {
+        controlMap->AllowTextEntry(true);  // Enables CharEvents
+    }
+
+    if (menu && menu->uiMovie) {
+        CreateFields(menu->uiMovie.get());
+    }
+    dirty_ = true;
+    Render();
+    state_.store(State::kOpen, std::memory_order_release);
+}
+
+void NoteEditor::OnMenuHidden() {
+    if (auto controlMap = RE::ControlMap::GetSingleton()) {
+        controlMap->AllowTextEntry(false);
+    }
+
+    titleField_.SetUndefined();
+    bodyField_.SetUndefined();
+    hintField_.SetUndefined();
+    state_.store(State::kClosed, std::memory_order_release);
+}
+
+void NoteEditor::Reset() {
+    if (state_.exchange(State::kClosed, std::memory_order_acq_rel) != State::kClosed) {
+        spdlog::info("[EDITOR] Session reset on game load");
+    }
+    repeatKey_ = 0;
+}
+
+bool NoteEditor::HandleEvent(const RE::InputEvent& event) {
+    if (event.GetDevice() == RE::INPUT_DEVICE::kMouse) {
+        return false;  // The menu cursor still needs the mouse
+    }
+
+    if (event.eventType == RE::INPUT_EVENT_TYPE::kChar) {
+        HandleChar(static_cast<const RE::CharEvent&>(event).keyCode);
+        return true;
+    }
+
+    auto buttonEvent = event.AsButtonEvent();
+    if (!buttonEvent) {
+        return true;
+    }
+    if (buttonEvent->GetDevice() == RE::INPUT_DEVICE::kGamepad) {
+        if (buttonEvent->IsDown()) {
+            switch (HotkeyTable::ToKeyCode(InputTables::Device::kGamepad, buttonEvent->GetIDCode())) {
+            case KeyCodes::GAMEPAD_START:
+                Save();
+                break;
+            case KeyCodes::GAMEPAD_B:
+                Close();
+                break;
+            default:
+                break;
+            }
+        }
+        return true;  // Other gamepad input is swallowed while editing
+    }
+    if (buttonEvent->GetDevice() != RE::INPUT_DEVICE::kKeyboard) {
+        return true;
+    }
+
+    std::uint32_t keyCode = buttonEvent->GetIDCode();
+    if (buttonEvent->IsDown()) {
+        repeatKey_ = keyCode;
+        nextRepeat_ = kRepeatDelay;
+    } else if (buttonEvent->IsHeld() && keyCode == repeatKey_ && buttonEvent->HeldDuration() >= nextRepeat_) {
+        nextRepeat_ = buttonEvent->HeldDuration() + kRepeatInterval;
+    } else {
+        if (buttonEvent->IsUp() && keyCode == repeatKey_) {
+            repeatKey_ = 0;
+        }
+        return true;
+    }
+
+    if (HandleKey(keyCode, KeyModifiers::Current())) {
+        dirty_ = true;
+    }
+    return true;
+}
+
+bool NoteEditor::HandleKey(std::uint32_t keyCode, std::uint8_t modifiers) {
+    bool shift = modifiers & KeyModifiers::SHIFT;
+    bool ctrl = modifiers & KeyModifiers::CTRL;
+
+    switch (keyCode) {
+    case KeyCodes::ESCAPE:
+        Close();
+        return false;
+    case KeyCodes::ENTER:
+    case KeyCodes::NUMPAD_ENTER:
+        if (ctrl) {
+            Save();
+            return false;
+        }
+        return model_.Insert("\n");
+    case KeyCodes::BACKSPACE:
+        model_.Backspace(ctrl);
+        return true;
+    case KeyCodes::DELETE_KEY:
+        model_.Delete(ctrl);
+        return true;
+    case KeyCodes::ARROW_LEFT:
+        model_.MoveLeft(shift, ctrl);
+        return true;
+    case KeyCodes::ARROW_RIGHT:
+        model_.MoveRight(shift, ctrl);
+        return true;
+    case KeyCodes::ARROW_UP:
+        model_.MoveUp(shift);
+        return true;
+    case KeyCodes::ARROW_DOWN:
+        model_.MoveDown(shift);
+        return true;
+    case KeyCodes::HOME:
+        ctrl ? model_.MoveDocumentStart(shift) : model_.MoveLineStart(shift);
+        return true;
+    case KeyCodes::END:
+        ctrl ? model_.MoveDocumentEnd(shift) : model_.MoveLineEnd(shift);
+        return true;
+    default:
+        break;
+    }
+
+    if (!ctrl) {
+        return false;  // Printable keys arrive as CharEvents
+    }
+
+    switch (keyCode) {
+    case KeyCodes::KEY_S:
+        Save();
+        return false;
+    case KeyCodes::KEY_Z:
+        return shift ? model_.Redo() : model_.Undo();
+    case KeyCodes::KEY_Y:
+        return model_.Redo();
+    case KeyCodes::KEY_A:
+        model_.SelectAll();
+        return true;
+    case KeyCodes::KEY_C:
+        if (model_.HasSelection()) {
+            SetClipboardText(model_.GetSelectedText());
+        }
+        return false;
+    case KeyCodes::KEY_X:
+        if (model_.HasSelection()) {
+            SetClipboardText(model_.GetSelectedText());
+            model_.DeleteSelection();
+            return true;
+        }
+        return false;
+    case KeyCodes::KEY_V:
+        return model_.Insert(GetClipboardText());
+    default:
+        return false;
+    }
+}
+
+void NoteEditor::HandleChar(std::uint32_t codePoint) {
+    // Control characters (Ctrl+letter, Enter, Tab, Backspace) are handled as keys
+    if (codePoint < 0x20 || codePoint == 0x7F || codePoint > 0x10FFFF) {
+        return;
+    }
+    if (KeyModifiers::Current() & KeyModifiers::CTRL) {
+        return;
+    }
+
+    char utf8[4];
+    size_t length = 0;
+    if (codePoint < 0x80) {
+        utf8[length++] = static_cast<char>(codePoint);
+    } else if (codePoint < 0x800) {
+        utf8[length++] = static_cast<char>(0xC0 | (codePoint >> 6));
+        utf8[length++] = static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else if (codePoint < 0x10000) {
+        utf8[length++] = static_cast<char>(0xE0 | (codePoint >> 12));
+        utf8[length++] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        utf8[length++] = static_cast<char>(0x80 | (codePoint & 0x3F));
+    } else {
+        utf8[length++] = static_cast<char>(0xF0 | (codePoint >> 18));
+        utf8[length++] = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+        utf8[length++] = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+        utf8[length++] = static_cast<char>(0x80 | (codePoint & 0x3F));
+    }
+
+    if (model_.Insert(std::string_view(utf8, length))) {
+        dirty_ = true;
+    }
+}
+
+void NoteEditor::Save() {
+    Trace::Scope trace("NoteEditor::Save", "editor");
+    auto mgr = NoteManager::GetSingleton();
+    std::string text = model_.GetText();
 
-        // Write to file
-        try {
-            std::ofstream file(filename);
-            if (!file) {
-                spdlog::error("[BACKUP] Failed to open file for writing: {}", filename);
-                RE::DebugNotification("Export failed");
-                return false;
-            }
+    if (questID_ == NoteManager::GENERAL_NOTE_ID) {
+        mgr->SaveGeneralNote(text);
+        RE::DebugNotification("General note saved!");
+    } else {
+        mgr->SaveNoteForQuest(questID_, text);
+        RE::DebugNotification("Quest note saved!");
+    }
+    model_.MarkSaved();
+    Close();
+}
 
-            file << json.str();
-            file.close();
+void NoteEditor::Close() {
+    repeatKey_ = 0;
+    if (auto queue = RE::UIMessageQueue::GetSingleton()) {
+        queue->AddMessage(MENU_NAME, RE::UI_MESSAGE_TYPE::kHide, nullptr);
+    }
+}
 
-            spdlog::info("[BACKUP] Exported {} notes to {}", notes.size(), filename);
-            RE::DebugNotification("Notes exported successfully");
-            return true;
+void NoteEditor::Flush() {
+    if (dirty_) {
+        Render();
+    }
+}
 
-        } catch (const std::exception& e) {
-            spdlog::error("[BACKUP] Export failed: {}", e.what());
-            RE::DebugNotification("Export failed");
-            return false;
-        }
+void NoteEditor::CreateFields(RE::GFxMovieView* movie) {
+    RE::GFxValue root;
+    if (!movie->GetVariable(&root, "_root")) {
+        spdlog::error("[EDITOR] Failed to get _root");
+        return;
     }
 
-    /**
-     * @brief Simple JSON value extractor (finds "key": value pattern).
-     * @param json JSON string
-     * @param key Key to search for
-     * @return Value string (without quotes for strings)
-     */
-    std::string ExtractJSONValue(const std::string& json, const std::string& key) {
-        std::string pattern = "\"" + key + "\":";
-        size_t pos = json.find(pattern);
-        if (pos == std::string::npos) {
-            return "";
+    auto settings = SettingsManager::GetSingleton();
+    settings->ReloadIfChanged();
+
+    auto visibleRect = movie->GetVisibleFrameRect();
+    double width = settings->textInputWidth;
+    double height = settings->textInputHeight;
+    double x = visibleRect.left + ((visibleRect.right - visibleRect.left) - width) / 2.0;
+    double y = visibleRect.top + ((visibleRect.bottom - visibleRect.top) - height) / 2.0;
+
+    // Panel background (AS2 drawing API on _root)
+    RE::GFxValue fillArgs[2];
+    fillArgs[0].SetNumber(0x000000);
+    fillArgs[1].SetNumber(85);
+    root.Invoke("clear");
+    root.Invoke("beginFill", nullptr, fillArgs, 2);
+    const double corners[5][2] = { { x, y }, { x + width, y }, { x + width, y + height }, { x, y + height }, { x, y } };
+    for (size_t i = 0; i < 5; ++i) {
+        RE::GFxValue point[2];
+        point[0].SetNumber(corners[i][0]);
+        point[1].SetNumber(corners[i][1]);
+        root.Invoke(i == 0 ? "moveTo" : "lineTo", nullptr, point, 2);
+    }
+    root.Invoke("endFill");
+
+    static constexpr const char* kAlignments[] = { "left", "center", "right" };
+    const double padding = 12.0;
+    const double lineHeight = settings->textInputFontSize * 1.6;
+
+    auto createField = [&](const char* name, int depth, double fieldY, double fieldHeight, int size, int color) {
+        RE::GFxValue field;
+        RE::GFxValue createArgs[6];
+        createArgs[0].SetString(name);
+        createArgs[1].SetNumber(depth);
+        createArgs[2].SetNumber(x + padding);
+        createArgs[3].SetNumber(fieldY);
+        createArgs[4].SetNumber(width - 2 * padding);
+        createArgs[5].SetNumber(fieldHeight);
+        root.Invoke("createTextField", &field, createArgs, 6);
+        if (!field.IsObject()) {
+            spdlog::error("[EDITOR] createTextField failed for {}", name);
+            return field;
         }
 
-        pos += pattern.size();
-        // Skip whitespace
-        while (pos < json.size() && std::isspace(json[pos])) {
-            ++pos;
+        RE::GFxValue textFormat;
+        movie->CreateObject(&textFormat, "TextFormat");
+        if (textFormat.IsObject()) {
+            textFormat.SetMember("font", "$EverywhereMediumFont");
+            textFormat.SetMember("size", size);
+            textFormat.SetMember("color", color);
+            textFormat.SetMember("align", kAlignments[settings->textInputAlignment]);
+            field.SetMember("defaultTextFormat", textFormat);
         }
+        field.SetMember("embedFonts", true);
+        field.SetMember("selectable", false);
+        field.SetMember("multiline", true);
+        field.SetMember("wordWrap", true);
+        field.SetMember("html", true);
+        return field;
+    };
+
+    titleField_ = createField("noteEditorTitle", 1, y + padding, lineHeight, settings->textInputFontSize + 2, 0xFFFFFF);
+    bodyField_ = createField("noteEditorBody", 2, y + padding + lineHeight,
+                             height - 2 * padding - 2 * lineHeight, settings->textInputFontSize, 0xDDDDDD);
+    hintField_ = createField("noteEditorHint", 3, y + height - padding - lineHeight, lineHeight,
+                             std::max(settings->textInputFontSize - 2, 8), 0x999999);
+
+    std::string title = questID_ == NoteManager::GENERAL_NOTE_ID ? "General Note" : title_;
+    if (titleField_.IsObject()) {
+        titleField_.SetMember("text", title.c_str());
+    }
+    if (hintField_.IsObject()) {
+        hintField_.SetMember("text", "Ctrl+Enter / Start: Save    Esc / B: Cancel    Ctrl+Z/Y: Undo/Redo");
+    }
+}
 
-        if (pos >= json.size()) {
-            return "";
-        }
+void NoteEditor::Render() {
+    dirty_ = false;
+    if (!bodyField_.IsObject()) {
+        return;
+    }
 
-        // String value (quoted)
-        if (json[pos] == '"') {
-            ++pos;
-            size_t end = pos;
-            while (end < json.size() && json[end] != '"') {
-                if (json[end] == '\\') {
-                    ++end;  // Skip escaped character
-                }
-                ++end;
-            }
-            return json.substr(pos, end - pos);
-        }
+    std::string html = BuildBodyHTML();
+    bodyField_.SetMember("htmlText", html.c_str());
 
-        // Number value (unquoted)
-        size_t end = pos;
-        while (end < json.size() && (std::isdigit(json[end]) || json[end] == '-' || json[end] == '.')) {
-            ++end;
-        }
-        return json.substr(pos, end - pos);
+    // Keep the cursor in view: scroll proportionally to its position (lines may wrap)
+    RE::GFxValue maxScroll;
+    bodyField_.GetMember("maxscroll", &maxScroll);
+    if (maxScroll.IsNumber() && maxScroll.GetNumber() > 1.0 && model_.Size() > 0) {
+        double position = static_cast<double>(model_.GetCursor()) / static_cast<double>(model_.Size());
+        bodyField_.SetMember("scroll", std::round(1.0 + position * (maxScroll.GetNumber() - 1.0)));
     }
+}
 
-    /**
-     * @brief Import notes from fixed import path if exists.
-     * Merges imported notes with existing notes (imported notes overwrite if conflict).
-     * Deletes import file after successful import.
-     * @return Number of notes imported, -1 on error
-     */
-    int ImportNotesFromJSON() {
-        // Check if import file exists
-        if (!fs::exists(Paths::IMPORT_FILE)) {
-            spdlog::info("[BACKUP] No import file found at {}", Paths::IMPORT_FILE);
-            return 0;  // Not an error, just nothing to import
+std::string NoteEditor::BuildBodyHTML() const {
+    std::string text = model_.GetText();
+    auto [selBegin, selEnd] = model_.GetSelection();
+    size_t cursor = model_.GetCursor();
+
+    std::string html;
+    html.reserve(text.size() + 64);
+
+    auto appendEscaped = [&html](char c) {
+        switch (c) {
+        case '&': html += "&amp;"; break;
+        case '<': html += "&lt;"; break;
+        case '>': html += "&gt;"; break;
+        case '\n': html += "<br>"; break;
+        default: html += c; break;
         }
+    };
 
-        // Read file
-        std::ifstream file(Paths::IMPORT_FILE);
-        if (!file) {
-            spdlog::error("[BACKUP] Failed to open import file: {}", Paths::IMPORT_FILE);
-            return -1;
+    for (size_t i = 0; i <= text.size(); ++i) {
+        if (i == selBegin && selBegin != selEnd) {
+            html += "<font color=\"#FFD700\">";
         }
-
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        std::string json = buffer.str();
-        file.close();
-
-        // Check if file is empty
-        if (json.empty() || json.find_first_not_of(" \t\n\r") == std::string::npos) {
-            spdlog::info("[BACKUP] Import file is empty, skipping");
-            return 0;
+        if (i == cursor) {
+            html += "<font color=\"#FFFFFF\">|</font>";
         }
+        if (i == selEnd && selBegin != selEnd) {
+            html += "</font>";
+        }
+        if (i < text.size()) {
+            appendEscaped(text[i]);
+        }
+    }
+    return html;
+}
 
-        // Parse JSON manually (simple approach for our specific format)
-        try {
-            auto mgr = NoteManager::GetSingleton();
-            int importCount = 0;
-
-            // Find notes array
-            size_t notesArrayStart = json.find("\"notes\":");
-            if (notesArrayStart == std::string::npos) {
-                spdlog::error("[BACKUP] Invalid JSON: 'notes' array not found");
-                return -1;
-            }
-
-            // Find opening bracket of array
-            size_t arrayStart = json.find('[', notesArrayStart);
-            if (arrayStart == std::string::npos) {
-                spdlog::error("[BACKUP] Invalid JSON: notes array bracket not found");
-                return -1;
-            }
-
-            // Parse each note object
-            size_t pos = arrayStart + 1;
-            while (pos < json.size()) {
-                // Find next note object
-                size_t objStart = json.find('{', pos);
-                if (objStart == std::string::npos) {
-                    break;  // No more objects
-                }
-
-                size_t objEnd = json.find('}', objStart);
-                if (objEnd == std::string::npos) {
-                    spdlog::error("[BACKUP] Invalid JSON: unclosed object");
-                    break;
-                }
-
-                std::string noteObj = json.substr(objStart, objEnd - objStart + 1);
-
-                // Extract fields
-                std::string questIDStr = ExtractJSONValue(noteObj, "questID");
-                std::string textEscaped = ExtractJSONValue(noteObj, "text");
-                std::string timestampStr = ExtractJSONValue(noteObj, "timestamp");
-
-                if (questIDStr.empty() || textEscaped.empty()) {
-                    spdlog::warn("[BACKUP] Skipping note with missing fields");
-                    pos = objEnd + 1;
-                    continue;
-                }
-
-                // Convert values
-                RE::FormID questID = static_cast<RE::FormID>(std::stoul(questIDStr));
-                std::string text = UnescapeJSON(textEscaped);
-                std::time_t timestamp = timestampStr.empty() ? std::time(nullptr) : std::stoll(timestampStr);
-
-                // Create and save note
-                Note note;
-                note.questID = questID;
-                note.text = text;
-                note.timestamp = timestamp;
-
-                mgr->SaveNoteForQuest(questID, text);
-                importCount++;
-
-                pos = objEnd + 1;
-            }
-
-            if (importCount > 0) {
-                spdlog::info("[BACKUP] Imported {} notes from {}", importCount, Paths::IMPORT_FILE);
+std::string NoteEditor::GetClipboardText() {
+    std::string result;
+    if (!OpenClipboard(nullptr)) {
+        return result;
+    }
 
-                // Delete import file after successful import
-                try {
-                    fs::remove(Paths::IMPORT_FILE);
-                    spdlog::info("[BACKUP] Deleted import file after successful import");
-                } catch (const fs::filesystem_error& e) {
-                    spdlog::warn("[BACKUP] Failed to delete import file: {}", e.what());
-                }
+    if (HANDLE data = GetClipboardData(CF_UNICODETEXT)) {
+        if (auto wide = static_cast<const wchar_t*>(GlobalLock(data))) {
+            int size = WideCharToMultiByte(CP_UTF8, 0, wide, -1, nullptr, 0, nullptr, nullptr);
+            if (size > 1) {
+                result.resize(static_cast<size_t>(size) - 1);
+                WideCharToMultiByte(CP_UTF8, 0, wide, -1, result.data(), size, nullptr, nullptr);
             }
-
-            return importCount;
-
-        } catch (const std::exception& e) {
-            spdlog::error("[BACKUP] Import parsing failed: {}", e.what());
-            return -1;
+            GlobalUnlock(data);
         }
     }
+    CloseClipboard();
+
+    // Normalize Windows line endings to the model's '\n'
+    result.erase(std::remove(result.begin(), result.end(), '\r'), result.end());
+    return result;
 }
 
-//=============================================================================
-// Forward Declarations
-//=============================================================================
+void NoteEditor::SetClipboardText(const std::string& text) {
+    int size = MultiByteToWideChar(CP_UTF8, 0, text.c_str(), -1, nullptr, 0);
+    if (size <= 0 || !OpenClipboard(nullptr)) {
+        return;
+    }
 
-namespace PapyrusBridge {
-    void ShowQuestNoteInput(RE::FormID questID);
-    void ShowGeneralNoteInput();
-    void ShowNotesListMenu();
+    EmptyClipboard();
+    if (HGLOBAL memory = GlobalAlloc(GMEM_MOVEABLE, static_cast<size_t>(size) * sizeof(wchar_t))) {
+        if (auto wide = static_cast<wchar_t*>(GlobalLock(memory))) {
+            MultiByteToWideChar(CP_UTF8, 0, text.c_str(), -1, wide, size);
+            GlobalUnlock(memory);
+            if (!SetClipboardData(CF_UNICODETEXT, memory)) {
+                GlobalFree(memory);
+            }
+        } else {
+            GlobalFree(memory);
+        }
+    }
+    CloseClipboard();
 }
 
 //=============================================================================
-// Journal Quest Detection
+// UI Command Queue Implementation
 //=============================================================================
 
-[[nodiscard]] RE::FormID GetCurrentQuestInJournal() {
-    auto ui = RE::UI::GetSingleton();
-    if (!ui || !ui->IsMenuOpen("Journal Menu")) {
-        return 0;  // Not in journal
+void UICommandQueue::Drain() {
+    // Clear first so commands racing with the drain schedule another pass
+    drainScheduled_.store(false, std::memory_order_release);
+
+    Perf::ScopedTimer timer(Perf::Probe::kUICommandDrain);
+    Trace::Scope trace("UICommandQueue::Drain", "ui");
+    auto helper = JournalNoteHelper::GetSingleton();
+
+    std::optional<UICommandType> lifecycle;  // Last Journal open/close wins
+    std::optional<UICommand> noteText;       // Last selection wins
+    bool noteChanged = false;
+    bool badges = false;
+    bool forceBadges = false;
+    bool renderEditor = false;
+
+    auto showNoteText = [&](const UICommand& command) {
+        bool force = command.force || (noteText && noteText->force);
+        noteText = UICommand{ UICommandType::kRefreshNoteText, command.questID, force };
+    };
+
+    UICommand command;
+    while (queue_.TryPop(command)) {
+        switch (command.type) {
+        case UICommandType::kJournalOpened:
+        case UICommandType::kJournalClosed:
+            lifecycle = command.type;
+            break;
+        case UICommandType::kRefreshNoteText:
+            showNoteText(command);
+            break;
+        case UICommandType::kMouseHover:
+            if (helper->AcceptMouseHover(command.questID, noteText ? noteText->questID : helper->GetShownQuest())) {
+                showNoteText(command);
+            }
+            break;
+        case UICommandType::kKeyboardSelect:
+            helper->SetKeyboardSelection(command.questID);
+            showNoteText(command);
+            break;
+        case UICommandType::kRefreshBadges:
+            badges = true;
+            forceBadges = forceBadges || command.force;
+            break;
+        case UICommandType::kNoteChanged:
+            noteChanged = noteChanged || helper->IsAffectedBy(command.questID);
+            badges = forceBadges = true;
+            break;
+        case UICommandType::kRenderEditor:
+            renderEditor = true;
+            break;
+        }
     }
 
-    auto journalMenu = ui->GetMenu<RE::JournalMenu>();
-    if (!journalMenu) {
-        spdlog::error("[JOURNAL] Failed to get JournalMenu pointer");
-        return 0;
+    if (overflowed_.exchange(false, std::memory_order_acq_rel)) {
+        spdlog::warn("[UI] Command queue overflowed, refreshing everything");
+        auto ui = RE::UI::GetSingleton();
+        bool journalOpen = ui && ui->IsMenuOpen("Journal Menu");
+        if (journalOpen != helper->IsJournalOpen()) {
+            lifecycle = journalOpen ? UICommandType::kJournalOpened : UICommandType::kJournalClosed;
+        }
+        noteChanged = badges = forceBadges = renderEditor = true;
     }
 
-    // Access quest tab and get selected entry
-    auto& rtData = journalMenu->GetRuntimeData();
-    auto& questsTab = rtData.questsTab;
-
-    if (!questsTab.unk18.IsObject()) {
-        return 0;
+    if (lifecycle == UICommandType::kJournalClosed) {
+        helper->OnJournalClose();
+    } else if (lifecycle == UICommandType::kJournalOpened) {
+        helper->OnJournalClose();  // Reopened within one drain: start from a clean state
+        helper->OnJournalOpen();   // Renders the text and badges itself
+        noteText.reset();
+        noteChanged = badges = false;
     }
 
-    // Get selectedEntry.formID
-    RE::GFxValue selectedEntry;
-    if (!questsTab.unk18.GetMember("selectedEntry", &selectedEntry) || !selectedEntry.IsObject()) {
-        return 0;
+    if (noteText) {
+        helper->UpdateTextField(noteText->questID, noteText->force || noteChanged);
+    } else if (noteChanged) {
+        helper->RefreshNoteText();
     }
-
-    RE::GFxValue formIDValue;
-    if (!selectedEntry.GetMember("formID", &formIDValue) || !formIDValue.IsNumber()) {
-        spdlog::warn("[JOURNAL] selectedEntry has no formID");
-        return 0;
+    if (badges) {
+        helper->RefreshBadges(forceBadges);
+    }
+    if (renderEditor) {
+        NoteEditor::GetSingleton()->Flush();
     }
-
-    RE::FormID questID = static_cast<RE::FormID>(formIDValue.GetUInt());
-    return questID;
 }
 
 //=============================================================================
-// Journal Note Helper
+// Input Handler
 //=============================================================================
 
 /**
- * @class JournalNoteHelper
- * @brief Manages UI overlay in Journal Menu showing note status.
+ * @class InputHandler
+ * @brief Hotkeys, Journal navigation tracking and hotkey blocking.
  *
- * Creates and manages a TextField in the Journal Menu that displays whether
- * the selected quest has an associated note. Handles lifecycle (open/close)
- * and updates text based on quest selection changes.
+ * Normally driven by InputDispatchHook: the hook walks each input batch once,
+ * filtering and calling Scan() on every surviving event, and calls Apply() after
+ * the batch has reached the game's sinks. If the hook could not be installed,
+ * ProcessEvent() runs the same steps as a BSInputDeviceManager sink.
+ *
+ * The sink is registered in both modes: while hotkeys are blocked (console, modal
+ * dialog) it returns kStop for batches with button events, so sinks registered
+ * after ours don't see them. In hook mode it reuses the hook's verdict for the
+ * batch and does no other work.
  */
-class JournalNoteHelper {
+class InputHandler : public RE::BSTEventSink<RE::InputEvent*> {
 public:
     /**
-     * @brief Get the singleton instance.
-     * @return Pointer to singleton instance (never null)
+     * UI state captured once per input batch, shared by filtering and hotkey handling.
      */
-    static JournalNoteHelper* GetSingleton() {
-        static JournalNoteHelper instance;
-        return &instance;
-    }
+    struct UIState {
+        bool playerLoaded = false;
+        bool journalOpen = false;
+        bool modalOpen = false;
+        bool hotkeysBlocked = true;  // Modal dialog (TextInput, etc.) or console open
+        std::uint8_t modifiers = 0;  // KeyModifiers held
+
+        static UIState Capture() {
+            UIState state;
+            state.modifiers = KeyModifiers::Current();
+            auto player = RE::PlayerCharacter::GetSingleton();
+            state.playerLoaded = player && player->Is3DLoaded();
 
-    /**
-     * @brief Initialize UI elements when Journal Menu opens.
-     *
-     * Creates TextField overlay with configured position and styling.
-     * Stores references to GFx objects and journal menu.
-     */
-    void OnJournalOpen();
+            auto ui = RE::UI::GetSingleton();
+            if (!ui) {
+                return state;
+            }
 
-    /**
-     * @brief Cleanup when Journal Menu closes.
-     *
-     * Clears GFx object references and resets state tracking.
-     */
-    void OnJournalClose();
+            state.journalOpen = ui->IsMenuOpen("Journal Menu");
+            state.modalOpen = ui->IsModalMenuOpen();
 
-    /**
-     * @brief Update TextField to reflect note status for current quest.
-     * @param questID The currently selected quest FormID (0 = none selected)
-     * @param forceUpdate If true, update even if quest hasn't changed
-     */
-    void UpdateTextField(RE::FormID questID, bool forceUpdate = false);
+            if (ui->IsMenuOpen(RE::Console::MENU_NAME)) {
+                // Always block in console
+                state.hotkeysBlocked = true;
+            } else if (state.modalOpen) {
+                // If modal AND not JUST Journal (Journal isn't modal), it's TextInput or similar
+                state.hotkeysBlocked = !state.journalOpen || ui->menuStack.size() > 1;
+            } else {
+                state.hotkeysBlocked = false;
+            }
+            return state;
+        }
+    };
 
     /**
-     * @brief Mark quest as keyboard-selected and update TextField.
-     * @param questID The quest selected via keyboard
+     * What a batch asked for; applied once after the batch was dispatched.
      */
-    void SetKeyboardSelection(RE::FormID questID) {
-        keyboardSelectedQuest_ = questID;
-        lastInputWasKeyboard_ = true;
-        UpdateTextField(questID);
+    struct Actions {
+        enum class Selection : std::uint8_t { kNone, kKeyboard, kMouse };
+
+        Selection selection = Selection::kNone;  // Journal selection changed (last one wins)
+        bool hover = false;                      // Mouse moved in Journal
+        bool scroll = false;                     // Journal quest list may have scrolled
+        bool noteHotkey = false;
+        bool quickAccessHotkey = false;
+
+        [[nodiscard]] bool Any() const {
+            return selection != Selection::kNone || hover || scroll || noteHotkey || quickAccessHotkey;
+        }
+    };
+
+    static InputHandler* GetSingleton() {
+        static InputHandler instance;
+        return &instance;
     }
 
     /**
-     * @brief Update TextField for mouse hover (only if not keyboard-selected).
-     * @param questID The quest under mouse cursor
+     * @brief Start handling input (kDataLoaded, once settings are available).
+     * @param viaDispatchHook true if InputDispatchHook is installed and will drive the handler
      */
-    void UpdateMouseHover(RE::FormID questID) {
-        // If quest changed from keyboard selection, switch to mouse mode
-        if (questID != keyboardSelectedQuest_) {
-            lastInputWasKeyboard_ = false;
-        }
+    static void Register(bool viaDispatchHook) {
+        auto handler = GetSingleton();
+        handler->viaDispatchHook_ = viaDispatchHook;
+        handler->active_ = true;
 
-        // Only update if not in keyboard mode, or if quest actually changed
-        if (!lastInputWasKeyboard_ || questID != lastQuestID_) {
-            UpdateTextField(questID);
+        auto input = RE::BSInputDeviceManager::GetSingleton();
+        if (input) {
+            input->AddEventSink(handler);
+        } else {
+            spdlog::error("[INPUT] Failed to get input device manager");
         }
+        spdlog::info("[INPUT] Input handler active ({})", viaDispatchHook ? "dispatch hook" : "event sink fallback");
     }
 
-private:
-    JournalNoteHelper() = default;
+    [[nodiscard]] bool IsActive() const {
+        return active_;
+    }
 
     /**
-     * Checks if the helper is properly initialized and ready to use.
-     * @return true if TextField and menu references are valid
+     * @brief Hook mode: whether the sink stops the batch being dispatched (set by the hook).
      */
-    bool IsInitialized() const {
-        return noteTextField_.IsObject() && journalMenu_ != nullptr;
+    void SetStopBatch(bool stop) {
+        stopBatch_ = stop;
     }
 
-    RE::GFxValue noteTextField_;
-    RE::GFxValue textFormat_;
-    RE::GPtr<RE::JournalMenu> journalMenu_;
-    RE::FormID lastQuestID_ = 0;        // Track last quest to detect changes
-    RE::FormID keyboardSelectedQuest_ = 0;  // Track keyboard-selected quest
-    bool lastInputWasKeyboard_ = false;     // True if last selection was via keyboard
-};
-
-//=============================================================================
-// Journal Note Helper Implementation
-//=============================================================================
+    /**
+     * @brief Per-batch bookkeeping before events are scanned.
+     *
+     * Tracks Journal open/close for JournalNoteHelper and the blocked-key map.
+     */
+    void BeginBatch(const UIState& state) {
+        hotkeys_ = HotkeyDispatcher::GetSingleton()->Acquire();
 
-void JournalNoteHelper::OnJournalOpen() {
-    // Reload settings if INI was modified (dMenu changes)
-    SettingsManager::GetSingleton()->ReloadIfChanged();
+        if (!state.playerLoaded) {
+            return;
+        }
 
-    auto ui = RE::UI::GetSingleton();
-    if (!ui) {
-        spdlog::error("[HELPER] Failed to get UI singleton");
-        return;
-    }
+        if (state.journalOpen && !wasJournalOpen_) {
+            UICommandQueue::GetSingleton()->Post({ UICommandType::kJournalOpened });
+        } else if (!state.journalOpen && wasJournalOpen_) {
+            UICommandQueue::GetSingleton()->Post({ UICommandType::kJournalClosed });
+            BlockedKeyMap::GetSingleton()->Invalidate();  // Controls may have been remapped
+        }
 
-    auto journalMenu = ui->GetMenu<RE::JournalMenu>();
-    if (!journalMenu) {
-        spdlog::error("[HELPER] Failed to get Journal Menu");
-        return;
+        wasJournalOpen_ = state.journalOpen;
     }
 
-    // Store journal menu reference
-    journalMenu_ = journalMenu;
-
-    // Create TextField in Journal's _root
-    if (journalMenu->uiMovie) {
-        RE::GFxValue root;
-        if (journalMenu->uiMovie->GetVariable(&root, "_root")) {
-            RE::GFxValue textField;
-            RE::GFxValue createArgs[6];
-            auto settings = SettingsManager::GetSingleton();
-            createArgs[0].SetString("questNoteTextField");           // name
-            createArgs[1].SetNumber(UIConstants::TEXTFIELD_TOP_DEPTH);   // VERY high depth to be on absolute top
-            createArgs[2].SetNumber(settings->textFieldX);           // TOP-LEFT x position
-            createArgs[3].SetNumber(settings->textFieldY);           // TOP-LEFT y position
-            createArgs[4].SetNumber(UIConstants::TEXTFIELD_DEFAULT_WIDTH);   // width
-            createArgs[5].SetNumber(UIConstants::TEXTFIELD_DEFAULT_HEIGHT);  // height
-
-            root.Invoke("createTextField", &textField, createArgs, 6);
-
-            if (textField.IsObject()) {
-                // Create TextFormat object
-                RE::GFxValue textFormat;
-                journalMenu->uiMovie->CreateObject(&textFormat, "TextFormat");
-
-                if (textFormat.IsObject()) {
-                    textFormat.SetMember("font", "$EverywhereBoldFont");
-                    textFormat.SetMember("size", settings->textFieldFontSize);
-                    textFormat.SetMember("color", settings->textFieldColor);
-
-                    // Apply defaultTextFormat
-                    textField.SetMember("defaultTextFormat", textFormat);
-                }
-
-                // Configure TextField
-                textField.SetMember("embedFonts", true);
-                textField.SetMember("selectable", false);
-                textField.SetMember("autoSize", "left");
-                textField.SetMember("text", "");
+    /**
+     * @brief Record what a single event asks for.
+     * @param event Event from the batch being dispatched
+     * @param state UI state captured for this batch
+     * @param actions Accumulated requests for the batch
+     */
+    void Scan(const RE::InputEvent& event, const UIState& state, Actions& actions) const {
+        // Handle button events (keyboard, mouse clicks)
+        if (event.eventType == RE::INPUT_EVENT_TYPE::kButton) {
+            if (state.hotkeysBlocked) {
+                return;  // Skip our hotkey processing only
+            }
 
-                // Apply format to existing text
-                if (textFormat.IsObject()) {
-                    textField.Invoke("setTextFormat", nullptr, &textFormat, 1);
-                }
+            auto buttonEvent = event.AsButtonEvent();
+            if (!buttonEvent) {
+                return;
+            }
 
-                // Store references
-                noteTextField_ = textField;
-                textFormat_ = textFormat;
+            std::uint32_t keyCode = HotkeyDispatcher::ToKeyCode(buttonEvent->device.get(), buttonEvent->idCode);
 
-                // Get initial quest and update TextField
-                RE::FormID currentQuest = GetCurrentQuestInJournal();
-                UpdateTextField(currentQuest);
-                lastQuestID_ = currentQuest;  // Initialize tracking
-            } else {
-                spdlog::error("[HELPER] createTextField failed");
+            switch (hotkeys_->Lookup(keyCode, state.modifiers)) {
+            case HotkeyAction::kNoteInput:
+                // Note hotkey - context-dependent behavior
+                if (buttonEvent->IsDown()) {
+                    actions.noteHotkey = true;
+                }
+                break;
+            case HotkeyAction::kQuickAccess:
+                // Quick access hotkey - list all notes (outside journal only)
+                if (buttonEvent->IsDown() && !state.journalOpen) {
+                    actions.quickAccessHotkey = true;
+                }
+                break;
+            // Update TextField on navigation RELEASE (arrow keys, mouse clicks, page keys)
+            // Applied after dispatch so Journal processes the input first, then we read the updated selection
+            case HotkeyAction::kJournalKeyNavigate:
+                // Keyboard navigation - mark as keyboard selection
+                if (state.journalOpen && buttonEvent->IsUp()) {
+                    actions.selection = Actions::Selection::kKeyboard;
+                }
+                break;
+            case HotkeyAction::kJournalMouseSelect:
+                // Mouse click - regular update (switches back to mouse mode)
+                if (state.journalOpen && buttonEvent->IsUp()) {
+                    actions.selection = Actions::Selection::kMouse;
+                }
+                break;
+            case HotkeyAction::kJournalScroll:
+                if (state.journalOpen) {
+                    actions.scroll = true;
+                }
+                break;
+            case HotkeyAction::kNone:
+                break;
+            }
+        }
+        // Handle mouse move events (hover detection in Journal)
+        else if (event.eventType == RE::INPUT_EVENT_TYPE::kMouseMove) {
+            if (state.journalOpen) {
+                actions.hover = true;
             }
         }
     }
-}
 
-void JournalNoteHelper::OnJournalClose() {
-    // Clear references
-    noteTextField_.SetUndefined();
-    textFormat_.SetUndefined();
-    journalMenu_ = nullptr;
-    lastQuestID_ = 0;              // Reset tracking
-    keyboardSelectedQuest_ = 0;    // Reset keyboard selection
-    lastInputWasKeyboard_ = false;
-}
+    /**
+     * @brief Act on a scanned batch (after the game's sinks have seen it).
+     * @param actions Requests collected by Scan()
+     * @param state UI state captured for the batch
+     */
+    void Apply(const Actions& actions, const UIState& state) {
+        if (!actions.Any()) {
+            return;
+        }
+        Perf::ScopedTimer timer(Perf::Probe::kInputActions);
+        Trace::Scope trace("InputHandler::Apply", "input");
+
+        if (actions.hover || actions.selection != Actions::Selection::kNone) {
+            // Only the questID is read here; the drain decides what the TextField shows
+            RE::FormID questID = GetCurrentQuestInJournal();
+            auto queue = UICommandQueue::GetSingleton();
+            if (actions.hover) {
+                queue->Post({ UICommandType::kMouseHover, questID });
+            }
+            if (actions.selection == Actions::Selection::kKeyboard) {
+                queue->Post({ UICommandType::kKeyboardSelect, questID });
+            } else if (actions.selection == Actions::Selection::kMouse) {
+                queue->Post({ UICommandType::kRefreshNoteText, questID });
+            }
+        }
 
-void JournalNoteHelper::UpdateTextField(RE::FormID questID, bool forceUpdate) {
-    if (!IsInitialized()) {
-        return; // Helper not properly initialized
-    }
+        // Paging, arrow keys and the wheel can scroll new quests into view (no-op if they didn't)
+        if (actions.scroll || actions.selection != Actions::Selection::kNone) {
+            UICommandQueue::GetSingleton()->Post({ UICommandType::kRefreshBadges });
+        }
 
-    // Only update if quest changed (prevent spam), unless forced
-    if (!forceUpdate && questID == lastQuestID_) {
-        return;
+        if (actions.noteHotkey) {
+            Trace::Instant("NoteHotkey", "hotkey");
+            if (state.journalOpen) {
+                // In Journal Menu → Quest note
+                OnQuestNoteHotkey();
+            } else {
+                // During gameplay → General note
+                PapyrusBridge::ShowGeneralNoteInput();
+            }
+        }
+
+        if (actions.quickAccessHotkey) {
+            Trace::Instant("QuickAccessHotkey", "hotkey");
+            // Show list of all notes
+            PapyrusBridge::ShowNotesListMenu();
+        }
     }
 
-    lastQuestID_ = questID;  // Track current quest
+    /**
+     * Event sink: the whole handler without the hook, only the hotkey-blocking kStop with it.
+     */
+    RE::BSEventNotifyControl ProcessEvent(
+        RE::InputEvent* const* a_event,
+        RE::BSTEventSource<RE::InputEvent*>*) override {
+        if (viaDispatchHook_) {
+            return stopBatch_ ? RE::BSEventNotifyControl::kStop : RE::BSEventNotifyControl::kContinue;
+        }
+        Trace::Scope trace("InputHandler::ProcessEvent", "input");
 
-    std::string message;
+        UIState state = UIState::Capture();
+        BeginBatch(state);
 
-    if (questID == 0) {
-        // No quest selected - clear text
-        message = "";
-    } else {
-        // Check if note exists for this quest
-        bool hasNote = NoteManager::GetSingleton()->HasNoteForQuest(questID);
+        if (!a_event) {
+            return RE::BSEventNotifyControl::kContinue;
+        }
 
-        if (hasNote) {
-            message = "Press , to edit note";
-        } else {
-            message = "Press , to add note";
+        Actions actions;
+        for (auto event = *a_event; event; event = event->next) {
+            // If blocking, stop event propagation
+            if (state.hotkeysBlocked && event->eventType == RE::INPUT_EVENT_TYPE::kButton) {
+                return RE::BSEventNotifyControl::kStop;
+            }
+            Scan(*event, state, actions);
         }
+        Apply(actions, state);
+
+        return RE::BSEventNotifyControl::kContinue;
     }
 
-    // Update text
-    noteTextField_.SetMember("text", message.c_str());
+private:
+    InputHandler() = default;
 
-    // Reapply format (needed after text change)
-    if (textFormat_.IsObject()) {
-        noteTextField_.Invoke("setTextFormat", nullptr, &textFormat_, 1);
+    bool active_ = false;          // Set at kDataLoaded; before that, input is not ours to handle
+    bool viaDispatchHook_ = false;  // InputDispatchHook drives Scan()/Apply(); the sink only stops batches
+    bool stopBatch_ = false;        // Hook mode: batch being dispatched has buttons while hotkeys are blocked
+    std::shared_ptr<const HotkeyDispatcher::Table> hotkeys_;  // Acquired per batch in BeginBatch()
+    bool wasJournalOpen_ = false;  // Track journal state across events
+
+    void OnQuestNoteHotkey() {
+        // Get current quest
+        RE::FormID questID = GetCurrentQuestInJournal();
+        if (questID == 0) {
+            RE::DebugNotification("No quest selected");
+            return;
+        }
+
+        // Show note input dialog (DialogTracker drops it if one is already in flight)
+        PapyrusBridge::ShowQuestNoteInput(questID);
     }
-}
+};
 
 //=============================================================================
 // Input Event Dispatch Hook (runs BEFORE event sinks - same as wheeler)
 //=============================================================================
 
+/**
+ * Single pass over each input batch: drops game controls while one of our text
+ * input menus is open and collects hotkey/navigation requests for InputHandler,
+ * then applies them once the batch has been dispatched to the game's sinks.
+ */
 class InputDispatchHook {
 public:
-    static void Install() {
-        auto& trampoline = SKSE::GetTrampoline();
-        REL::Relocation<uintptr_t> caller{ RELOCATION_ID(67315, 68617) };
-        _DispatchInputEvent = trampoline.write_call<5>(caller.address() + 0x7B, DispatchInputEvent);
+    /**
+     * @brief Install the hook (needs 14 bytes of SKSE trampoline space).
+     * @return false if the call site could not be resolved; InputHandler then falls back to a sink
+     */
+    static bool Install() {
+        try {
+            auto& trampoline = SKSE::GetTrampoline();
+            REL::Relocation<uintptr_t> caller{ RELOCATION_ID(67315, 68617) };
+            _DispatchInputEvent = trampoline.write_call<5>(caller.address() + 0x7B, DispatchInputEvent);
+        } catch (const std::exception& e) {
+            spdlog::error("[HOOK] Input dispatch hook failed: {}", e.what());
+            return false;
+        }
+        installed_ = true;
         spdlog::info("[HOOK] Input dispatch hook installed (runs BEFORE wheeler & event sinks)");
+        return true;
+    }
+
+    [[nodiscard]] static bool IsInstalled() {
+        return installed_;
     }
 
 private:
+    /**
+     * Whether bound game controls are dropped from this batch: only while the native
+     * editor or a text-input dialog we dispatched is open. Other modal menus (message
+     * boxes, lists, third-party menus) keep their keys and clicks.
+     */
+    static bool ShouldFilterControls(const InputHandler::UIState& state, bool editorOpen);
+
     /**
      * Our hook function that runs BEFORE input events are dispatched to sinks.
      * This is the same technique wheeler uses - we can filter events here.
      */
     static void DispatchInputEvent(RE::BSTEventSource<RE::InputEvent*>* a_dispatcher, RE::InputEvent** a_events) {
+        auto handler = InputHandler::GetSingleton();
+        InputHandler::UIState state;
+        InputHandler::Actions actions;
+
         if (a_events && *a_events) {
-            auto ui = RE::UI::GetSingleton();
-            bool isModalOpen = ui && ui->IsModalMenuOpen();
-
-            if (isModalOpen) {
-                auto ctrlMap = RE::ControlMap::GetSingleton();
-                if (ctrlMap) {
-                    // Filter events by modifying linked list
-                    RE::InputEvent* event = *a_events;
-                    RE::InputEvent* prev = nullptr;
-
-                    while (event != nullptr) {
-                        bool shouldDispatch = true;
-
-                        // Only filter button events bound to game controls
-                        if (event->eventType == RE::INPUT_EVENT_TYPE::kButton) {
-                            auto buttonEvent = event->AsButtonEvent();
-                            if (buttonEvent) {
-                                auto device = buttonEvent->device.get();
-                                uint32_t keyCode = buttonEvent->idCode;
-                                auto userEvent = ctrlMap->GetUserEventName(keyCode, device);
-
-                                // If key is bound to a game control, block it
-                                if (!userEvent.empty()) {
-                                    shouldDispatch = false;
-
-                                    // DEBUG: Log 'g' key filtering
-                                    if (keyCode == 34) {
-                                        spdlog::info("[HOOK:G] Blocking '{}' control (keyCode={}) - wheeler won't see this", userEvent, keyCode);
-                                    }
-                                }
-                                // Otherwise (typing, ESC, Enter, etc.) - allow through
-                            }
-                        }
-
-                        // Remove event from chain if blocked
-                        RE::InputEvent* nextEvent = event->next;
-                        if (!shouldDispatch) {
-                            if (prev != nullptr) {
-                                prev->next = nextEvent;
-                            } else {
-                                *a_events = nextEvent;
-                            }
-                        } else {
-                            prev = event;
-                        }
-                        event = nextEvent;
+            Perf::ScopedTimer timer(Perf::Probe::kDispatchInputEvent);  // Our pass only, not the sinks
+            Trace::Scope trace("DispatchInputEvent", "input");
+
+            state = InputHandler::UIState::Capture();
+            bool handle = handler->IsActive();
+            if (handle) {
+                handler->BeginBatch(state);
+            }
+            auto blockedKeys = BlockedKeyMap::GetSingleton();
+            auto editor = NoteEditor::GetSingleton();
+            bool editorOpen = editor->IsOpen();
+            bool filterControls = ShouldFilterControls(state, editorOpen);
+            bool stopBatch = false;
+
+            // Filter events by modifying linked list
+            RE::InputEvent* event = *a_events;
+            RE::InputEvent* prev = nullptr;
+
+            while (event != nullptr) {
+                bool shouldDispatch = true;
+
+                // The native editor takes keys and characters before anything else sees them
+                if (editorOpen && editor->HandleEvent(*event)) {
+                    shouldDispatch = false;
+                }
+
+                // While typing in our menus, drop keys bound to game controls; the mouse
+                // is left alone so buttons and lists stay clickable
+                // Otherwise (typing, ESC, Enter, etc.) - allow through
+                if (shouldDispatch && filterControls && event->eventType == RE::INPUT_EVENT_TYPE::kButton) {
+                    if (auto buttonEvent = event->AsButtonEvent(); buttonEvent && buttonEvent->device.get() != RE::INPUT_DEVICE::kMouse) {
+                        shouldDispatch = !blockedKeys->IsBound(buttonEvent->device.get(), buttonEvent->idCode);
                     }
                 }
+
+                if (shouldDispatch && handle) {
+                    handler->Scan(*event, state, actions);
+                    stopBatch = stopBatch || (state.hotkeysBlocked && event->eventType == RE::INPUT_EVENT_TYPE::kButton);
+                }
+
+                // Remove event from chain if blocked
+                RE::InputEvent* nextEvent = event->next;
+                if (!shouldDispatch) {
+                    if (prev != nullptr) {
+                        prev->next = nextEvent;
+                    } else {
+                        *a_events = nextEvent;
+                    }
+                } else {
+                    prev = event;
+                }
+                event = nextEvent;
+            }
+
+            if (editorOpen) {
+                UICommandQueue::GetSingleton()->Post({ UICommandType::kRenderEditor });
             }
+            handler->SetStopBatch(stopBatch);
+        } else {
+            handler->SetStopBatch(false);
         }
 
         // Call original function (dispatches to event sinks)
         _DispatchInputEvent(a_dispatcher, a_events);
+
+        handler->Apply(actions, state);
     }
 
     static inline REL::Relocation<decltype(DispatchInputEvent)> _DispatchInputEvent;
+    static inline bool installed_ = false;
 };
 
 //=============================================================================
-// Input Handler
+// Dialog Lifecycle
 //=============================================================================
 
-class InputHandler : public RE::BSTEventSink<RE::InputEvent*> {
+/**
+ * A PersonalNotes.psc function dispatched by the bridge, with its latency probes.
+ */
+struct BridgeFunction {
+    const char* name;
+    Perf::Probe queueProbe;      // Dispatch → script called BridgeCallStarted
+    Perf::Probe roundTripProbe;  // Dispatch → completion callback
+};
+
+namespace BridgeFunctions {
+    inline constexpr BridgeFunction ShowQuestNoteInput{ "ShowQuestNoteInput", Perf::Probe::kQuestNoteQueue, Perf::Probe::kQuestNoteRoundTrip };
+    inline constexpr BridgeFunction ShowGeneralNoteInput{ "ShowGeneralNoteInput", Perf::Probe::kGeneralNoteQueue, Perf::Probe::kGeneralNoteRoundTrip };
+    inline constexpr BridgeFunction ShowNotesListMenu{ "ShowNotesListMenu", Perf::Probe::kNotesListQueue, Perf::Probe::kNotesListRoundTrip };
+}
+
+/**
+ * @class DialogTracker
+ * @brief Lifecycle of the Papyrus dialog we dispatched: idle → dispatched → open → closed → idle.
+ *
+ * - TryBegin() moves idle → dispatched when a bridge call is about to be queued.
+ *   Any other state means a dialog is already in flight and the request is dropped.
+ * - The first modal menu that opens while dispatched (or closed, for scripts that
+ *   chain menus like ShowNotesListMenu) moves to open; its close moves to closed.
+ * - The dispatched script's completion callback (DialogCallback) returns to idle.
+ *
+ * The callback is not guaranteed to run: the VM discards running stacks on load
+ * and quit-to-menu, and a third-party menu may never return. So TryBegin() also
+ * takes over a stale slot: dispatched for kDispatchTimeout without a menu, open
+ * for kDispatchTimeout after the tracked menu is gone (missed close event), or
+ * closed for kCompletionTimeout without completing. Reset() clears the slot on
+ * kPreLoadGame and Revert. A callback from a superseded dispatch carries an old
+ * dispatch ID and is ignored.
+ *
+ * Latency: the time from dispatch until the script calls BridgeCallStarted (its
+ * first statement) is the VM queueing delay; dispatch until completion is the
+ * round trip. Both feed the function's Perf probes.
+ *
+ * @thread_safety TryBegin(), Abort(), Reset() and ProcessEvent() run on the main
+ * thread; OnScriptStarted() and OnCompleted() on the VM thread. Dispatch details
+ * are guarded by lock_; state_ is atomic so GetState() needs no lock.
+ */
+class DialogTracker : public RE::BSTEventSink<RE::MenuOpenCloseEvent> {
 public:
-    static InputHandler* GetSingleton() {
-        static InputHandler instance;
+    enum class State : std::uint8_t {
+        kIdle,
+        kDispatched,  // DispatchStaticCall queued, script has not shown a menu yet
+        kOpen,        // Script's menu is open
+        kClosed       // Menu closed, script still running
+    };
+
+    static constexpr auto kDispatchTimeout = std::chrono::seconds(10);
+    static constexpr auto kCompletionTimeout = std::chrono::seconds(5);    // Menu closed, script should finish promptly
+    static constexpr auto kBacklogWarning = std::chrono::milliseconds(250);  // Queue delay players notice
+
+    /**
+     * @brief Get the singleton instance.
+     * @return Pointer to singleton instance (never null)
+     */
+    static DialogTracker* GetSingleton() {
+        static DialogTracker instance;
         return &instance;
     }
 
+    /**
+     * @brief Listen for menu open/close events (kDataLoaded).
+     */
     static void Register() {
-        auto input = RE::BSInputDeviceManager::GetSingleton();
-        if (input) {
-            input->AddEventSink(GetSingleton());
-            spdlog::info("[INPUT] Input handler registered");
+        if (auto ui = RE::UI::GetSingleton()) {
+            ui->AddEventSink<RE::MenuOpenCloseEvent>(GetSingleton());
+            spdlog::info("[DIALOG] Menu event sink registered");
         } else {
-            spdlog::error("[INPUT] Failed to get input device manager");
+            spdlog::error("[DIALOG] Failed to get UI for menu events");
         }
     }
 
-    RE::BSEventNotifyControl ProcessEvent(
-        RE::InputEvent* const* a_event,
-        RE::BSTEventSource<RE::InputEvent*>*) override {
-
-        // Track journal open/close for JournalNoteHelper lifecycle
-        auto player = RE::PlayerCharacter::GetSingleton();
-        if (player && player->Is3DLoaded()) {
-            bool isJournalOpen = IsJournalCurrentlyOpen();
-
-            if (isJournalOpen && !wasJournalOpen_) {
-                JournalNoteHelper::GetSingleton()->OnJournalOpen();
-            } else if (!isJournalOpen && wasJournalOpen_) {
-                JournalNoteHelper::GetSingleton()->OnJournalClose();
+    /**
+     * @brief Claim the dialog slot before dispatching a Papyrus dialog.
+     * @param function Bridge function about to be dispatched (for logging)
+     * @return false if another dialog is in flight; the caller must not dispatch
+     */
+    [[nodiscard]] bool TryBegin(const BridgeFunction& function) {
+        auto now = std::chrono::steady_clock::now();
+        std::lock_guard guard(lock_);
+        State state = state_.load(std::memory_order_acquire);
+        if (state != State::kIdle) {
+            if (!IsStaleLocked(state, now)) {
+                spdlog::debug("[DIALOG] Dropped {} ({} still in flight)", function.name, function_->name);
+                return false;
             }
-
-            wasJournalOpen_ = isJournalOpen;
-        }
-
-        if (!a_event) {
-            return RE::BSEventNotifyControl::kContinue;
+            spdlog::warn("[DIALOG] {} stuck in state {} for {} ms, assuming it was lost", function_->name,
+                         std::to_underlying(state),
+                         std::chrono::duration_cast<std::chrono::milliseconds>(now - stateSince_).count());
         }
+        dispatchedAt_ = stateSince_ = now;
+        function_ = &function;
+        ++dispatchID_;
+        started_ = false;
+        state_.store(State::kDispatched, std::memory_order_release);
+        return true;
+    }
 
-        // Process input events
-        for (auto event = *a_event; event; event = event->next) {
-            auto eventType = event->eventType;
+    /**
+     * @brief ID of the dispatch TryBegin() just claimed, for its completion callback.
+     */
+    [[nodiscard]] std::uint32_t CurrentDispatch() {
+        std::lock_guard guard(lock_);
+        return dispatchID_;
+    }
 
-            // Handle button events (keyboard, mouse clicks)
-            if (eventType == RE::INPUT_EVENT_TYPE::kButton) {
-                auto buttonEvent = event->AsButtonEvent();
-                if (!buttonEvent) {
-                    continue;
-                }
+    /**
+     * @brief The dispatched script started running (BridgeCallStarted native).
+     *
+     * Nested bridge scripts (ShowNotesListMenu → ShowQuestNoteInput) call it again; only the first counts.
+     */
+    void OnScriptStarted() {
+        std::lock_guard guard(lock_);
+        if (GetState() == State::kIdle || started_) {
+            return;
+        }
+        started_ = true;
+        auto queued = std::chrono::steady_clock::now() - dispatchedAt_;
+        Perf::Record(function_->queueProbe, queued);
+        if (queued > kBacklogWarning) {
+            spdlog::warn("[PAPYRUS] VM backlog: {} waited {} ms before running", function_->name,
+                         std::chrono::duration_cast<std::chrono::milliseconds>(queued).count());
+        }
+    }
 
-                // Check if in Journal Menu
-                bool inJournal = IsJournalCurrentlyOpen();
-                uint32_t keyCode = buttonEvent->idCode;
+    /**
+     * @brief Release the slot after a failed dispatch.
+     */
+    void Abort() {
+        std::lock_guard guard(lock_);
+        state_.store(State::kIdle, std::memory_order_release);
+        ++dispatchID_;  // A callback that still arrives for the failed dispatch is ignored
+    }
 
-                // Block hotkeys if modal dialogs open (TextInput, Console, etc.)
-                bool shouldBlockHotkeys = ShouldBlockHotkeys();
+    /**
+     * @brief Forget any dialog in flight (kPreLoadGame, Revert): its script stack is discarded.
+     */
+    void Reset() {
+        std::lock_guard guard(lock_);
+        if (state_.exchange(State::kIdle, std::memory_order_acq_rel) != State::kIdle) {
+            spdlog::info("[DIALOG] Reset with {} in flight", function_->name);
+        }
+        ++dispatchID_;  // Late callbacks from the discarded dispatch are ignored
+    }
 
-                // If blocking, stop event propagation
-                if (shouldBlockHotkeys) {
-                    return RE::BSEventNotifyControl::kStop;
-                }
+    /**
+     * @brief The dispatched script function returned (Papyrus completion callback).
+     * @param dispatchID CurrentDispatch() at dispatch time
+     */
+    void OnCompleted(std::uint32_t dispatchID) {
+        std::lock_guard guard(lock_);
+        if (dispatchID != dispatchID_) {
+            spdlog::debug("[DIALOG] Ignored completion of superseded dispatch {}", dispatchID);
+            return;
+        }
+        auto elapsed = std::chrono::steady_clock::now() - dispatchedAt_;
+        Perf::Record(function_->roundTripProbe, elapsed);
+        spdlog::debug("[DIALOG] {} completed after {} ms", function_->name,
+                      std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+        state_.store(State::kIdle, std::memory_order_release);
+    }
 
-                if (shouldBlockHotkeys && !inJournal) {
-                    continue;  // Skip our hotkey processing only
-                }
+    [[nodiscard]] State GetState() const {
+        return state_.load(std::memory_order_acquire);
+    }
 
-                if (inJournal) {
-                    // Update TextField on navigation RELEASE (arrow keys, mouse clicks, page keys)
-                    // Use IsUp() so Journal processes the input first, then we read the updated selection
-                    if (buttonEvent->IsUp()) {
-                        RE::FormID questID = GetCurrentQuestInJournal();
-                        auto helper = JournalNoteHelper::GetSingleton();
-
-                        // Keyboard navigation - mark as keyboard selection
-                        if (keyCode == KeyCodes::ARROW_UP ||
-                            keyCode == KeyCodes::ARROW_DOWN ||
-                            keyCode == KeyCodes::PAGE_UP ||
-                            keyCode == KeyCodes::PAGE_DOWN) {
-                            helper->SetKeyboardSelection(questID);
-                        }
-                        // Mouse click - regular update (switches back to mouse mode)
-                        else if (keyCode == KeyCodes::MOUSE_LEFT) {
-                            helper->UpdateTextField(questID);
-                        }
-                    }
-                }
+    /**
+     * @brief True while our dialog's menu is open and takes text input (EVM TextInput, not lists).
+     */
+    [[nodiscard]] bool IsTextInputOpen() const {
+        return GetState() == State::kOpen && textInput_.load(std::memory_order_acquire);
+    }
 
-                // Note hotkey - context-dependent behavior
-                if (buttonEvent->IsDown() && keyCode == SettingsManager::GetSingleton()->noteHotkeyScanCode) {
-                    if (inJournal) {
-                        // In Journal Menu → Quest note
-                        OnQuestNoteHotkey();
-                    } else {
-                        // During gameplay → General note
-                        MarkDialogShown();
-                        PapyrusBridge::ShowGeneralNoteInput();
-                    }
-                }
+    RE::BSEventNotifyControl ProcessEvent(
+        const RE::MenuOpenCloseEvent* a_event,
+        RE::BSTEventSource<RE::MenuOpenCloseEvent>*) override {
+        if (!a_event) {
+            return RE::BSEventNotifyControl::kContinue;
+        }
 
-                // Quick access hotkey - list all notes (outside journal only)
-                if (buttonEvent->IsDown() && keyCode == SettingsManager::GetSingleton()->quickAccessScanCode) {
-                    if (!inJournal) {
-                        // Show list of all notes
-                        MarkDialogShown();
-                        PapyrusBridge::ShowNotesListMenu();
-                    }
-                }
-            }
-            // Handle mouse move events (hover detection in Journal)
-            else if (eventType == RE::INPUT_EVENT_TYPE::kMouseMove) {
-                if (IsJournalCurrentlyOpen()) {
-                    // Mouse moved in Journal - update hover (respects keyboard selection)
-                    RE::FormID questID = GetCurrentQuestInJournal();
-                    JournalNoteHelper::GetSingleton()->UpdateMouseHover(questID);
-                }
+        std::lock_guard guard(lock_);
+        State state = state_.load(std::memory_order_acquire);
+        if (a_event->opening) {
+            if ((state == State::kDispatched || state == State::kClosed) &&
+                MenuHasFlag(a_event->menuName, RE::UI_MENU_FLAGS::kModal)) {
+                menuName_ = a_event->menuName;
+                textInput_.store(MenuHasFlag(a_event->menuName, RE::UI_MENU_FLAGS::kAllowTextInput),
+                                 std::memory_order_release);
+                stateSince_ = std::chrono::steady_clock::now();
+                state_.store(State::kOpen, std::memory_order_release);
             }
+        } else if (state == State::kOpen && a_event->menuName == menuName_) {
+            stateSince_ = std::chrono::steady_clock::now();
+            state_.store(State::kClosed, std::memory_order_release);
         }
 
         return RE::BSEventNotifyControl::kContinue;
     }
 
 private:
-    InputHandler() = default;
-
-    bool wasJournalOpen_ = false;  // Track journal state across events
-    std::chrono::steady_clock::time_point lastDialogShown_ = std::chrono::steady_clock::now() - std::chrono::seconds(10);  // Initialize to past time
+    DialogTracker() = default;
 
-    /**
-     * Helper to check if journal menu is currently open.
-     * @return true if Journal Menu is open
-     */
-    [[nodiscard]] bool IsJournalCurrentlyOpen() const {
+    static bool MenuHasFlag(const RE::BSFixedString& menuName, RE::UI_MENU_FLAGS flag) {
         auto ui = RE::UI::GetSingleton();
-        return ui && ui->IsMenuOpen("Journal Menu");
+        auto menu = ui ? ui->GetMenu(menuName) : nullptr;
+        return menu && menu->menuFlags.all(flag);
     }
 
     /**
-     * Check if hotkeys should be blocked (modal dialogs open, console, etc.)
-     * @return true if hotkeys should be blocked
+     * True if the dialog in flight should be given up on (main thread; lock_ held).
      */
-    [[nodiscard]] bool ShouldBlockHotkeys() const {
-        auto ui = RE::UI::GetSingleton();
-        if (!ui) {
-            return true;
+    [[nodiscard]] bool IsStaleLocked(State state, std::chrono::steady_clock::time_point now) const {
+        auto age = now - stateSince_;
+        switch (state) {
+        case State::kDispatched:
+            return age >= kDispatchTimeout;
+        case State::kOpen: {
+            // A dialog may stay open as long as the player types; only a missed close counts
+            auto ui = RE::UI::GetSingleton();
+            return age >= kDispatchTimeout && !(ui && ui->IsMenuOpen(menuName_));
         }
-
-        // Always block in console
-        if (ui->IsMenuOpen(RE::Console::MENU_NAME)) {
-            return true;
+        case State::kClosed:
+            return age >= kCompletionTimeout;
+        default:
+            return false;
         }
+    }
 
-        // PROPER detection: Check if modal dialog is open (ExtendedVanillaMenus TextInput)
-        if (ui->IsModalMenuOpen()) {
-            bool journalOpen = IsJournalCurrentlyOpen();
-            // If modal AND not JUST Journal (Journal isn't modal), it's TextInput or similar
-            if (!journalOpen || ui->menuStack.size() > 1) {
-                return true;
-            }
-        }
+    std::atomic<State> state_{ State::kIdle };
+    std::atomic<bool> textInput_{ false };  // Menu that moved us to kOpen allows text input
 
-        return false;
-    }
+    std::mutex lock_;  // Guards everything below
+    std::chrono::steady_clock::time_point dispatchedAt_;
+    std::chrono::steady_clock::time_point stateSince_;  // Last state change, for the stale checks
+    const BridgeFunction* function_ = &BridgeFunctions::ShowQuestNoteInput;  // Bridge function that owns the slot
+    std::uint32_t dispatchID_ = 0;  // Incremented per dispatch and on Reset()
+    bool started_ = false;          // BridgeCallStarted seen for the current dispatch
+    RE::BSFixedString menuName_;    // Menu that moved us to kOpen
+};
 
-    /**
-     * Mark that a dialog was just shown (blocks hotkeys temporarily)
-     */
-    void MarkDialogShown() {
-        lastDialogShown_ = std::chrono::steady_clock::now();
+// Declared in InputDispatchHook, defined here once DialogTracker is complete
+bool InputDispatchHook::ShouldFilterControls(const InputHandler::UIState& state, bool editorOpen) {
+    return state.modalOpen && (editorOpen || DialogTracker::GetSingleton()->IsTextInputOpen());
+}
+
+/**
+ * Completion callback for dialog dispatches: returns DialogTracker to idle once
+ * the script function has returned (after the dialog closed and the note was saved).
+ */
+class DialogCallback : public RE::BSScript::IStackCallbackFunctor {
+public:
+    explicit DialogCallback(std::uint32_t dispatchID)
+        : dispatchID_(dispatchID) {}
+
+    void operator()(RE::BSScript::Variable) override {
+        DialogTracker::GetSingleton()->OnCompleted(dispatchID_);
     }
 
-    void OnQuestNoteHotkey() {
-        // MUST be in Journal Menu
-        if (!IsJournalCurrentlyOpen()) {
-            return;
-        }
+    bool CanSave() const override {
+        return false;  // Dialogs do not survive a save/load
+    }
 
-        // Get current quest
-        RE::FormID questID = GetCurrentQuestInJournal();
-        if (questID == 0) {
-            RE::DebugNotification("No quest selected");
-            return;
-        }
+    void SetObject(const RE::BSTSmartPointer<RE::BSScript::Object>&) override {}
 
-        // Mark dialog shown to block hotkeys temporarily
-        MarkDialogShown();
+private:
+    std::uint32_t dispatchID_;
+};
 
-        // Show note input dialog
-        PapyrusBridge::ShowQuestNoteInput(questID);
+/**
+ * @brief Dispatch a dialog script function with lifecycle tracking.
+ * @return false if the VM rejected the call (slot already released)
+ */
+bool DispatchDialog(RE::BSScript::Internal::VirtualMachine* vm, const BridgeFunction& function, RE::BSScript::IFunctionArguments* args) {
+    RE::BSTSmartPointer<RE::BSScript::IStackCallbackFunctor> callback{
+        new DialogCallback(DialogTracker::GetSingleton()->CurrentDispatch())
+    };
+    if (!vm->DispatchStaticCall("PersonalNotes", function.name, args, callback)) {
+        spdlog::error("[PAPYRUS] Failed to dispatch PersonalNotes.{}", function.name);
+        DialogTracker::GetSingleton()->Abort();
+        return false;
     }
-};
+    return true;
+}
 
 //=============================================================================
 // Papyrus Bridge Utilities
@@ -1538,6 +6154,7 @@ namespace PapyrusBridge {
      * Displays Extended Vanilla Menus text input with existing note content.
      */
     void ShowQuestNoteInput(RE::FormID questID) {
+        Trace::Scope trace("PapyrusBridge::ShowQuestNoteInput", "papyrus");
         auto vm = RE::BSScript::Internal::VirtualMachine::GetSingleton();
         if (!vm) {
             spdlog::error("[PAPYRUS] Failed to get VM");
@@ -1552,6 +6169,16 @@ namespace PapyrusBridge {
         auto mgr = NoteManager::GetSingleton();
         std::string existingText = mgr->GetNoteForQuest(questID);
 
+        // Native editor skips the VM entirely
+        if (NoteEditor::GetSingleton()->Open(questID, questName, existingText)) {
+            return;
+        }
+
+        // Drop repeats while a dialog is already in flight
+        if (!DialogTracker::GetSingleton()->TryBegin(BridgeFunctions::ShowQuestNoteInput)) {
+            return;
+        }
+
         // Get TextInput settings (reload if changed)
         auto settings = SettingsManager::GetSingleton();
         settings->ReloadIfChanged();
@@ -1567,8 +6194,7 @@ namespace PapyrusBridge {
             static_cast<std::int32_t>(settings->textInputAlignment)
         );
 
-        RE::BSTSmartPointer<RE::BSScript::IStackCallbackFunctor> callback;
-        vm->DispatchStaticCall("PersonalNotes", "ShowQuestNoteInput", args, callback);
+        DispatchDialog(vm, BridgeFunctions::ShowQuestNoteInput, args);
     }
 
     /**
@@ -1579,6 +6205,8 @@ namespace PapyrusBridge {
      * Native function registered for Papyrus. Converts FormID and saves note.
      */
     void SaveQuestNote(RE::StaticFunctionTag*, std::int32_t questIDSigned, RE::BSFixedString noteText) {
+        Trace::Scope trace("PapyrusBridge::SaveQuestNote", "papyrus");
+
         // Convert Papyrus int32 to FormID (handles modded forms with high FormIDs)
         RE::FormID questID = PapyrusIntToFormID(questIDSigned);
 
@@ -1590,9 +6218,7 @@ namespace PapyrusBridge {
         std::string text{noteText.c_str()};
         NoteManager::GetSingleton()->SaveNoteForQuest(questID, text);
 
-        // Update TextField to reflect new note state immediately (force update even if same quest)
-        JournalNoteHelper::GetSingleton()->UpdateTextField(questID, true);
-
+        // Journal TextField refresh is posted to the UICommandQueue by JournalNoteHelper's subscription
         RE::DebugNotification("Quest note saved!");
     }
 
@@ -1603,6 +6229,7 @@ namespace PapyrusBridge {
      * Displays Extended Vanilla Menus text input with existing general note content.
      */
     void ShowGeneralNoteInput() {
+        Trace::Scope trace("PapyrusBridge::ShowGeneralNoteInput", "papyrus");
         auto vm = RE::BSScript::Internal::VirtualMachine::GetSingleton();
         if (!vm) {
             spdlog::error("[PAPYRUS] Failed to get VM");
@@ -1612,6 +6239,16 @@ namespace PapyrusBridge {
         // Get existing general note text
         std::string existingText = NoteManager::GetSingleton()->GetGeneralNote();
 
+        // Native editor skips the VM entirely
+        if (NoteEditor::GetSingleton()->Open(NoteManager::GENERAL_NOTE_ID, "", existingText)) {
+            return;
+        }
+
+        // Drop repeats while a dialog is already in flight
+        if (!DialogTracker::GetSingleton()->TryBegin(BridgeFunctions::ShowGeneralNoteInput)) {
+            return;
+        }
+
         // Get TextInput settings (reload if changed)
         auto settings = SettingsManager::GetSingleton();
         settings->ReloadIfChanged();
@@ -1626,8 +6263,7 @@ namespace PapyrusBridge {
             static_cast<std::int32_t>(settings->textInputAlignment)
         );
 
-        RE::BSTSmartPointer<RE::BSScript::IStackCallbackFunctor> callback;
-        vm->DispatchStaticCall("PersonalNotes", "ShowGeneralNoteInput", args, callback);
+        DispatchDialog(vm, BridgeFunctions::ShowGeneralNoteInput, args);
     }
 
     /**
@@ -1637,6 +6273,7 @@ namespace PapyrusBridge {
      * Native function registered for Papyrus. Saves general note not tied to any quest.
      */
     void SaveGeneralNote(RE::StaticFunctionTag*, RE::BSFixedString noteText) {
+        Trace::Scope trace("PapyrusBridge::SaveGeneralNote", "papyrus");
         std::string text(noteText.c_str());
         NoteManager::GetSingleton()->SaveGeneralNote(text);
 
@@ -1650,49 +6287,60 @@ namespace PapyrusBridge {
      * Retrieves all notes and displays them in a selectable list menu.
      */
     void ShowNotesListMenu() {
+        Trace::Scope trace("PapyrusBridge::ShowNotesListMenu", "papyrus");
         auto vm = RE::BSScript::Internal::VirtualMachine::GetSingleton();
         if (!vm) {
             spdlog::error("[PAPYRUS] Failed to get VM");
             return;
         }
 
+        // Drop repeats while a dialog is already in flight (before copying every note)
+        if (!DialogTracker::GetSingleton()->TryBegin(BridgeFunctions::ShowNotesListMenu)) {
+            return;
+        }
+
         // Get all notes
         auto notes = NoteManager::GetSingleton()->GetAllNotes();
         if (notes.empty()) {
+            DialogTracker::GetSingleton()->Abort();
             RE::DebugNotification("No notes saved");
             return;
         }
 
         // Build arrays for Papyrus
-        std::vector<RE::BSFixedString> questNames;
-        std::vector<RE::BSFixedString> notePreviews;
-        std::vector<RE::BSFixedString> noteTexts;
-        std::vector<std::int32_t> questIDs;
+        using MemStats::Subsystem;
+        MemStats::Vector<RE::BSFixedString, Subsystem::kBridge> questNames;
+        MemStats::Vector<RE::BSFixedString, Subsystem::kBridge> notePreviews;
+        MemStats::Vector<RE::BSFixedString, Subsystem::kBridge> noteTexts;
+        MemStats::Vector<std::int32_t, Subsystem::kBridge> questIDs;
+
+        // Every BSFixedString interns its text in the game's string cache (text must be NUL-terminated)
+        auto intern = [](const auto& text) {
+            std::string_view view(text);
+            MemStats::OnExternalAllocate(Subsystem::kInternedStrings, view.size() + 1);
+            return RE::BSFixedString(view.data());
+        };
 
         // Add "Export All Notes" option at index 0 (special ID: -2)
-        questNames.push_back(RE::BSFixedString("--- Export All Notes ---"));
-        notePreviews.push_back(RE::BSFixedString("Save all notes to JSON file"));
-        noteTexts.push_back(RE::BSFixedString(""));  // No text for export option
+        questNames.push_back(intern("--- Export All Notes ---"));
+        notePreviews.push_back(intern("Save all notes to JSON file"));
+        noteTexts.push_back(intern(""));  // No text for export option
         questIDs.push_back(-2);  // Special ID for export action
 
+        auto nameCache = QuestNameCache::GetSingleton();
         for (const auto& [questID, note] : notes) {
             // Quest name
-            if (questID == NoteManager::GENERAL_NOTE_ID) {
-                questNames.push_back(RE::BSFixedString("General Note"));
-            } else {
-                auto quest = RE::TESForm::LookupByID<RE::TESQuest>(questID);
-                std::string questName = quest ? quest->GetName() : "Unknown Quest";
-                questNames.push_back(RE::BSFixedString(questName));
-            }
+            questNames.push_back(intern(nameCache->GetName(questID)));
 
             // Note preview (first 50 chars for list display)
-            std::string preview = note.text.length() > 50
-                ? note.text.substr(0, 50) + "..."
-                : note.text;
-            notePreviews.push_back(RE::BSFixedString(preview));
+            std::string_view text = note.text;
+            std::string preview = text.length() > 50
+                ? std::string(text.substr(0, 50)) + "..."
+                : std::string(text);
+            notePreviews.push_back(intern(preview));
 
             // Full note text (for editing)
-            noteTexts.push_back(RE::BSFixedString(note.text));
+            noteTexts.push_back(intern(note.text));
 
             // Quest ID
             questIDs.push_back(static_cast<std::int32_t>(questID));
@@ -1714,8 +6362,7 @@ namespace PapyrusBridge {
             static_cast<std::int32_t>(settings->textInputAlignment)
         );
 
-        RE::BSTSmartPointer<RE::BSScript::IStackCallbackFunctor> callback;
-        vm->DispatchStaticCall("PersonalNotes", "ShowNotesListMenu", args, callback);
+        DispatchDialog(vm, BridgeFunctions::ShowNotesListMenu, args);
     }
 
     /**
@@ -1726,23 +6373,480 @@ namespace PapyrusBridge {
         BackupManager::ExportNotesToJSON();
     }
 
+    /**
+     * @brief Convert a backup between JSON and .pnb (called from Papyrus or the console).
+     * @param fileName File name inside the backup folder; the copy is written next to it
+     */
+    void ConvertBackup(RE::StaticFunctionTag*, RE::BSFixedString fileName) {
+        std::string name(fileName.c_str());
+        if (name.empty() || std::filesystem::path(name).filename().string() != name) {
+            spdlog::warn("[BACKUP] ConvertBackup expects a file name inside the backup folder, got '{}'", name);
+            return;
+        }
+        JobSystem::GetSingleton()->SubmitThen(JobPriority::kBackground,
+            [name]() { return BackupManager::ConvertBackup(name); },
+            [](bool success) {
+                RE::DebugNotification(success ? "Backup converted" : "Backup conversion failed");
+            });
+    }
+
+    /**
+     * @brief List backups from the catalog, newest first (called from Papyrus).
+     * @return Labels like "Dragonborn - 2025-11-17 14:30 - 12 notes - <file name>"
+     */
+    std::vector<RE::BSFixedString> GetBackupList(RE::StaticFunctionTag*) {
+        std::vector<RE::BSFixedString> result;
+        for (const auto& entry : BackupManager::Catalog::List()) {
+            std::tm tm{};
+            localtime_s(&tm, &entry.created);  // Papyrus VM thread: std::localtime's shared buffer is not safe here
+            std::ostringstream label;
+            label << entry.playerName << " - " << std::put_time(&tm, "%Y-%m-%d %H:%M") << " - "
+                  << entry.noteCount << (entry.base.empty() ? " notes - " : " changed notes - ") << entry.file;
+            result.emplace_back(label.str());
+        }
+        return result;
+    }
+
+    //-------------------------------------------------------------------------
+    // Query API (read-only, for other mods and MCM pages)
+    //-------------------------------------------------------------------------
+
+    /**
+     * Converts FormIDs to the Papyrus int[] representation.
+     */
+    std::vector<std::int32_t> FormIDsToPapyrus(const std::vector<RE::FormID>& ids) {
+        std::vector<std::int32_t> result;
+        result.reserve(ids.size());
+        for (RE::FormID id : ids) {
+            result.push_back(static_cast<std::int32_t>(id));
+        }
+        return result;
+    }
+
+    /**
+     * @brief Get note text for a quest (called from Papyrus).
+     * @param questIDSigned Quest FormID as signed int32 (-1 for the general note)
+     * @return Note text, empty string if no note exists
+     */
+    RE::BSFixedString GetNoteText(RE::StaticFunctionTag*, std::int32_t questIDSigned) {
+        RE::BSFixedString result;
+        NoteManager::GetSingleton()->VisitNote(PapyrusIntToFormID(questIDSigned), [&](const Note& note) {
+            result = note.text.c_str();
+        });
+        return result;
+    }
+
+    /**
+     * @brief Check if a note exists for a quest (called from Papyrus).
+     * @param questIDSigned Quest FormID as signed int32 (-1 for the general note)
+     */
+    bool HasNote(RE::StaticFunctionTag*, std::int32_t questIDSigned) {
+        return NoteManager::GetSingleton()->HasNoteForQuest(PapyrusIntToFormID(questIDSigned));
+    }
+
+    /**
+     * @brief Get total number of notes (called from Papyrus).
+     */
+    std::int32_t GetNoteCount(RE::StaticFunctionTag*) {
+        return static_cast<std::int32_t>(NoteManager::GetSingleton()->GetNoteCount());
+    }
+
+    /**
+     * @brief Get last write time of a note (called from Papyrus).
+     * @param questIDSigned Quest FormID as signed int32 (-1 for the general note)
+     * @return Unix timestamp in seconds, 0 if no note exists
+     */
+    std::int32_t GetNoteTimestamp(RE::StaticFunctionTag*, std::int32_t questIDSigned) {
+        std::int32_t result = 0;
+        NoteManager::GetSingleton()->VisitNote(PapyrusIntToFormID(questIDSigned), [&](const Note& note) {
+            result = static_cast<std::int32_t>(note.modified);
+        });
+        return result;
+    }
+
+    /**
+     * @brief Get a page of note FormIDs in ascending FormID order (called from Papyrus).
+     * @param offset Index of the first ID (negative treated as 0)
+     * @param count Maximum number of IDs to return (negative treated as 0)
+     */
+    std::vector<std::int32_t> GetNoteIDs(RE::StaticFunctionTag*, std::int32_t offset, std::int32_t count) {
+        offset = std::max(offset, 0);
+        count = std::max(count, 0);
+        return FormIDsToPapyrus(NoteManager::GetSingleton()->GetNoteIDs(
+            static_cast<size_t>(offset), static_cast<size_t>(count)));
+    }
+
+    /**
+     * @brief Get FormIDs of notes written at or after a timestamp (called from Papyrus).
+     * @param timestamp Unix timestamp in seconds (e.g. a previous GetNoteTimestamp result)
+     */
+    std::vector<std::int32_t> GetModifiedSince(RE::StaticFunctionTag*, std::int32_t timestamp) {
+        return FormIDsToPapyrus(NoteManager::GetSingleton()->GetNoteIDsModifiedSince(
+            static_cast<std::time_t>(timestamp)));
+    }
+
+    /**
+     * @brief First statement of every dispatched PersonalNotes.psc function (latency marker).
+     */
+    void BridgeCallStarted(RE::StaticFunctionTag*) {
+        DialogTracker::GetSingleton()->OnScriptStarted();
+    }
+
+    /**
+     * @brief Write hot-path timing summaries to the log (called from Papyrus or the console).
+     */
+    void LogPerfStats(RE::StaticFunctionTag*) {
+        Perf::LogSummaries();
+    }
+
+    /**
+     * @brief Write per-subsystem heap usage to the log (called from Papyrus or the console).
+     */
+    void LogMemoryStats(RE::StaticFunctionTag*) {
+        MemStats::LogUsage("on demand");
+    }
+
+    /**
+     * @brief Start or stop trace recording (called from Papyrus or the console).
+     * @return true if recording is now running
+     */
+    bool ToggleTrace(RE::StaticFunctionTag*) {
+        if (Trace::Stop()) {
+            return false;  // Notification follows once the file is written
+        }
+        if (Trace::Start()) {
+            RE::DebugNotification("Trace recording started");
+            return true;
+        }
+        RE::DebugNotification("Previous trace is still being written");
+        return false;
+    }
+
     /**
      * @brief Register native Papyrus functions.
      * @param vm Papyrus virtual machine
      * @return true on success
      *
      * Registers SaveQuestNote, SaveGeneralNote, and ExportAllNotes as native functions
-     * callable from Papyrus scripts.
+     * callable from Papyrus scripts, plus the read-only query functions. Queries only
+     * take NoteManager's shared lock, so they are registered as callable from tasklets
+     * and return without waiting for the next frame sync. The diagnostics
+     * (LogPerfStats, ToggleTrace, LogMemoryStats) show notifications and start
+     * or stop the trace writer, so they stay on the main thread like the writes.
      */
     bool Register(RE::BSScript::IVirtualMachine* vm) {
         vm->RegisterFunction("SaveQuestNote", "PersonalNotesNative", SaveQuestNote);
         vm->RegisterFunction("SaveGeneralNote", "PersonalNotesNative", SaveGeneralNote);
         vm->RegisterFunction("ExportAllNotes", "PersonalNotesNative", ExportAllNotes);
+        vm->RegisterFunction("GetBackupList", "PersonalNotesNative", GetBackupList);
+        vm->RegisterFunction("ConvertBackup", "PersonalNotesNative", ConvertBackup);
+        vm->RegisterFunction("LogPerfStats", "PersonalNotesNative", LogPerfStats);
+        vm->RegisterFunction("ToggleTrace", "PersonalNotesNative", ToggleTrace);
+        vm->RegisterFunction("LogMemoryStats", "PersonalNotesNative", LogMemoryStats);
+        vm->RegisterFunction("GetNoteText", "PersonalNotesNative", GetNoteText, true);
+        vm->RegisterFunction("HasNote", "PersonalNotesNative", HasNote, true);
+        vm->RegisterFunction("GetNoteCount", "PersonalNotesNative", GetNoteCount, true);
+        vm->RegisterFunction("GetNoteTimestamp", "PersonalNotesNative", GetNoteTimestamp, true);
+        vm->RegisterFunction("GetNoteIDs", "PersonalNotesNative", GetNoteIDs, true);
+        vm->RegisterFunction("GetModifiedSince", "PersonalNotesNative", GetModifiedSince, true);
+        vm->RegisterFunction("BridgeCallStarted", "PersonalNotesNative", BridgeCallStarted, true);
         spdlog::info("[PAPYRUS] Native functions registered");
         return true;
     }
 }
 
+//=============================================================================
+// Plugin API (SKSE messaging, see PersonalNotesAPI.h)
+//=============================================================================
+
+/**
+ * Snapshot handle handed out through the plugin API. Keeps NoteManager's
+ * immutable snapshot alive so borrowed views stay valid until release.
+ */
+struct PersonalNotesAPI::Snapshot {
+    std::shared_ptr<const NoteSnapshot> data;
+};
+
+namespace PluginAPI {
+    using PersonalNotesAPI::ChangeCallback;
+    using PersonalNotesAPI::ChangeEvent;
+    using PersonalNotesAPI::NoteView;
+    using PersonalNotesAPI::NoteVisitor;
+    using PersonalNotesAPI::NoteWrite;
+    using PersonalNotesAPI::Snapshot;
+    using PersonalNotesAPI::SubscriptionHandle;
+
+    struct Subscriber {
+        SubscriptionHandle handle;
+        ChangeCallback callback;
+        void* user;
+    };
+
+    // Copy-on-write subscriber list: publishers copy the pointer and call without holding the lock
+    std::shared_ptr<const std::vector<Subscriber>> subscribers = std::make_shared<std::vector<Subscriber>>();
+    SubscriptionHandle nextSubscriptionHandle = 1;
+    std::mutex subscribersLock;
+    std::once_flag registerOnce;
+
+    /**
+     * @brief Forward a NoteManager change to all plugin API subscribers.
+     * @param change The change that was just committed
+     *
+     * Sync NoteManager subscriber: runs on the writing thread, as documented in PersonalNotesAPI.h.
+     */
+    void OnNoteChanged(const NoteChangeEvent& change) {
+        std::shared_ptr<const std::vector<Subscriber>> current;
+        {
+            std::lock_guard lock(subscribersLock);
+            current = subscribers;
+        }
+        if (current->empty()) {
+            return;
+        }
+
+        ChangeEvent event{ change.questID, PersonalNotesAPI::ChangeKind::kReset, change.generation };
+        switch (change.kind) {
+        case NoteChangeKind::kSaved:   event.kind = PersonalNotesAPI::ChangeKind::kSaved; break;
+        case NoteChangeKind::kDeleted: event.kind = PersonalNotesAPI::ChangeKind::kDeleted; break;
+        case NoteChangeKind::kReset:   event.kind = PersonalNotesAPI::ChangeKind::kReset; break;
+        }
+
+        for (const auto& subscriber : *current) {
+            subscriber.callback(&event, subscriber.user);
+        }
+    }
+
+    /**
+     * @brief Subscribe the plugin API to NoteManager change events.
+     *
+     * Done on the first API Subscribe() call; without API subscribers there is nothing to forward.
+     */
+    void Register() {
+        NoteManager::GetSingleton()->Subscribe("PluginAPI", NoteDelivery::kSync, OnNoteChanged);
+    }
+
+    NoteView MakeView(const Note& note) {
+        return {
+            note.questID,
+            static_cast<std::uint32_t>(note.text.size()),
+            note.text.c_str(),
+            static_cast<std::int64_t>(note.modified)
+        };
+    }
+
+    bool VisitNote(std::uint32_t formID, NoteVisitor visitor, void* user) {
+        if (!visitor) {
+            return false;
+        }
+        return NoteManager::GetSingleton()->VisitNote(formID, [&](const Note& note) {
+            NoteView view = MakeView(note);
+            visitor(&view, user);
+        });
+    }
+
+    bool HasNote(std::uint32_t formID) {
+        return NoteManager::GetSingleton()->HasNoteForQuest(formID);
+    }
+
+    std::uint32_t GetNoteCount() {
+        return static_cast<std::uint32_t>(NoteManager::GetSingleton()->GetNoteCount());
+    }
+
+    std::uint64_t GetGeneration() {
+        return NoteManager::GetSingleton()->GetGeneration();
+    }
+
+    Snapshot* AcquireSnapshot() {
+        return new Snapshot{ NoteManager::GetSingleton()->GetSnapshot() };
+    }
+
+    void ReleaseSnapshot(Snapshot* snapshot) {
+        delete snapshot;
+    }
+
+    std::uint64_t GetSnapshotGeneration(const Snapshot* snapshot) {
+        return snapshot ? snapshot->data->generation : 0;
+    }
+
+    std::uint32_t GetSnapshotSize(const Snapshot* snapshot) {
+        return snapshot ? static_cast<std::uint32_t>(snapshot->data->notes.size()) : 0;
+    }
+
+    bool GetSnapshotNote(const Snapshot* snapshot, std::uint32_t index, NoteView* out) {
+        if (!snapshot || !out || index >= snapshot->data->notes.size()) {
+            return false;
+        }
+        *out = MakeView(snapshot->data->notes[index]);
+        return true;
+    }
+
+    bool FindSnapshotNote(const Snapshot* snapshot, std::uint32_t formID, NoteView* out) {
+        if (!snapshot || !out) {
+            return false;
+        }
+        const auto& notes = snapshot->data->notes;
+        auto it = std::ranges::lower_bound(notes, formID, {}, &Note::questID);
+        if (it == notes.end() || it->questID != formID) {
+            return false;
+        }
+        *out = MakeView(*it);
+        return true;
+    }
+
+    SubscriptionHandle Subscribe(ChangeCallback callback, void* user) {
+        if (!callback) {
+            return 0;
+        }
+        std::call_once(registerOnce, Register);
+
+        std::lock_guard lock(subscribersLock);
+        auto updated = std::make_shared<std::vector<Subscriber>>(*subscribers);
+        SubscriptionHandle handle = nextSubscriptionHandle++;
+        updated->push_back({ handle, callback, user });
+        subscribers = std::move(updated);
+        return handle;
+    }
+
+    void Unsubscribe(SubscriptionHandle handle) {
+        std::lock_guard lock(subscribersLock);
+        auto updated = std::make_shared<std::vector<Subscriber>>(*subscribers);
+        std::erase_if(*updated, [handle](const Subscriber& s) { return s.handle == handle; });
+        subscribers = std::move(updated);
+    }
+
+    std::uint32_t WriteNotes(const NoteWrite* writes, std::uint32_t count) {
+        if (!writes || count == 0) {
+            return 0;
+        }
+
+        std::vector<std::pair<RE::FormID, std::string_view>> batch;
+        batch.reserve(count);
+        for (std::uint32_t i = 0; i < count; ++i) {
+            const NoteWrite& write = writes[i];
+            if (write.length > 0 && !write.text) {
+                spdlog::warn("[API] Skipping write for 0x{:X}: null text with length {}", write.formID, write.length);
+                continue;
+            }
+            batch.emplace_back(write.formID, std::string_view(write.text ? write.text : "", write.length));
+        }
+
+        return static_cast<std::uint32_t>(NoteManager::GetSingleton()->SaveNotes(batch));
+    }
+
+    const PersonalNotesAPI::InterfaceV1 interfaceV1{
+        PersonalNotesAPI::kInterfaceVersion1,
+        sizeof(PersonalNotesAPI::InterfaceV1),
+        VisitNote,
+        HasNote,
+        GetNoteCount,
+        GetGeneration,
+        AcquireSnapshot,
+        ReleaseSnapshot,
+        GetSnapshotGeneration,
+        GetSnapshotSize,
+        GetSnapshotNote,
+        FindSnapshotNote,
+        Subscribe,
+        Unsubscribe,
+        WriteNotes
+    };
+
+    /**
+     * @brief Answer interface requests from other plugins.
+     * @param msg SKSE message (only kMessage_RequestInterface is handled)
+     */
+    void HandleMessage(SKSE::MessagingInterface::Message* msg) {
+        if (!msg || msg->type != PersonalNotesAPI::kMessage_RequestInterface) {
+            return;
+        }
+
+        const char* sender = msg->sender ? msg->sender : "unknown";
+        if (!msg->data || msg->dataLen < sizeof(PersonalNotesAPI::InterfaceRequest)) {
+            spdlog::warn("[API] Malformed interface request from {}", sender);
+            return;
+        }
+
+        auto request = static_cast<PersonalNotesAPI::InterfaceRequest*>(msg->data);
+        if (request->version == PersonalNotesAPI::kInterfaceVersion1) {
+            request->api = &interfaceV1;
+            spdlog::info("[API] Provided interface v{} to {}", request->version, sender);
+        } else {
+            request->api = nullptr;
+            spdlog::warn("[API] {} requested unsupported interface version {}", sender, request->version);
+        }
+    }
+}
+
+//=============================================================================
+// Startup Timeline
+//=============================================================================
+
+/**
+ * @class StartupTimeline
+ * @brief Times plugin init phases and logs them as one block per stage.
+ *
+ * Phases are buffered rather than logged immediately, so SetupLog() itself can be
+ * timed. Only used from SKSE load and messaging callbacks (main thread).
+ */
+class StartupTimeline {
+public:
+    /**
+     * @brief Get the singleton instance.
+     * @return Pointer to singleton instance (never null)
+     */
+    static StartupTimeline* GetSingleton() {
+        static StartupTimeline instance;
+        return &instance;
+    }
+
+    /**
+     * @class Phase
+     * @brief Records the lifetime of the scope as a named init phase.
+     */
+    class Phase {
+    public:
+        explicit Phase(const char* name)
+            : name_(name), start_(std::chrono::steady_clock::now()) {}
+
+        ~Phase() {
+            GetSingleton()->phases_.push_back({ name_, std::chrono::steady_clock::now() - start_ });
+        }
+
+        Phase(const Phase&) = delete;
+        Phase& operator=(const Phase&) = delete;
+
+    private:
+        const char* name_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    /**
+     * @brief Log and clear the phases recorded since the last flush.
+     * @param stage Name of the stage that just finished (e.g. "SKSE load")
+     */
+    void Flush(const char* stage) {
+        std::chrono::nanoseconds total{ 0 };
+        for (const auto& phase : phases_) {
+            total += phase.duration;
+        }
+        spdlog::info("[INIT] {} took {}", stage, Perf::FormatDuration(static_cast<std::uint64_t>(total.count())));
+        for (const auto& phase : phases_) {
+            spdlog::info("[INIT]   {}: {}", phase.name, Perf::FormatDuration(static_cast<std::uint64_t>(phase.duration.count())));
+        }
+        phases_.clear();
+    }
+
+private:
+    StartupTimeline() = default;
+
+    struct Entry {
+        const char* name;
+        std::chrono::nanoseconds duration;
+    };
+
+    std::vector<Entry> phases_;
+};
+
 //=============================================================================
 // Logging Setup
 //=============================================================================
@@ -1777,74 +6881,141 @@ void SetupLog() {
 
 void MessageHandler(SKSE::MessagingInterface::Message* msg) {
     switch (msg->type) {
-    case SKSE::MessagingInterface::kDataLoaded:
+    case SKSE::MessagingInterface::kDataLoaded: {
+        using Phase = StartupTimeline::Phase;
+
+        // Settings were loaded on a worker during plugin init
+        {
+            Phase phase("Wait for settings");
+            SettingsManager::GetSingleton()->WaitUntilLoaded();
+        }
+        if (SettingsManager::GetSingleton()->traceOnStartup) {
+            Trace::Start();
+        }
 
         // Register Papyrus functions
-        if (auto vm = RE::BSScript::Internal::VirtualMachine::GetSingleton()) {
-            PapyrusBridge::Register(vm);
-        } else {
-            spdlog::error("[MESSAGE] Failed to get VM for Papyrus registration");
+        {
+            Phase phase("Papyrus registration");
+            if (auto vm = RE::BSScript::Internal::VirtualMachine::GetSingleton()) {
+                PapyrusBridge::Register(vm);
+            } else {
+                spdlog::error("[MESSAGE] Failed to get VM for Papyrus registration");
+            }
+        }
+
+        // Start handling input after game data is loaded
+        {
+            Phase phase("Input handler");
+            InputHandler::Register(InputDispatchHook::IsInstalled());
+            DialogTracker::Register();
+            NoteEditor::Register();
         }
 
-        // Register input handler after game data is loaded
-        InputHandler::Register();
+        // Subscribe change consumers to NoteManager (forms are resolvable from here on)
+        {
+            Phase phase("NoteManager subscribers");
+            JournalNoteHelper::Register();
+            QuestNameCache::Register();
+            NotePreviewCache::Register();
+        }
 
         spdlog::info("[MESSAGE] kDataLoaded - Handlers registered");
+        StartupTimeline::GetSingleton()->Flush("kDataLoaded");
+        break;
+    }
+    case SKSE::MessagingInterface::kPreLoadGame:
+        // Parse the import file during the load screen instead of inside the load callback
+        BackupManager::DeferredImport::Begin();
+        BackupManager::AutoBackup::Reset();
+        NoteEditor::GetSingleton()->Reset();
+        DialogTracker::GetSingleton()->Reset();
+        break;
+    case SKSE::MessagingInterface::kPostLoadGame:
+        // Co-save is loaded: merge the import on top of it (imported notes win)
+        BackupManager::DeferredImport::Complete(static_cast<bool>(msg->data));
         break;
     }
 }
 
 void InitializePlugin() {
-    SetupLog();
-
-    // Load settings from INI
-    SettingsManager::GetSingleton()->LoadSettings();
-
-    // Register serialization callbacks
-    auto serialization = SKSE::GetSerializationInterface();
-    if (serialization) {
-        serialization->SetUniqueID(NoteManager::kDataKey);
-
-        serialization->SetSaveCallback([](SKSE::SerializationInterface* intfc) {
-            if (!intfc->OpenRecord(NoteManager::kDataKey, NoteManager::kSerializationVersion)) {
-                spdlog::error("[SAVE] Failed to open save record");
-                return;
-            }
-            NoteManager::GetSingleton()->Save(intfc);
-        });
+    using Phase = StartupTimeline::Phase;
 
-        serialization->SetLoadCallback([](SKSE::SerializationInterface* intfc) {
-            NoteManager::GetSingleton()->Load(intfc);
-
-            // Import notes after loading co-save (merge import with loaded data)
-            int importedCount = BackupManager::ImportNotesFromJSON();
-            if (importedCount > 0) {
-                spdlog::info("[LOAD] Merged {} imported notes with save data", importedCount);
-            }
-        });
+    {
+        Phase phase("Log setup");
+        SetupLog();
+    }
+    Perf::LogSummariesOnExit();
+    Trace::FlushOnExit();
 
-        serialization->SetRevertCallback([](SKSE::SerializationInterface* intfc) {
-            NoteManager::GetSingleton()->Revert(intfc);
-        });
+    // Load settings from INI (off-thread; awaited at kDataLoaded)
+    {
+        Phase phase("Settings load dispatch");
+        SettingsManager::GetSingleton()->LoadSettingsAsync();
+    }
 
-        spdlog::info("Serialization registered");
-    } else {
-        spdlog::error("Failed to get serialization interface!");
+    // Register serialization callbacks
+    {
+        Phase phase("Serialization registration");
+        auto serialization = SKSE::GetSerializationInterface();
+        if (serialization) {
+            serialization->SetUniqueID(NoteManager::kDataKey);
+
+            serialization->SetSaveCallback([](SKSE::SerializationInterface* intfc) {
+                Trace::Scope trace("SaveCallback", "serialization");
+                if (!intfc->OpenRecord(NoteManager::kDataKey, NoteManager::kSerializationVersion)) {
+                    spdlog::error("[SAVE] Failed to open save record");
+                    return;
+                }
+                NoteManager::GetSingleton()->Save(intfc);
+                BackupManager::AutoBackup::OnGameSaved();
+                MemStats::LogUsage("save");
+            });
+
+            serialization->SetLoadCallback([](SKSE::SerializationInterface* intfc) {
+                Trace::Scope trace("LoadCallback", "serialization");
+                NoteManager::GetSingleton()->Load(intfc);
+                // The import file is merged after the load completes (BackupManager::DeferredImport)
+            });
+
+            serialization->SetRevertCallback([](SKSE::SerializationInterface* intfc) {
+                Trace::Scope trace("RevertCallback", "serialization");
+                NoteManager::GetSingleton()->Revert(intfc);
+                DialogTracker::GetSingleton()->Reset();
+            });
+
+            spdlog::info("Serialization registered");
+        } else {
+            spdlog::error("Failed to get serialization interface!");
+        }
     }
 
     // Register message handler
-    if (auto messaging = SKSE::GetMessagingInterface()) {
-        messaging->RegisterListener(MessageHandler);
-        spdlog::info("Messaging registered");
-    } else {
-        spdlog::error("Failed to get messaging interface!");
+    {
+        Phase phase("Messaging registration");
+        if (auto messaging = SKSE::GetMessagingInterface()) {
+            messaging->RegisterListener(MessageHandler);
+
+            // Listen to all plugins for plugin API interface requests
+            messaging->RegisterListener(nullptr, PluginAPI::HandleMessage);
+            spdlog::info("Messaging registered");
+        } else {
+            spdlog::error("Failed to get messaging interface!");
+        }
     }
 
-    // Initialize NoteManager
-    auto mgr = NoteManager::GetSingleton();
-    spdlog::info("NoteManager initialized | Count: {}", mgr->GetNoteCount());
+    // Hooks: input dispatch (single-pass input handling) and per-frame update (FrameScheduler)
+    // Two 5-byte call hooks, 14 bytes of trampoline each
+    {
+        Phase phase("Hooks");
+        SKSE::AllocTrampoline(64);
+        InputDispatchHook::Install();
+        FrameUpdateHook::Install();
+    }
 
+    // NoteManager, QuestNameCache and change subscribers are created on first use
+    // or at kDataLoaded; nothing else is needed before the main menu.
     spdlog::info("Plugin initialized");
+    StartupTimeline::GetSingleton()->Flush("Plugin init");
 }
 
 SKSEPluginLoad(const SKSE::LoadInterface* skse) {
@@ -0,0 +1,96 @@
+#include "Check.h"
+#include "BackupJSON.h"
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace BackupJSON;
+
+namespace {
+    // Same layout as BackupManager::AppendNoteJSON
+    std::string NoteObject(unsigned questID, const std::string& questName, const std::string& text,
+                           long long created, long long modified) {
+        std::ostringstream json;
+        json << "    {\n";
+        json << "      \"questID\": " << questID << ",\n";
+        json << "      \"questName\": \"" << EscapeJSON(questName) << "\",\n";
+        json << "      \"text\": \"" << EscapeJSON(text) << "\",\n";
+        json << "      \"created\": " << created << ",\n";
+        json << "      \"modified\": " << modified << "\n";
+        json << "    }";
+        return json.str();
+    }
+
+    struct Parsed {
+        std::string text;
+        std::string modified;
+    };
+
+    // The note loop of BackupManager::ParseBackupJSON
+    std::vector<Parsed> ParseNotes(const std::string& json) {
+        std::vector<Parsed> notes;
+        size_t pos = json.find('[', json.find("\"notes\":")) + 1;
+        while (pos < json.size()) {
+            size_t objStart = json.find('{', pos);
+            if (objStart == std::string::npos) {
+                break;
+            }
+            size_t objEnd = FindObjectEnd(json, objStart);
+            if (objEnd == std::string::npos) {
+                break;
+            }
+            std::string noteObj = json.substr(objStart, objEnd - objStart + 1);
+            notes.push_back({ UnescapeJSON(ExtractJSONValue(noteObj, "text")), ExtractJSONValue(noteObj, "modified") });
+            pos = objEnd + 1;
+        }
+        return notes;
+    }
+
+    void TestBracesInText() {
+        const std::vector<std::string> texts = {
+            "plain",
+            "closing } brace",
+            "{ nested } and } more {",
+            "quote then brace \"}",
+            "ends in backslash \\",
+            "backslash before brace \\}",
+        };
+        std::string json = "{\n  \"noteCount\": 6,\n  \"notes\": [\n";
+        for (size_t i = 0; i < texts.size(); ++i) {
+            if (i > 0) json += ",\n";
+            json += NoteObject(0x100 + static_cast<unsigned>(i), "Quest {" + std::to_string(i) + "}", texts[i], 10, 1000 + static_cast<long long>(i));
+        }
+        json += "\n  ]\n}\n";
+
+        std::vector<Parsed> notes = ParseNotes(json);
+        CHECK_EQ(notes.size(), texts.size());
+        for (size_t i = 0; i < notes.size() && i < texts.size(); ++i) {
+            CHECK_EQ(notes[i].text, texts[i]);
+            CHECK_EQ(notes[i].modified, std::to_string(1000 + i));  // Fields after "text" are still seen
+        }
+    }
+
+    void TestFindObjectEnd() {
+        std::string json = R"({"a": "}", "b": {"c": "\"}"}} tail)";
+        CHECK_EQ(FindObjectEnd(json, 0), json.find(" tail") - 1);
+        CHECK_EQ(FindObjectEnd(json, json.find("{\"c\"")), json.find(" tail") - 2);
+        CHECK_EQ(FindObjectEnd(R"({"a": "unclosed })", 0), std::string_view::npos);
+        CHECK_EQ(FindObjectEnd("{ \"a\": 1", 0), std::string_view::npos);
+    }
+
+    void TestEscapeRoundTrip() {
+        std::string text = "line\nnext\ttab \"quoted\" back\\slash";
+        CHECK_EQ(UnescapeJSON(EscapeJSON(text)), text);
+        CHECK_EQ(ExtractJSONValue(R"({"n": -12, "s": "a\"b"})", "n"), std::string("-12"));
+        CHECK_EQ(ExtractJSONValue(R"({"n": -12, "s": "a\"b"})", "s"), std::string("a\\\"b"));
+        CHECK_EQ(ExtractJSONValue(R"({"n": 1})", "missing"), std::string());
+    }
+}
+
+int main() {
+    TestBracesInText();
+    TestFindObjectEnd();
+    TestEscapeRoundTrip();
+    return TestResult();
+}
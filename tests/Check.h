@@ -0,0 +1,43 @@
+#pragma once
+
+/**
+ * PersonalNotes - Minimal test harness
+ *
+ * CHECK/CHECK_EQ log the failing expression and keep going, so one run reports
+ * every broken case. main() returns TestResult() as the CTest exit code.
+ */
+
+#include <iostream>
+
+inline int& TestFailures() {
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(expr)                                                                    \
+    do {                                                                               \
+        if (!(expr)) {                                                                 \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #expr ") failed\n"; \
+            ++TestFailures();                                                          \
+        }                                                                              \
+    } while (0)
+
+#define CHECK_EQ(actual, expected)                                                          \
+    do {                                                                                    \
+        const auto& checkActual = (actual);                                                 \
+        const auto& checkExpected = (expected);                                             \
+        if (!(checkActual == checkExpected)) {                                              \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK_EQ(" #actual ", " #expected \
+                      << ") failed: got " << checkActual << ", expected " << checkExpected  \
+                      << "\n";                                                              \
+            ++TestFailures();                                                               \
+        }                                                                                   \
+    } while (0)
+
+inline int TestResult() {
+    if (TestFailures() > 0) {
+        std::cerr << TestFailures() << " check(s) failed\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,140 @@
+#include "Check.h"
+#include "DurableFile.h"
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace {
+    fs::path TestDir() {
+        static const fs::path dir = [] {
+            fs::path path = fs::temp_directory_path() / "PersonalNotesTests_DurableFile";
+            fs::remove_all(path);
+            fs::create_directories(path);
+            return path;
+        }();
+        return dir;
+    }
+
+    std::string ReadAll(const fs::path& path) {
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+    void WriteAll(const fs::path& path, const std::string& contents) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << contents;
+    }
+
+    std::string Pattern(size_t size) {
+        std::string text(size, '\0');
+        for (size_t i = 0; i < size; ++i) {
+            text[i] = static_cast<char>('a' + i % 26);
+        }
+        return text;
+    }
+
+    void TestInterruptedWriteKeepsTarget() {
+        fs::path target = TestDir() / "interrupted.json";
+        fs::path temp = target.string() + ".tmp";
+        WriteAll(target, "old");
+        {
+            DurableFile file;
+            CHECK(file.Open(target.string()));
+            CHECK(file.Write(Pattern(DurableFile::kBufferSize * 3)));  // Reaches the temp file on disk
+            CHECK(fs::exists(temp));
+            CHECK_EQ(ReadAll(target), std::string("old"));
+        }  // Destroyed without Commit()
+        CHECK_EQ(ReadAll(target), std::string("old"));
+        CHECK(!fs::exists(temp));
+    }
+
+    void TestMultiBlockCommit() {
+        fs::path target = TestDir() / "multiblock.json";
+        WriteAll(target, "old");
+
+        // Small writes that straddle block boundaries, one write larger than a block, then more small ones
+        std::string expected;
+        DurableFile file;
+        CHECK(file.Open(target.string()));
+        for (int i = 0; i < 5000; ++i) {
+            std::string chunk = "note " + std::to_string(i) + "\n";
+            CHECK(file.Write(chunk));
+            expected += chunk;
+        }
+        std::string big = Pattern(DurableFile::kBufferSize * 2 + 17);
+        CHECK(file.Write(big));
+        expected += big;
+        for (int i = 0; i < 40000; ++i) {
+            CHECK(file.Write("yz"));
+            expected += "yz";
+        }
+        CHECK_EQ(ReadAll(target), std::string("old"));
+
+        CHECK(file.Commit());
+        CHECK(file.LastError().empty());
+        CHECK(!file.IsOpen());
+        CHECK(ReadAll(target) == expected);
+        CHECK_EQ(fs::file_size(target), expected.size());
+        CHECK(!fs::exists(target.string() + ".tmp"));
+    }
+
+    void TestFailedOpen() {
+        fs::path target = TestDir() / "missing-dir" / "a.json";
+        DurableFile file;
+        CHECK(!file.Open(target.string()));
+        CHECK(!file.IsOpen());
+        CHECK(!file.LastError().empty());
+        CHECK(!file.Write("ignored"));
+        CHECK(!file.Commit());
+        CHECK(!fs::exists(target));
+    }
+
+    void TestAbortRemovesTemp() {
+        fs::path target = TestDir() / "abort.json";
+        fs::path temp = target.string() + ".tmp";
+        DurableFile file;
+        CHECK(file.Open(target.string()));
+        CHECK(fs::exists(temp));
+        CHECK(file.Write("discarded"));
+        file.Abort();
+        CHECK(!file.IsOpen());
+        CHECK(!fs::exists(temp));
+        CHECK(!fs::exists(target));
+        file.Abort();  // Repeated aborts are harmless
+
+        // The writer can be reused after an abort
+        CHECK(file.Open(target.string()));
+        CHECK(file.Write("kept"));
+        CHECK(file.Commit());
+        CHECK_EQ(ReadAll(target), std::string("kept"));
+    }
+
+    void TestFailedRenameKeepsTarget() {
+        // A directory in the way makes the final rename fail
+        fs::path target = TestDir() / "occupied";
+        fs::create_directories(target / "child");
+        DurableFile file;
+        CHECK(file.Open(target.string()));
+        CHECK(file.Write("data"));
+        CHECK(!file.Commit());
+        CHECK(!file.LastError().empty());
+        CHECK(fs::is_directory(target / "child"));
+        CHECK(!fs::exists(target.string() + ".tmp"));
+    }
+}
+
+int main() {
+    TestInterruptedWriteKeepsTarget();
+    TestMultiBlockCommit();
+    TestFailedOpen();
+    TestAbortRemovesTemp();
+    TestFailedRenameKeepsTarget();
+    fs::remove_all(TestDir());
+    return TestResult();
+}
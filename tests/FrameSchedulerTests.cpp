@@ -0,0 +1,266 @@
+#include "Check.h"
+#include "FrameScheduler.h"
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+namespace {
+    // Simulated frame clock: only moves when a task "works" or a frame passes
+    FrameScheduler::Clock::time_point simulatedNow{};
+
+    FrameScheduler::Clock::time_point SimulatedClock() {
+        return simulatedNow;
+    }
+
+    void Advance(std::chrono::microseconds amount) {
+        simulatedNow += amount;
+    }
+
+    struct ReportLog {
+        FrameScheduler::Report report;
+        std::string task;
+        FrameScheduler::TaskStats stats;
+        std::string error;
+    };
+    std::vector<ReportLog> reports;
+
+    void RecordReport(FrameScheduler::Report report, const IncrementalTask& task,
+                      const FrameScheduler::TaskStats& stats, std::string_view error) {
+        reports.push_back({ report, task.GetName(), stats, std::string(error) });
+    }
+
+    void Reset(FrameScheduler& scheduler) {
+        simulatedNow = {};
+        reports.clear();
+        scheduler.SetClock(SimulatedClock);
+        scheduler.SetReporter(RecordReport);
+    }
+
+    /**
+     * Processes `items` items of `cost` each, checking the deadline between items.
+     */
+    class CountingTask : public IncrementalTask {
+    public:
+        CountingTask(const char* name, int items, std::chrono::microseconds cost, std::chrono::microseconds budget,
+                     std::vector<int>* perFrame = nullptr)
+            : name_(name), remaining_(items), cost_(cost), budget_(budget), perFrame_(perFrame) {}
+
+        const char* GetName() const override { return name_; }
+        std::chrono::microseconds GetBudget() const override { return budget_; }
+
+        bool Step(const FrameDeadline& deadline) override {
+            int done = 0;
+            while (remaining_ > 0 && !deadline.Expired()) {
+                Advance(cost_);
+                --remaining_;
+                ++done;
+            }
+            if (perFrame_) {
+                perFrame_->push_back(done);
+            }
+            return remaining_ == 0;
+        }
+
+    private:
+        const char* name_;
+        int remaining_;
+        std::chrono::microseconds cost_;
+        std::chrono::microseconds budget_;
+        std::vector<int>* perFrame_;
+    };
+
+    /**
+     * Takes a fixed amount of time per step regardless of the deadline.
+     */
+    class SlowTask : public IncrementalTask {
+    public:
+        explicit SlowTask(std::vector<std::chrono::microseconds> steps)
+            : steps_(std::move(steps)) {}
+
+        const char* GetName() const override { return "slow"; }
+        std::chrono::microseconds GetBudget() const override { return 1000us; }
+
+        bool Step(const FrameDeadline&) override {
+            Advance(steps_[next_++]);
+            return next_ == steps_.size();
+        }
+
+    private:
+        std::vector<std::chrono::microseconds> steps_;
+        size_t next_ = 0;
+    };
+
+    class ThrowingTask : public IncrementalTask {
+    public:
+        const char* GetName() const override { return "throwing"; }
+        std::chrono::microseconds GetBudget() const override { return 1000us; }
+
+        bool Step(const FrameDeadline&) override {
+            if (++steps_ == 2) {
+                throw std::runtime_error("bad item");
+            }
+            return false;
+        }
+
+    private:
+        int steps_ = 0;
+    };
+
+    void TestBudgetSlicing() {
+        FrameScheduler scheduler;
+        Reset(scheduler);
+
+        // 1000us budget, 100us per item: 10 items per frame, 25 items = 3 frames
+        std::vector<int> perFrame;
+        scheduler.Add(std::make_unique<CountingTask>("count", 25, 100us, 1000us, &perFrame));
+        CHECK_EQ(scheduler.ActiveCount(), size_t{ 0 });  // Starts on the next Tick()
+
+        int frames = 0;
+        do {
+            scheduler.Tick();
+            Advance(16000us);  // Rest of the frame
+            ++frames;
+        } while (scheduler.ActiveCount() > 0 && frames < 100);
+
+        CHECK_EQ(frames, 3);
+        CHECK(perFrame == std::vector<int>({ 10, 10, 5 }));
+        CHECK_EQ(reports.size(), size_t{ 1 });
+        if (!reports.empty()) {
+            CHECK(reports[0].report == FrameScheduler::Report::kFinished);
+            CHECK_EQ(reports[0].task, std::string("count"));
+            CHECK_EQ(reports[0].stats.frames, 3u);
+            CHECK_EQ(reports[0].stats.overruns, 0u);
+            CHECK(reports[0].stats.total == std::chrono::duration_cast<FrameScheduler::Clock::duration>(2500us));
+        }
+    }
+
+    void TestTasksHaveSeparateBudgets() {
+        FrameScheduler scheduler;
+        Reset(scheduler);
+
+        std::vector<int> fast;
+        std::vector<int> slow;
+        scheduler.Add(std::make_unique<CountingTask>("a", 8, 100us, 400us, &fast));
+        scheduler.Add(std::make_unique<CountingTask>("b", 8, 100us, 200us, &slow));
+        scheduler.Tick();
+        scheduler.Tick();
+        CHECK(fast == std::vector<int>({ 4, 4 }));
+        CHECK(slow == std::vector<int>({ 2, 2 }));
+        CHECK_EQ(scheduler.ActiveCount(), size_t{ 1 });
+        CHECK_EQ(reports.size(), size_t{ 1 });
+
+        scheduler.Tick();
+        scheduler.Tick();
+        CHECK_EQ(scheduler.ActiveCount(), size_t{ 0 });
+        CHECK_EQ(reports.size(), size_t{ 2 });
+    }
+
+    void TestOverruns() {
+        FrameScheduler scheduler;
+        Reset(scheduler);
+
+        // Within tolerance, over, further over, within budget
+        scheduler.Add(std::make_unique<SlowTask>(std::vector<std::chrono::microseconds>{ 1040us, 1300us, 1700us, 500us }));
+        for (int i = 0; i < 4; ++i) {
+            scheduler.Tick();
+        }
+
+        CHECK_EQ(reports.size(), size_t{ 2 });
+        if (reports.size() == 2) {
+            // Only the first overrun is reported as it happens
+            CHECK(reports[0].report == FrameScheduler::Report::kFirstOverrun);
+            CHECK_EQ(reports[0].stats.overruns, 1u);
+            CHECK(reports[0].stats.worstOverrun == std::chrono::duration_cast<FrameScheduler::Clock::duration>(300us));
+
+            CHECK(reports[1].report == FrameScheduler::Report::kFinished);
+            CHECK_EQ(reports[1].stats.frames, 4u);
+            CHECK_EQ(reports[1].stats.overruns, 2u);
+            CHECK(reports[1].stats.worstOverrun == std::chrono::duration_cast<FrameScheduler::Clock::duration>(700us));
+        }
+    }
+
+    void TestFailingTaskIsDropped() {
+        FrameScheduler scheduler;
+        Reset(scheduler);
+
+        std::vector<int> perFrame;
+        scheduler.Add(std::make_unique<ThrowingTask>());
+        scheduler.Add(std::make_unique<CountingTask>("other", 3, 100us, 100us, &perFrame));
+        scheduler.Tick();
+        scheduler.Tick();
+        CHECK_EQ(scheduler.ActiveCount(), size_t{ 1 });
+        CHECK_EQ(reports.size(), size_t{ 1 });
+        if (!reports.empty()) {
+            CHECK(reports[0].report == FrameScheduler::Report::kFailed);
+            CHECK_EQ(reports[0].error, std::string("bad item"));
+        }
+
+        // The other task keeps running
+        scheduler.Tick();
+        CHECK_EQ(scheduler.ActiveCount(), size_t{ 0 });
+        CHECK(perFrame == std::vector<int>({ 1, 1, 1 }));
+    }
+
+    void TestAddFromOtherThreads() {
+        FrameScheduler scheduler;
+        Reset(scheduler);
+
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&scheduler] {
+                for (int i = 0; i < 25; ++i) {
+                    scheduler.Add(std::make_unique<CountingTask>("bulk", 1, 0us, 100us));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        scheduler.Tick();
+        CHECK_EQ(scheduler.ActiveCount(), size_t{ 0 });
+        CHECK_EQ(reports.size(), size_t{ 100 });
+    }
+
+    void TestTaskAddedDuringTick() {
+        FrameScheduler scheduler;
+        Reset(scheduler);
+
+        // A task that queues a follow-up while the scheduler is iterating
+        class ChainTask : public IncrementalTask {
+        public:
+            explicit ChainTask(FrameScheduler& scheduler) : scheduler_(scheduler) {}
+            const char* GetName() const override { return "chain"; }
+            std::chrono::microseconds GetBudget() const override { return 100us; }
+            bool Step(const FrameDeadline&) override {
+                scheduler_.Add(std::make_unique<CountingTask>("follow-up", 1, 10us, 100us));
+                return true;
+            }
+
+        private:
+            FrameScheduler& scheduler_;
+        };
+
+        scheduler.Add(std::make_unique<ChainTask>(scheduler));
+        scheduler.Tick();
+        CHECK_EQ(reports.size(), size_t{ 1 });
+        scheduler.Tick();
+        CHECK_EQ(reports.size(), size_t{ 2 });
+        if (reports.size() == 2) {
+            CHECK_EQ(reports[1].task, std::string("follow-up"));
+        }
+    }
+}
+
+int main() {
+    TestBudgetSlicing();
+    TestTasksHaveSeparateBudgets();
+    TestOverruns();
+    TestFailingTaskIsDropped();
+    TestAddFromOtherThreads();
+    TestTaskAddedDuringTick();
+    return TestResult();
+}
@@ -0,0 +1,185 @@
+#include "Check.h"
+#include "NoteBackupFormat.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+namespace NBF = NoteBackupFormat;
+
+namespace {
+    fs::path TestDir() {
+        static const fs::path dir = [] {
+            fs::path path = fs::temp_directory_path() / "PersonalNotesTests_BackupFormat";
+            fs::remove_all(path);
+            fs::create_directories(path);
+            return path;
+        }();
+        return dir;
+    }
+
+    fs::path WriteFile(const std::string& name, const std::string& contents) {
+        fs::path path = TestDir() / name;
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << contents;
+        return path;
+    }
+
+    std::string SampleBackup() {
+        std::vector<NBF::NoteRecord> records = {
+            { 0x300, "third\nwith \"quotes\"", "Quest C", 30, 31 },
+            { 0x100, "first", "Quest A", 10, 11 },
+            { 0x200, "", "", 20, 21 },
+            { 0x0, "general \xE2\x82\xAC", "General Note", 1, 2 },
+        };
+        return NBF::Write("Dragonborn", "2026-01-01T00:00:00", records);
+    }
+
+    NBF::Header ReadHeader(const std::string& contents) {
+        NBF::Header header;
+        std::memcpy(&header, contents.data(), sizeof(header));
+        return header;
+    }
+
+    std::string WithHeader(std::string contents, const NBF::Header& header) {
+        std::memcpy(contents.data(), &header, sizeof(header));
+        return contents;
+    }
+
+    void TestRoundTrip() {
+        NBF::MappedBackup backup;
+        CHECK(backup.Open(WriteFile("sample.pnb", SampleBackup()).string()));
+        CHECK(backup.LastError().empty());
+        CHECK_EQ(backup.Size(), 4u);
+        CHECK(backup.PlayerName() == "Dragonborn");
+        CHECK(backup.ExportDate() == "2026-01-01T00:00:00");
+
+        // Index order is ascending questID regardless of input order
+        const std::uint32_t expectedIDs[] = { 0x0, 0x100, 0x200, 0x300 };
+        NBF::NoteRecord record;
+        for (std::uint32_t i = 0; i < 4; ++i) {
+            CHECK(backup.At(i, record));
+            CHECK_EQ(record.questID, expectedIDs[i]);
+        }
+        CHECK(!backup.At(4, record));
+
+        CHECK(backup.Find(0x300, record));
+        CHECK(record.text == "third\nwith \"quotes\"");
+        CHECK(record.questName == "Quest C");
+        CHECK_EQ(record.created, 30);
+        CHECK_EQ(record.modified, 31);
+        CHECK(backup.Find(0x200, record));
+        CHECK(record.text.empty());
+        CHECK(backup.Find(0x0, record));
+        CHECK(record.text == "general \xE2\x82\xAC");
+        CHECK(!backup.Find(0x150, record));
+        CHECK(!backup.Find(0x400, record));
+
+        backup.Close();
+        CHECK_EQ(backup.Size(), 0u);
+        CHECK(backup.PlayerName().empty());
+    }
+
+    void TestEmptyBackup() {
+        NBF::MappedBackup backup;
+        CHECK(backup.Open(WriteFile("empty.pnb", NBF::Write("Nobody", "", {})).string()));
+        CHECK_EQ(backup.Size(), 0u);
+        NBF::NoteRecord record;
+        CHECK(!backup.Find(0x100, record));
+    }
+
+    void CheckRejected(const std::string& name, const std::string& contents) {
+        NBF::MappedBackup backup;
+        bool opened = backup.Open(WriteFile(name, contents).string());
+        if (opened) {
+            std::cerr << name << ": corrupt file was accepted\n";
+        }
+        CHECK(!opened);
+        CHECK(!backup.LastError().empty());
+        CHECK_EQ(backup.Size(), 0u);
+    }
+
+    void TestCorruptHeaders() {
+        std::string good = SampleBackup();
+        NBF::Header header = ReadHeader(good);
+
+        CheckRejected("missing.pnb", std::string());
+        CheckRejected("short.pnb", good.substr(0, sizeof(NBF::Header) - 1));
+        CheckRejected("truncated.pnb", good.substr(0, good.size() / 2));
+
+        NBF::Header bad = header;
+        bad.magic[0] = 'X';
+        CheckRejected("magic.pnb", WithHeader(good, bad));
+
+        bad = header;
+        bad.version = NBF::kVersion + 1;
+        CheckRejected("version.pnb", WithHeader(good, bad));
+
+        // indexOffset + noteCount * sizeof(IndexEntry) would wrap around to a small value
+        bad = header;
+        bad.indexOffset = UINT64_MAX - sizeof(NBF::IndexEntry) + 1;
+        bad.noteCount = 1;
+        CheckRejected("wrap-offset.pnb", WithHeader(good, bad));
+
+        // More entries than fit between the index and the heap
+        bad = header;
+        bad.noteCount = header.noteCount + 1;
+        CheckRejected("count.pnb", WithHeader(good, bad));
+        bad.noteCount = UINT32_MAX;
+        CheckRejected("count-max.pnb", WithHeader(good, bad));
+
+        bad = header;
+        bad.heapOffset = header.indexOffset - 1;
+        CheckRejected("heap-before-index.pnb", WithHeader(good, bad));
+
+        bad = header;
+        bad.heapSize = UINT64_MAX;
+        CheckRejected("heap-size.pnb", WithHeader(good, bad));
+
+        bad = header;
+        bad.playerNameOffset = UINT32_MAX;
+        CheckRejected("player-name.pnb", WithHeader(good, bad));
+    }
+
+    void TestCorruptEntry() {
+        // The header is valid but one entry points past the heap; only that entry fails
+        std::string contents = SampleBackup();
+        NBF::Header header = ReadHeader(contents);
+        NBF::IndexEntry entry;
+        size_t entryOffset = header.indexOffset + sizeof(NBF::IndexEntry);
+        std::memcpy(&entry, contents.data() + entryOffset, sizeof(entry));
+        entry.textLength = UINT32_MAX;
+        std::memcpy(contents.data() + entryOffset, &entry, sizeof(entry));
+
+        NBF::MappedBackup backup;
+        CHECK(backup.Open(WriteFile("entry.pnb", contents).string()));
+        NBF::NoteRecord record;
+        CHECK(backup.At(0, record));
+        CHECK(!backup.At(1, record));
+        CHECK(!backup.Find(0x100, record));
+        CHECK(backup.Find(0x300, record));
+    }
+
+    void TestMissingFile() {
+        NBF::MappedBackup backup;
+        CHECK(!backup.Open((TestDir() / "does-not-exist.pnb").string()));
+        CHECK(!backup.LastError().empty());
+
+        // A failed open leaves the reader reusable
+        CHECK(backup.Open(WriteFile("reuse.pnb", SampleBackup()).string()));
+        CHECK_EQ(backup.Size(), 4u);
+    }
+}
+
+int main() {
+    TestRoundTrip();
+    TestEmptyBackup();
+    TestCorruptHeaders();
+    TestCorruptEntry();
+    TestMissingFile();
+    fs::remove_all(TestDir());
+    return TestResult();
+}
@@ -0,0 +1,222 @@
+#include "Check.h"
+#include "NoteEditorModel.h"
+
+#include <string>
+
+namespace {
+    void TypeText(NoteEditorModel& model, std::string_view text) {
+        for (char c : text) {
+            model.Insert(std::string_view(&c, 1));
+        }
+    }
+
+    void TestGapBuffer() {
+        GapBuffer buffer;
+        buffer.Insert(0, "world");
+        buffer.Insert(0, "hello ");
+        CHECK_EQ(buffer.ToString(), std::string("hello world"));
+
+        buffer.Insert(5, ",");  // Gap moves left
+        buffer.Insert(buffer.Size(), "!");  // Gap moves right
+        CHECK_EQ(buffer.ToString(), std::string("hello, world!"));
+        CHECK_EQ(buffer.At(5), ',');
+        CHECK_EQ(buffer.Substr(7, 5), std::string("world"));
+        CHECK_EQ(buffer.Substr(10, 100), std::string("ld!"));
+
+        buffer.Erase(5, 1);
+        buffer.Erase(0, 6);
+        CHECK_EQ(buffer.ToString(), std::string("world!"));
+        buffer.Erase(3, 100);  // Clamped to the end
+        CHECK_EQ(buffer.ToString(), std::string("wor"));
+
+        // Grow past the initial gap with text on both sides of it
+        std::string big(1000, 'x');
+        buffer.Insert(1, big);
+        CHECK_EQ(buffer.Size(), size_t{ 1003 });
+        CHECK_EQ(buffer.Substr(0, 2), std::string("wx"));
+        CHECK_EQ(buffer.Substr(1001, 2), std::string("or"));
+
+        buffer.Assign("reset");
+        CHECK_EQ(buffer.ToString(), std::string("reset"));
+    }
+
+    void TestUtf8Cursor() {
+        // a (1 byte), é (2), € (3), 😀 (4), b (1)
+        NoteEditorModel model;
+        model.SetText("a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80" "b");
+        CHECK_EQ(model.GetCursor(), size_t{ 11 });
+
+        const size_t expectedLeft[] = { 10, 6, 3, 1, 0, 0 };
+        for (size_t expected : expectedLeft) {
+            model.MoveLeft(false);
+            CHECK_EQ(model.GetCursor(), expected);
+        }
+        const size_t expectedRight[] = { 1, 3, 6, 10, 11, 11 };
+        for (size_t expected : expectedRight) {
+            model.MoveRight(false);
+            CHECK_EQ(model.GetCursor(), expected);
+        }
+
+        model.MoveLeft(false);
+        model.Backspace();  // Removes the whole 4-byte emoji
+        CHECK_EQ(model.GetText(), std::string("a\xC3\xA9\xE2\x82\xAC" "b"));
+        CHECK_EQ(model.GetCursor(), size_t{ 6 });
+
+        // Vertical movement keeps the byte column but lands on a code point boundary
+        model.SetText("ab\n\xE2\x82\xAC" "c");
+        model.MoveDocumentStart(false);
+        model.MoveRight(false);
+        model.MoveRight(false);
+        model.MoveDown(false);
+        CHECK_EQ(model.GetCursor(), size_t{ 3 });  // Column 2 is inside €, snapped back
+        model.MoveLineEnd(false);
+        model.MoveUp(false);
+        CHECK_EQ(model.GetCursor(), size_t{ 2 });  // Column 4 clamped to the shorter line
+
+        // Truncation to the maximum length never splits a code point
+        NoteEditorModel small(4);
+        small.SetText("ab\xE2\x82\xAC");
+        CHECK_EQ(small.GetText(), std::string("ab"));
+        CHECK(!small.Insert("\xE2\x82\xAC\xE2\x82\xAC"));
+        CHECK(small.Insert("cd"));
+        CHECK_EQ(small.GetText(), std::string("abcd"));
+    }
+
+    void TestSelection() {
+        NoteEditorModel model;
+        model.SetText("one two three");
+        model.MoveDocumentStart(false);
+        model.MoveRight(false, true);  // Word jump: past "one "
+        CHECK_EQ(model.GetCursor(), size_t{ 4 });
+
+        model.MoveRight(true, true);
+        CHECK(model.HasSelection());
+        CHECK_EQ(model.GetSelectedText(), std::string("two "));
+
+        model.Insert("2 ");
+        CHECK_EQ(model.GetText(), std::string("one 2 three"));
+        CHECK(!model.HasSelection());
+
+        // Selecting backwards, then collapsing to the near edge
+        model.MoveDocumentEnd(false);
+        model.MoveLeft(true);
+        model.MoveLeft(true);
+        CHECK_EQ(model.GetSelection().first, size_t{ 9 });
+        CHECK_EQ(model.GetSelection().second, size_t{ 11 });
+        model.MoveLeft(false);
+        CHECK_EQ(model.GetCursor(), size_t{ 9 });
+        CHECK(!model.HasSelection());
+
+        model.SelectAll();
+        CHECK_EQ(model.GetSelectedText(), model.GetText());
+        model.Delete();
+        CHECK_EQ(model.GetText(), std::string());
+    }
+
+    void TestUndoRedo() {
+        NoteEditorModel model;
+        TypeText(model, "abc");
+        model.Undo();  // Consecutive typing is one step
+        CHECK_EQ(model.GetText(), std::string());
+        CHECK(!model.CanUndo());
+        model.Redo();
+        CHECK_EQ(model.GetText(), std::string("abc"));
+        CHECK_EQ(model.GetCursor(), size_t{ 3 });
+
+        model.SetText("");
+        TypeText(model, "ab cd");
+        model.Undo();  // A space starts a new step
+        CHECK_EQ(model.GetText(), std::string("ab "));
+        model.Undo();
+        CHECK_EQ(model.GetText(), std::string("ab"));
+        model.Undo();
+        CHECK_EQ(model.GetText(), std::string());
+
+        // Moving the cursor breaks the run
+        model.SetText("");
+        TypeText(model, "ab");
+        model.MoveLeft(false);
+        model.MoveRight(false);
+        TypeText(model, "c");
+        model.Undo();
+        CHECK_EQ(model.GetText(), std::string("ab"));
+
+        // Consecutive backspaces coalesce and undo restores cursor and selection
+        model.SetText("hello");
+        model.Backspace();
+        model.Backspace();
+        model.Backspace();
+        CHECK_EQ(model.GetText(), std::string("he"));
+        model.Undo();
+        CHECK_EQ(model.GetText(), std::string("hello"));
+        CHECK_EQ(model.GetCursor(), size_t{ 5 });
+
+        // Forward deletes coalesce too
+        model.MoveDocumentStart(false);
+        model.Delete();
+        model.Delete();
+        CHECK_EQ(model.GetText(), std::string("llo"));
+        model.Undo();
+        CHECK_EQ(model.GetText(), std::string("hello"));
+
+        // A new edit clears the redo stack
+        model.Undo();
+        model.Redo();
+        CHECK(!model.CanRedo());
+        model.Undo();
+        CHECK(model.CanRedo());
+        model.Insert("x");
+        CHECK(!model.CanRedo());
+    }
+
+    void TestModified() {
+        NoteEditorModel model;
+        model.SetText("saved");
+        CHECK(!model.IsModified());
+
+        TypeText(model, "ab");
+        CHECK(model.IsModified());
+        model.MarkSaved();
+        CHECK(!model.IsModified());
+
+        // Typing right after a save must not merge into the saved undo step
+        TypeText(model, "c");
+        CHECK(model.IsModified());
+        model.Undo();
+        CHECK(!model.IsModified());
+        CHECK_EQ(model.GetText(), std::string("savedab"));
+        model.Redo();
+        CHECK(model.IsModified());
+
+        // Undo back to the save point, then past it
+        model.Undo();
+        model.Undo();
+        CHECK(model.IsModified());
+        CHECK_EQ(model.GetText(), std::string("saved"));
+        model.Redo();
+        CHECK(!model.IsModified());
+
+        // Editing after undoing past the save point makes it unreachable
+        model.Undo();
+        model.Insert("z");
+        CHECK(model.IsModified());
+        model.Undo();
+        CHECK(model.IsModified());
+
+        model.SetText("fresh");
+        CHECK(!model.IsModified());
+        model.Backspace();
+        model.MarkSaved();
+        model.Backspace();
+        CHECK(model.IsModified());
+    }
+}
+
+int main() {
+    TestGapBuffer();
+    TestUtf8Cursor();
+    TestSelection();
+    TestUndoRedo();
+    TestModified();
+    return TestResult();
+}